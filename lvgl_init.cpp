@@ -8,34 +8,180 @@
  * Ported from MKS_LVGL.cpp in grbl_esp32 firmware
  */
 
+#include <string.h>
 #include <lvgl.h>
 #include <TFT_eSPI.h>
 #include "tft_config.h"
 #include "tft_driver.h"
+#include "tft_profiler.h"
+#include "tft_latency.h"
+#include "tft_codec.h"
+#include "tft_beep.h"
 #include "lvgl_init.h"
 
 #if TFT_ENABLE
 
+#include "esp_timer.h"
+#include "esp_heap_caps.h"
+
+// Two buffers with DMA, LVGL renders into one while the other is sent
+#define LVGL_DRAW_BUFFERS (TFT_USE_DMA ? 2 : 1)
+
 // External TFT_eSPI instance (from tft_driver.c)
 extern TFT_eSPI tft;
 
-// LVGL display buffer
+// LVGL display buffers, allocated from DMA capable heap while the display is awake
 static lv_disp_buf_t disp_buf;
-static lv_color_t bmp_public_buf[TFT_LVGL_BUFFER_SIZE];
+static lv_color_t *draw_buf[LVGL_DRAW_BUFFERS];
+static uint32_t draw_buf_lines = 0;     // 0 while released
+static uint32_t buffer_setting = 0;     // Requested lines, 0 = size from free memory
+static bool buffer_auto = false;
+
+// Display sleep, the refresh task runs refr_sleep() instead of rendering
+static lv_task_cb_t refr_cb = NULL;
+static uint32_t skipped_frames = 0;
+
+// Flush tap chain head
+static lvgl_flush_tap_ptr flush_tap = NULL;
+
+// Touch filter chain head
+static lvgl_touch_filter_ptr touch_filter = NULL;
+
+// Set while lvgl_refresh_screen() runs
+static lvgl_refresh_stats_t *refresh_stats = NULL;
+
+#if TFT_USE_DMA
+// Display transfers use DMA, see lvgl_set_dma()
+static bool use_dma = true;
+#endif
+
+// Critical redraw state, see lvgl_hold_flush()
+static volatile bool flush_hold = false;
+static bool flush_critical = false;
+static bool flush_skipped = false;
+static lv_area_t skipped_area;
+
+#if TFT_LATENCY_ENABLE
+// Latency sample target, the object under the press point
+static lv_point_t press_point;
+static lv_area_t press_area;
+static bool press_resolved = false;
+#endif
 
 // Forward declarations for callbacks
 static void lvgl_display_flush(lv_disp_drv_t *disp, const lv_area_t *area, lv_color_t *color_p);
 static bool lvgl_touch_read(lv_indev_drv_t *indev, lv_indev_data_t *data);
 
+#if TFT_LATENCY_ENABLE
+
+// Clickable object under p, children first, the way LVGL picks the object a press goes to
+static lv_obj_t *obj_at(lv_obj_t *obj, const lv_point_t *p) {
+    lv_area_t coords;
+
+    lv_obj_get_coords(obj, &coords);
+    if(lv_obj_get_hidden(obj) || !lv_area_is_point_on(&coords, p))
+        return NULL;
+
+    for(lv_obj_t *child = lv_obj_get_child(obj, NULL); child; child = lv_obj_get_child(obj, child)) {
+        lv_obj_t *found = obj_at(child, p);
+        if(found)
+            return found;
+    }
+
+    return lv_obj_get_click(obj) ? obj : NULL;
+}
+
+// Does the flushed area show the pressed object? Resolved on the first flush after
+// the press, when LVGL has handled it, so a screen it opened is searched
+static bool latency_related(const lv_area_t *area) {
+    lv_area_t common;
+
+    if(!press_resolved) {
+        lv_obj_t *obj = obj_at(lv_layer_top(), &press_point);
+
+        if(obj == NULL)
+            obj = obj_at(lv_scr_act(), &press_point);
+
+        // Nothing to press: an empty area, no flush is related and the sample times out
+        if(obj)
+            lv_obj_get_coords(obj, &press_area);
+        else {
+            press_area.x1 = press_area.y1 = 1;
+            press_area.x2 = press_area.y2 = 0;
+        }
+        press_resolved = true;
+    }
+
+    return lv_area_intersect(&common, area, &press_area);
+}
+
+#endif
+
+/*
+ * Draw buffer allocation
+ */
+static void release_buffers(void) {
+    for(uint_fast8_t i = 0; i < LVGL_DRAW_BUFFERS; i++) {
+        heap_caps_free(draw_buf[i]);
+        draw_buf[i] = NULL;
+    }
+    draw_buf_lines = 0;
+}
+
+static uint32_t auto_lines(void) {
+    size_t line_bytes = TFT_DISPLAY_WIDTH * sizeof(lv_color_t) * LVGL_DRAW_BUFFERS;
+    uint32_t lines = heap_caps_get_largest_free_block(MALLOC_CAP_DMA) * TFT_LVGL_BUFFER_HEAP_PCT / 100 / line_bytes;
+
+    return lines > TFT_LVGL_BUFFER_MAX_LINES ? TFT_LVGL_BUFFER_MAX_LINES : lines;
+}
+
+static bool alloc_buffers(void) {
+    uint32_t lines;
+
+    buffer_auto = buffer_setting == 0;
+    lines = buffer_auto ? auto_lines() : buffer_setting;
+    if(lines > TFT_DISPLAY_HEIGHT)
+        lines = TFT_DISPLAY_HEIGHT;
+    if(lines < TFT_LVGL_BUFFER_MIN_LINES)
+        lines = TFT_LVGL_BUFFER_MIN_LINES;
+
+    // Fragmented heap, halve until it fits
+    while(true) {
+        uint_fast8_t i;
+        size_t size = lines * TFT_DISPLAY_WIDTH * sizeof(lv_color_t);
+
+        for(i = 0; i < LVGL_DRAW_BUFFERS; i++) {
+            if((draw_buf[i] = (lv_color_t *)heap_caps_malloc(size, MALLOC_CAP_DMA)) == NULL)
+                break;
+        }
+
+        if(i == LVGL_DRAW_BUFFERS)
+            break;
+
+        release_buffers();
+        if(lines == TFT_LVGL_BUFFER_MIN_LINES)
+            return false;
+        lines = lines / 2 < TFT_LVGL_BUFFER_MIN_LINES ? TFT_LVGL_BUFFER_MIN_LINES : lines / 2;
+    }
+
+    draw_buf_lines = lines;
+    lv_disp_buf_init(&disp_buf, draw_buf[0], LVGL_DRAW_BUFFERS > 1 ? draw_buf[LVGL_DRAW_BUFFERS - 1] : NULL,
+                      lines * TFT_DISPLAY_WIDTH);
+
+    return true;
+}
+
 /*
  * Initialize LVGL
  */
-void lvgl_init(void) {
+bool lvgl_init(uint32_t buffer_lines) {
     // Initialize LVGL library
     lv_init();
 
-    // Initialize display buffer (single buffer mode)
-    lv_disp_buf_init(&disp_buf, bmp_public_buf, NULL, TFT_LVGL_BUFFER_SIZE);
+    // Initialize display buffers
+    buffer_setting = buffer_lines;
+    if(!alloc_buffers())
+        return false;
 
     // Register display driver
     lv_disp_drv_t disp_drv;
@@ -52,6 +198,8 @@ void lvgl_init(void) {
     indev_drv.type = LV_INDEV_TYPE_POINTER;
     indev_drv.read_cb = lvgl_touch_read;
     lv_indev_drv_register(&indev_drv);
+
+    return true;
 }
 
 /*
@@ -59,6 +207,27 @@ void lvgl_init(void) {
  * Called by LVGL to update display with dirty region
  */
 static void lvgl_display_flush(lv_disp_drv_t *disp, const lv_area_t *area, lv_color_t *color_p) {
+    // A critical redraw is waiting, drop this area and redraw it afterwards
+    if(flush_hold && !flush_critical) {
+        if(flush_skipped)
+            lv_area_join(&skipped_area, &skipped_area, area);
+        else
+            lv_area_copy(&skipped_area, area);
+        flush_skipped = true;
+        lv_disp_flush_ready(disp);
+        return;
+    }
+
+    TFT_PROF_BEGIN(TFT_PROF_FLUSH);
+
+    uint32_t t0 = refresh_stats ? (uint32_t)esp_timer_get_time() : 0;
+
+#if TFT_LATENCY_ENABLE
+    bool related = tft_latency_pending() && latency_related(area);
+
+    tft_latency_flush_start((uint32_t)esp_timer_get_time(), related);
+#endif
+
     // Calculate update region dimensions
     uint32_t w = (area->x2 - area->x1 + 1);
     uint32_t h = (area->y2 - area->y1 + 1);
@@ -68,50 +237,114 @@ static void lvgl_display_flush(lv_disp_drv_t *disp, const lv_area_t *area, lv_co
     tft.setAddrWindow(area->x1, area->y1, w, h);
 
 #if TFT_USE_DMA
-    // Push pixels using DMA (non-blocking)
-    tft.pushColorsDMA(&color_p->full, w * h, true);
+    // Push pixels using DMA (non-blocking) unless switched off at runtime
+    if(use_dma)
+        tft.pushColorsDMA(&color_p->full, w * h, true);
+    else
+        tft.pushColors(&color_p->full, w * h, true);
 #else
     // Push pixels using blocking SPI
     tft.pushColors(&color_p->full, w * h, true);
 #endif
 
+#if TFT_LATENCY_ENABLE
+    if(related) {
+  #if TFT_USE_DMA
+        // Photon time is when the transfer has finished, not when it was queued
+        if(use_dma)
+            tft.dmaWait();
+  #endif
+        tft_latency_flush_done((uint32_t)esp_timer_get_time());
+    }
+#endif
+
     tft.endWrite();
 
+    TFT_PROF_END(TFT_PROF_FLUSH);
+
+    if(flush_tap)
+        flush_tap(area, color_p);
+
+    if(refresh_stats) {
+        refresh_stats->pixels += w * h;
+        refresh_stats->crc = tft_crc32(refresh_stats->crc, area, sizeof(lv_area_t));
+        refresh_stats->crc = tft_crc32(refresh_stats->crc, color_p, w * h * sizeof(lv_color_t));
+        refresh_stats->flush_us += (uint32_t)esp_timer_get_time() - t0;
+    }
+
     // Signal LVGL that flush is complete
     lv_disp_flush_ready(disp);
 }
 
+/*
+ * Read the XPT2046 and map it to display coordinates
+ */
+static bool read_panel_touch(uint16_t *x, uint16_t *y) {
+    uint16_t touchX = 0, touchY = 0;
+
+    // Read touch from TFT_eSPI (handles XPT2046 protocol)
+    if(!tft.getTouch(&touchY, &touchX))
+        return false;
+
+    // Boundary clamping
+    if(touchX > TFT_DISPLAY_WIDTH) {
+        touchX = TFT_DISPLAY_WIDTH;
+    }
+    if(touchY > TFT_DISPLAY_HEIGHT) {
+        touchY = TFT_DISPLAY_HEIGHT;
+    }
+
+#if TFT_TOUCH_MIRROR_X
+    // Mirror X-axis (required for MKS TS35)
+    touchX = TFT_DISPLAY_WIDTH - touchX;
+#endif
+
+#if TFT_TOUCH_MIRROR_Y
+    // Mirror Y-axis (required for MKS TS35)
+    touchY = TFT_DISPLAY_HEIGHT - touchY;
+#endif
+
+    *x = touchX;
+    *y = touchY;
+
+    return true;
+}
+
 /*
  * LVGL touch input callback
  * Called by LVGL to read touch state
  */
 static bool lvgl_touch_read(lv_indev_drv_t *indev, lv_indev_data_t *data) {
+    TFT_PROF_BEGIN(TFT_PROF_TOUCH);
+
     uint16_t touchX = 0, touchY = 0;
     static uint16_t last_x = 0;
     static uint16_t last_y = 0;
+    static bool last_touched = false;
+    bool touched = read_panel_touch(&touchX, &touchY);
 
-    // Read touch from TFT_eSPI (handles XPT2046 protocol)
-    boolean touched = tft.getTouch(&touchY, &touchX);
+    // Scripted and remote input are merged here
+    if(touch_filter)
+        touched = touch_filter(touched, &touchX, &touchY);
 
-    if(touched) {
-        // Boundary clamping
-        if(touchX > TFT_DISPLAY_WIDTH) {
-            touchX = TFT_DISPLAY_WIDTH;
-        }
-        if(touchY > TFT_DISPLAY_HEIGHT) {
-            touchY = TFT_DISPLAY_HEIGHT;
-        }
-
-#if TFT_TOUCH_MIRROR_X
-        // Mirror X-axis (required for MKS TS35)
-        touchX = TFT_DISPLAY_WIDTH - touchX;
+#if TFT_LATENCY_ENABLE
+    // Start a latency sample on the press edge only
+    if(touched && !last_touched) {
+        press_point.x = touchX;
+        press_point.y = touchY;
+        press_resolved = false;
+        tft_latency_press((uint32_t)esp_timer_get_time());
+    }
 #endif
 
-#if TFT_TOUCH_MIRROR_Y
-        // Mirror Y-axis (required for MKS TS35)
-        touchY = TFT_DISPLAY_HEIGHT - touchY;
+#if TFT_BEEP_ENABLE
+    // Fixed length click on the press edge, played by the beep timer
+    if(touched && !last_touched)
+        tft_beep_play(TFT_BEEP_CLICK);
 #endif
+    last_touched = touched;
 
+    if(touched) {
         // Update last known position
         last_x = touchX;
         last_y = touchY;
@@ -120,24 +353,16 @@ static bool lvgl_touch_read(lv_indev_drv_t *indev, lv_indev_data_t *data) {
         data->point.x = last_x;
         data->point.y = last_y;
         data->state = LV_INDEV_STATE_PR;  // Pressed
-
-#if TFT_BEEP_ENABLE
-        // Haptic feedback via beeper
-        tft_beeper_on();
-#endif
     }
     else {
         // Touch released
         data->point.x = last_x;
         data->point.y = last_y;
         data->state = LV_INDEV_STATE_REL;  // Released
-
-#if TFT_BEEP_ENABLE
-        // Turn off beeper
-        tft_beeper_off();
-#endif
     }
 
+    TFT_PROF_END(TFT_PROF_TOUCH);
+
     // Return false to indicate no more data to read
     return false;
 }
@@ -146,7 +371,202 @@ static bool lvgl_touch_read(lv_indev_drv_t *indev, lv_indev_data_t *data) {
  * LVGL task handler
  */
 void lvgl_task_handler(void) {
+    TFT_PROF_FRAME_BEGIN();
     lv_task_handler();
+    TFT_PROF_FRAME_END();
+
+#if TFT_LATENCY_ENABLE
+    tft_latency_frame_end((uint32_t)esp_timer_get_time());
+#endif
+}
+
+void lvgl_set_task_periods(uint32_t refr_ms, uint32_t indev_ms) {
+    lv_disp_t *disp = lv_disp_get_default();
+
+    if(disp && disp->refr_task)
+        lv_task_set_period(disp->refr_task, refr_ms);
+
+    for(lv_indev_t *indev = lv_indev_get_next(NULL); indev; indev = lv_indev_get_next(indev)) {
+        if(indev->driver.read_task)
+            lv_task_set_period(indev->driver.read_task, indev_ms);
+    }
+}
+
+void lvgl_set_dma(bool on) {
+#if TFT_USE_DMA
+    // Let a transfer in flight finish before blocking writes use the bus
+    if(use_dma && !on)
+        tft.dmaWait();
+
+    use_dma = on;
+#endif
+}
+
+void lvgl_hold_flush(void) {
+    flush_hold = true;
+}
+
+void lvgl_refresh_critical(const lv_area_t *area) {
+    lv_disp_t *disp = lv_disp_get_default();
+    lv_area_t pending[LV_INV_BUF_SIZE];
+    uint16_t n_pending = 0;
+
+    if(!lvgl_display_wake()) {
+        lvgl_release_flush();
+        return;
+    }
+
+    // Set invalidated areas aside so only the critical area is rendered
+    for(uint16_t i = 0; i < disp->inv_p; i++) {
+        if(!disp->inv_area_joined[i])
+            lv_area_copy(&pending[n_pending++], &disp->inv_areas[i]);
+    }
+    disp->inv_p = 0;
+
+    lv_inv_area(disp, area);
+
+    flush_critical = true;
+    lv_refr_now(disp);
+    flush_critical = false;
+
+#if TFT_USE_DMA
+    // On glass only when the transfer has finished
+    if(use_dma)
+        tft.dmaWait();
+#endif
+
+    for(uint16_t i = 0; i < n_pending; i++)
+        lv_inv_area(disp, &pending[i]);
+
+    lvgl_release_flush();
+}
+
+void lvgl_release_flush(void) {
+    flush_hold = false;
+
+    if(flush_skipped) {
+        flush_skipped = false;
+        lv_inv_area(lv_disp_get_default(), &skipped_area);
+    }
+}
+
+/*
+ * Display sleep, draw buffers are returned to the heap
+ */
+static void refr_sleep(lv_task_t *task) {
+    lv_disp_t *disp = (lv_disp_t *)task->user_data;
+
+    // A frame would have been drawn, drop it, the wake redraws everything
+    if(disp->inv_p) {
+        skipped_frames++;
+        lv_inv_area(disp, NULL);
+    }
+}
+
+void lvgl_display_sleep(void) {
+    lv_disp_t *disp = lv_disp_get_default();
+
+    if(draw_buf_lines == 0)
+        return;
+
+#if TFT_USE_DMA
+    // Buffer may still be read by the last transfer
+    tft.dmaWait();
+#endif
+
+    refr_cb = disp->refr_task->task_cb;
+    lv_task_set_cb(disp->refr_task, refr_sleep);
+    release_buffers();
+}
+
+bool lvgl_display_wake(void) {
+    lv_disp_t *disp = lv_disp_get_default();
+
+    if(draw_buf_lines)
+        return true;
+
+    if(!alloc_buffers())
+        return false;
+
+    lv_task_set_cb(disp->refr_task, refr_cb);
+    lv_inv_area(disp, NULL);
+    lv_obj_invalidate(lv_scr_act());
+
+    return true;
+}
+
+bool lvgl_display_asleep(void) {
+    return draw_buf_lines == 0;
+}
+
+uint32_t lvgl_skipped_frames(void) {
+    return skipped_frames;
+}
+
+bool lvgl_set_buffer_lines(uint32_t lines) {
+    uint32_t prev = buffer_setting;
+
+    if(lines == buffer_setting)
+        return true;
+
+    buffer_setting = lines;
+
+    if(draw_buf_lines == 0)
+        return true;
+
+    lvgl_display_sleep();
+    if(lvgl_display_wake())
+        return true;
+
+    // Keep the display running with the previous size
+    buffer_setting = prev;
+    lvgl_display_wake();
+
+    return false;
+}
+
+void lvgl_get_buffer_info(lvgl_buffer_info_t *info) {
+    info->lines = draw_buf_lines;
+    info->count = LVGL_DRAW_BUFFERS;
+    info->bytes = draw_buf_lines * TFT_DISPLAY_WIDTH * sizeof(lv_color_t) * LVGL_DRAW_BUFFERS;
+    info->auto_size = buffer_auto;
+}
+
+lvgl_flush_tap_ptr lvgl_set_flush_tap(lvgl_flush_tap_ptr tap) {
+    lvgl_flush_tap_ptr prev = flush_tap;
+
+    flush_tap = tap;
+
+    return prev;
+}
+
+lvgl_touch_filter_ptr lvgl_set_touch_filter(lvgl_touch_filter_ptr filter) {
+    lvgl_touch_filter_ptr prev = touch_filter;
+
+    touch_filter = filter;
+
+    return prev;
+}
+
+/*
+ * Full redraw of the active screen
+ */
+void lvgl_refresh_screen(lvgl_refresh_stats_t *stats) {
+    memset(stats, 0, sizeof(lvgl_refresh_stats_t));
+
+    if(!lvgl_display_wake())
+        return;
+
+    lv_obj_invalidate(lv_scr_act());
+
+    uint32_t t0 = (uint32_t)esp_timer_get_time();
+
+    refresh_stats = stats;
+    lv_refr_now(NULL);
+    refresh_stats = NULL;
+
+    // Render time excludes the SPI transfers measured in the flush callback
+    stats->render_us = (uint32_t)esp_timer_get_time() - t0 - stats->flush_us;
 }
 
 #endif // TFT_ENABLE
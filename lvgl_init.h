@@ -14,6 +14,7 @@
 
 #include <stdint.h>
 #include <stdbool.h>
+#include <lvgl.h>
 
 #ifdef __cplusplus
 extern "C" {
@@ -22,12 +23,14 @@ extern "C" {
 /*
  * Initialize LVGL graphics library
  * - Calls lv_init()
- * - Allocates display buffer
+ * - Allocates the draw buffers from DMA capable heap, buffer_lines display
+ *   lines each or sized from free memory when 0 (two buffers with DMA)
  * - Registers display driver with flush callback
  * - Registers touch input driver with read callback
  * - Must be called after tft_driver_init()
+ * Returns false if not even TFT_LVGL_BUFFER_MIN_LINES could be allocated.
  */
-void lvgl_init(void);
+bool lvgl_init(uint32_t buffer_lines);
 
 /*
  * LVGL task handler - must be called periodically
@@ -35,6 +38,94 @@ void lvgl_init(void);
  */
 void lvgl_task_handler(void);
 
+/*
+ * Set the period of the LVGL display refresh task and of every input
+ * device read task. UI task only.
+ */
+void lvgl_set_task_periods(uint32_t refr_ms, uint32_t indev_ms);
+
+// Send display data with DMA or blocking SPI writes, no-op unless built with TFT_USE_DMA. UI task only.
+void lvgl_set_dma(bool on);
+
+/*
+ * Display sleep. lvgl_display_sleep() stops rendering and frees the draw
+ * buffers; the refresh task keeps running but drops invalidated areas,
+ * each period with something to draw counts as a skipped frame.
+ * lvgl_display_wake() reallocates them and redraws the whole screen,
+ * false if the heap has no room. Refresh calls below wake the display
+ * first, tft_idle picks that up on its next update. UI task only.
+ */
+void lvgl_display_sleep(void);
+
+bool lvgl_display_wake(void);
+
+bool lvgl_display_asleep(void);
+
+uint32_t lvgl_skipped_frames(void);
+
+/*
+ * Change the draw buffer size (lines, 0 = from free memory), reallocates
+ * at once if awake. On failure the previous size is kept. UI task only.
+ */
+bool lvgl_set_buffer_lines(uint32_t lines);
+
+typedef struct {
+    uint32_t lines;         // Lines per buffer, 0 while asleep
+    uint32_t bytes;         // All buffers
+    uint8_t count;
+    bool auto_size;         // Sized from free memory
+} lvgl_buffer_info_t;
+
+void lvgl_get_buffer_info(lvgl_buffer_info_t *info);
+
+/*
+ * Critical redraw. lvgl_hold_flush() may be called from any task: until
+ * the next lvgl_refresh_critical() areas rendered by LVGL are not sent to
+ * the panel, which lets an ongoing refresh finish quickly. Held areas are
+ * redrawn afterwards.
+ * lvgl_refresh_critical() (UI task) sets pending redraws aside, draws and
+ * flushes only area, waits for the transfer, then restores them.
+ */
+void lvgl_hold_flush(void);
+
+void lvgl_refresh_critical(const lv_area_t *area);
+
+// End a hold without a critical redraw, UI task
+void lvgl_release_flush(void);
+
+/*
+ * Flush tap - called with every area after it has been sent to the panel.
+ * Install with lvgl_set_flush_tap(), which returns the previous tap;
+ * a tap must chain to the one it replaced. UI task only.
+ */
+typedef void (*lvgl_flush_tap_ptr)(const lv_area_t *area, const lv_color_t *pixels);
+
+lvgl_flush_tap_ptr lvgl_set_flush_tap(lvgl_flush_tap_ptr tap);
+
+/*
+ * Touch filter - sees the panel state on every input read and returns the
+ * state passed to LVGL (true = pressed, *x and *y updated when pressed).
+ * Install with lvgl_set_touch_filter(), which returns the previous filter;
+ * a filter must chain to the one it replaced first. UI task only.
+ */
+typedef bool (*lvgl_touch_filter_ptr)(bool touched, uint16_t *x, uint16_t *y);
+
+lvgl_touch_filter_ptr lvgl_set_touch_filter(lvgl_touch_filter_ptr filter);
+
+/*
+ * Redraw the whole active screen immediately, bypassing the refresh timer.
+ * Bands are flushed top to bottom, so the CRC is reproducible for
+ * identical screen content. UI task only, not from LVGL callbacks.
+ */
+typedef struct {
+    uint32_t render_us;     // Time spent rendering (total minus flush)
+    uint32_t flush_us;      // Time spent in the flush callback
+    uint32_t pixels;        // Pixels sent to the panel
+    uint32_t crc;           // CRC-32 of area coordinates and pixel data
+} lvgl_refresh_stats_t;
+
+void lvgl_refresh_screen(lvgl_refresh_stats_t *stats);
+
 #ifdef __cplusplus
 }
 #endif
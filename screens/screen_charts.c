@@ -0,0 +1,238 @@
+/*
+ * screen_charts.c - Feed rate and spindle speed charts
+ *
+ * Part of grblHAL TFT Plugin
+ *
+ * Copyright (c) 2025
+ *
+ * Each chart is a 2 bit indexed image, one pixel column per history bucket
+ * at the same ring index, so a closed bucket is plotted as a single column
+ * and the other columns are never plotted again. The image is shown twice
+ * side by side in a clipping container, moved one column left per bucket,
+ * so the newest column is always at the right edge: the existing pixels
+ * scroll instead of being redrawn from the data. After a stalled UI loop
+ * every bucket closed meanwhile is plotted. Tap a chart for the next time
+ * window, the only other time all columns are plotted.
+ */
+
+#include "driver.h"
+#include "tft_config.h"
+
+#if TFT_ENABLE && TFT_CHARTS_ENABLE
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "grbl/settings.h"
+
+#include "tft_screens.h"
+#include "tft_history.h"
+#include "tft_strings.h"
+
+#define PALETTE_BYTES (4 * sizeof(lv_color32_t))
+#define STRIDE ((TFT_HISTORY_COLUMNS + 3) / 4)
+#define LABEL_X (TFT_HISTORY_COLUMNS + 16)
+
+// Palette entries
+enum {
+    PX_BG = 0,
+    PX_GRID,
+    PX_BAND,                    // Min to max
+    PX_MAX
+};
+
+static const tft_str_id_t titles[TFT_HISTORY_COUNT] = { STR_CHART_FEED, STR_CHART_SPINDLE };
+
+static struct {
+    lv_obj_t *cont;
+    lv_obj_t *img[2];
+    lv_obj_t *label;
+    lv_img_dsc_t dsc;
+    uint8_t *data;              // Palette, then rows
+    uint16_t full;              // Value at the top
+    char text[64];
+} charts[TFT_HISTORY_COUNT];
+
+static uint8_t level;
+static lv_style_t style;
+
+static inline void set_px(uint8_t *px, uint16_t x, uint16_t y, uint8_t idx) {
+    uint8_t *b = px + y * STRIDE + x / 4, shift = 6 - (x & 3) * 2;
+
+    *b = (*b & ~(3 << shift)) | (idx << shift);
+}
+
+static uint16_t scale(uint16_t v, uint16_t full) {
+    uint32_t y = (uint32_t)v * (TFT_CHART_HEIGHT - 1) / full;
+
+    return y > TFT_CHART_HEIGHT - 1 ? TFT_CHART_HEIGHT - 1 : (uint16_t)y;
+}
+
+// Plot ring index x of series, O(height)
+static void plot_column(tft_history_series_t series, uint16_t x) {
+    const tft_history_bucket_t *b = tft_history_at(series, level, x);
+    uint8_t *px = charts[series].data + PALETTE_BYTES;
+    uint16_t top = TFT_CHART_HEIGHT, bottom = TFT_CHART_HEIGHT;
+
+    if(b) {
+        top = TFT_CHART_HEIGHT - 1 - scale(b->max, charts[series].full);
+        bottom = TFT_CHART_HEIGHT - 1 - scale(b->min, charts[series].full);
+    }
+
+    for(uint16_t y = 0; y < TFT_CHART_HEIGHT; y++) {
+        uint8_t idx = y == top ? PX_MAX : (y > top && y <= bottom) ? PX_BAND :
+                       y % (TFT_CHART_HEIGHT / 4) == 0 ? PX_GRID : PX_BG;
+
+        set_px(px, x, y, idx);
+    }
+}
+
+// Newest column at the right edge, the older ones wrap in from the left
+static void place(tft_history_series_t series) {
+    uint16_t head = tft_history_head(level);
+
+    lv_obj_set_x(charts[series].img[0], TFT_HISTORY_COLUMNS - head);
+    lv_obj_set_x(charts[series].img[1], -(lv_coord_t)head);
+}
+
+static void update_label(tft_history_series_t series) {
+    uint16_t newest = (tft_history_head(level) + TFT_HISTORY_COLUMNS - 1) % TFT_HISTORY_COLUMNS;
+    const tft_history_bucket_t *b = tft_history_at(series, level, newest);
+    uint32_t window_s = tft_history_span_ms(level) * TFT_HISTORY_COLUMNS / 1000;
+
+    snprintf(charts[series].text, sizeof(charts[series].text), "%s\n%u\n%s %u\n%u min", tft_str(titles[series]),
+              b ? (unsigned)b->max : 0, tft_str(STR_CHART_FULL), (unsigned)charts[series].full, (unsigned)(window_s / 60));
+    lv_label_set_static_text(charts[series].label, charts[series].text);
+}
+
+static void plot_all(void) {
+    for(uint_fast8_t s = 0; s < TFT_HISTORY_COUNT; s++) {
+        for(uint16_t x = 0; x < TFT_HISTORY_COLUMNS; x++)
+            plot_column((tft_history_series_t)s, x);
+
+        place((tft_history_series_t)s);
+        lv_obj_invalidate(charts[s].cont);
+        update_label((tft_history_series_t)s);
+    }
+}
+
+static void history_changed(const uint16_t *closed) {
+    uint16_t n = closed[level];
+
+    if(n == 0)
+        return;
+
+    // Cleared, or a stall closed a whole ring and the images stay where they are
+    if(n >= TFT_HISTORY_COLUMNS || tft_history_count(level) == 0) {
+        plot_all();
+        return;
+    }
+
+    // The columns closed since the last call, newest last. Moving the images
+    // invalidates them, nothing else to redraw
+    for(uint_fast8_t s = 0; s < TFT_HISTORY_COUNT; s++) {
+        for(uint16_t i = n; i > 0; i--)
+            plot_column((tft_history_series_t)s, (tft_history_head(level) + TFT_HISTORY_COLUMNS - i) % TFT_HISTORY_COLUMNS);
+        place((tft_history_series_t)s);
+        update_label((tft_history_series_t)s);
+    }
+}
+
+static void chart_event(lv_obj_t *obj, lv_event_t event) {
+    if(event == LV_EVENT_CLICKED) {
+        level = (level + 1) % TFT_HISTORY_LEVELS;
+        plot_all();
+    }
+}
+
+static uint16_t full_scale(tft_history_series_t series) {
+    float full = 0.0f;
+
+    if(series == TFT_HISTORY_SPINDLE)
+        full = settings.spindle.rpm_max;
+    else for(uint_fast8_t idx = 0; idx < N_AXIS; idx++) {
+        if(settings.axis[idx].max_rate > full)
+            full = settings.axis[idx].max_rate;
+    }
+
+    return full < 1.0f ? 1 : full > (float)UINT16_MAX ? UINT16_MAX : (uint16_t)full;
+}
+
+static bool chart_create(lv_obj_t *scr, tft_history_series_t series, lv_coord_t y, lv_color_t color) {
+    size_t size = PALETTE_BYTES + STRIDE * TFT_CHART_HEIGHT;
+
+    if((charts[series].data = calloc(1, size)) == NULL)
+        return false;
+
+    lv_color32_t *palette = (lv_color32_t *)charts[series].data;
+    palette[PX_BG].full = lv_color_to32(LV_COLOR_BLACK);
+    palette[PX_GRID].full = lv_color_to32(LV_COLOR_GRAY);
+    palette[PX_BAND].full = lv_color_to32(lv_color_mix(color, LV_COLOR_BLACK, LV_OPA_50));
+    palette[PX_MAX].full = lv_color_to32(color);
+
+    charts[series].dsc.header.cf = LV_IMG_CF_INDEXED_2BIT;
+    charts[series].dsc.header.always_zero = 0;
+    charts[series].dsc.header.w = TFT_HISTORY_COLUMNS;
+    charts[series].dsc.header.h = TFT_CHART_HEIGHT;
+    charts[series].dsc.data_size = size;
+    charts[series].dsc.data = charts[series].data;
+    charts[series].full = full_scale(series);
+
+    // Children are clipped to it
+    charts[series].cont = lv_obj_create(scr, NULL);
+    lv_obj_set_style(charts[series].cont, &style);
+    lv_obj_set_size(charts[series].cont, TFT_HISTORY_COLUMNS, TFT_CHART_HEIGHT);
+    lv_obj_set_pos(charts[series].cont, 8, y);
+    lv_obj_set_event_cb(charts[series].cont, chart_event);
+
+    for(uint_fast8_t i = 0; i < 2; i++) {
+        charts[series].img[i] = lv_img_create(charts[series].cont, NULL);
+        lv_img_set_src(charts[series].img[i], &charts[series].dsc);
+        lv_obj_set_click(charts[series].img[i], false);
+        lv_obj_set_y(charts[series].img[i], 0);
+    }
+
+    charts[series].label = lv_label_create(scr, NULL);
+    lv_obj_set_style(charts[series].label, &style);
+    lv_obj_set_pos(charts[series].label, LABEL_X, y);
+
+    return true;
+}
+
+static void screen_charts_create(lv_obj_t *scr) {
+    const lv_coord_t gap = (LV_VER_RES_MAX - TFT_HISTORY_COUNT * TFT_CHART_HEIGHT) / (TFT_HISTORY_COUNT + 1);
+
+    lv_style_copy(&style, &lv_style_plain);
+    style.body.main_color = style.body.grad_color = LV_COLOR_BLACK;
+    style.body.padding.left = style.body.padding.right = 0;
+    style.body.padding.top = style.body.padding.bottom = 0;
+    style.text.color = LV_COLOR_WHITE;
+    style.text.font = &lv_font_roboto_16;
+    lv_obj_set_style(scr, &style);
+
+    if(!chart_create(scr, TFT_HISTORY_FEED, gap, LV_COLOR_CYAN) ||
+        !chart_create(scr, TFT_HISTORY_SPINDLE, gap * 2 + TFT_CHART_HEIGHT, LV_COLOR_ORANGE))
+        return;
+
+    plot_all();
+
+    tft_history_set_listener(history_changed);
+}
+
+static void screen_charts_destroy(void) {
+    tft_history_set_listener(NULL);
+
+    // Nothing is drawn before the images are deleted with the screen
+    for(uint_fast8_t s = 0; s < TFT_HISTORY_COUNT; s++)
+        free(charts[s].data);
+    memset(charts, 0, sizeof(charts));
+}
+
+const tft_screen_t screen_charts = {
+    .name = "charts",
+    .create = screen_charts_create,
+    .destroy = screen_charts_destroy
+};
+
+#endif // TFT_ENABLE && TFT_CHARTS_ENABLE
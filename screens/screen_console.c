@@ -0,0 +1,96 @@
+/*
+ * screen_console.c - Console (grblHAL output scrollback) screen
+ *
+ * Part of grblHAL TFT Plugin
+ *
+ * Copyright (c) 2025
+ *
+ * The scrollback is numbered by line from boot, so it is handed to the
+ * recycling list as is: dropped lines just move the start of its range.
+ */
+
+#include "driver.h"
+#include "tft_config.h"
+
+#if TFT_ENABLE && TFT_CONSOLE_ENABLE
+
+#include "tft_screens.h"
+#include "tft_stream_tap.h"
+#include "tft_console.h"
+#include "tft_vlist.h"
+
+static lv_task_t *task;
+static lv_style_t style_bg, style_kind[TFT_STREAM_COUNT];
+
+static void styles_init(void) {
+    lv_style_copy(&style_bg, &lv_style_plain);
+    style_bg.body.main_color = style_bg.body.grad_color = LV_COLOR_BLACK;
+    style_bg.body.padding.left = style_bg.body.padding.right = 0;
+    style_bg.body.padding.top = style_bg.body.padding.bottom = 0;
+    style_bg.text.font = &lv_font_roboto_12;
+    style_bg.text.color = LV_COLOR_SILVER;
+
+    for(uint_fast8_t i = 0; i < TFT_STREAM_COUNT; i++)
+        lv_style_copy(&style_kind[i], &style_bg);
+
+    style_kind[TFT_STREAM_OK].text.color = LV_COLOR_GRAY;
+    style_kind[TFT_STREAM_ERROR].text.color = LV_COLOR_RED;
+    style_kind[TFT_STREAM_ALARM].text.color = LV_COLOR_ORANGE;
+    style_kind[TFT_STREAM_MSG].text.color = LV_COLOR_CYAN;
+    style_kind[TFT_STREAM_GC].text.color = LV_COLOR_WHITE;
+}
+
+static void console_range(uint32_t *first, uint32_t *end) {
+    *first = tft_console_first();
+    *end = tft_console_end();
+}
+
+static bool console_item(uint32_t n, char *buf, size_t size, const lv_style_t **style) {
+    int8_t kind;
+
+    if(!tft_console_line(n, buf, size, &kind))
+        return false;
+
+    if(kind >= 0)
+        *style = &style_kind[kind];
+
+    return true;
+}
+
+static const tft_vlist_source_t source = {
+    .range = console_range,
+    .item = console_item
+};
+
+// Pick up new and dropped lines
+static void console_task(lv_task_t *t) {
+    tft_vlist_update();
+}
+
+static void screen_console_create(lv_obj_t *scr) {
+    styles_init();
+
+    if(!tft_vlist_create(scr, lv_obj_get_width(scr), lv_obj_get_height(scr), TFT_CONSOLE_ROW_HEIGHT,
+                          TFT_CONSOLE_LINE_MAX, &style_bg, &source, true))
+        return;
+
+    tft_screen_focus(tft_vlist_obj());
+
+    task = lv_task_create(console_task, TFT_CONSOLE_REFRESH_MS, LV_TASK_PRIO_LOW, NULL);
+}
+
+static void screen_console_destroy(void) {
+    if(task)
+        lv_task_del(task);
+    task = NULL;
+
+    tft_vlist_delete();
+}
+
+const tft_screen_t screen_console = {
+    .name = "console",
+    .create = screen_console_create,
+    .destroy = screen_console_destroy
+};
+
+#endif // TFT_ENABLE && TFT_CONSOLE_ENABLE
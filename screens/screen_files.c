@@ -0,0 +1,128 @@
+/*
+ * screen_files.c - SD card file list screen
+ *
+ * Part of grblHAL TFT Plugin
+ *
+ * Copyright (c) 2025
+ *
+ * The directory is read once when the screen is shown. Names are packed
+ * NUL terminated into a TFT_FILES_ARENA byte heap arena with an offset per
+ * entry, both freed with the screen, and the recycling list draws them.
+ */
+
+#include "driver.h"
+
+#if TFT_ENABLE && SDCARD_ENABLE
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "grbl/vfs.h"
+
+#include "tft_config.h"
+#include "tft_screens.h"
+#include "tft_vlist.h"
+
+static struct {
+    char *names;                // TFT_FILES_ARENA bytes
+    uint16_t *offset;           // TFT_FILES_MAX entries
+    uint32_t *size;             // File size, UINT32_MAX for directories
+    uint16_t count;
+    bool truncated;             // Directory did not fit
+} files;
+
+static lv_style_t style, style_dir;
+
+static void files_range(uint32_t *first, uint32_t *end) {
+    *first = 0;
+    *end = files.count;
+}
+
+static bool files_item(uint32_t n, char *buf, size_t size, const lv_style_t **style) {
+    const char *name = files.names + files.offset[n];
+
+    if(files.size[n] == UINT32_MAX) {
+        snprintf(buf, size, "%s/", name);
+        *style = &style_dir;
+    } else
+        snprintf(buf, size, "%s  %u", name, (unsigned)files.size[n]);
+
+    return true;
+}
+
+static const tft_vlist_source_t source = {
+    .range = files_range,
+    .item = files_item
+};
+
+static void files_read(const char *path) {
+    vfs_dir_t *dir;
+    vfs_dirent_t *entry;
+    uint32_t used = 0;
+
+    files.count = 0;
+    files.truncated = false;
+
+    if((dir = vfs_opendir(path)) == NULL)
+        return;
+
+    while((entry = vfs_readdir(dir))) {
+        size_t len = strlen(entry->name) + 1;
+
+        if(files.count == TFT_FILES_MAX || used + len > TFT_FILES_ARENA) {
+            files.truncated = true;
+            break;
+        }
+
+        memcpy(files.names + used, entry->name, len);
+        files.offset[files.count] = (uint16_t)used;
+        files.size[files.count] = entry->st_mode.directory ? UINT32_MAX : (uint32_t)entry->size;
+        files.count++;
+        used += len;
+    }
+
+    vfs_closedir(dir);
+}
+
+static void files_free(void) {
+    free(files.names);
+    free(files.offset);
+    free(files.size);
+    memset(&files, 0, sizeof(files));
+}
+
+static void screen_files_create(lv_obj_t *scr) {
+    lv_style_copy(&style, &lv_style_plain);
+    style.body.padding.left = style.body.padding.right = 0;
+    style.body.padding.top = style.body.padding.bottom = 0;
+    style.text.font = &lv_font_roboto_16;
+    lv_style_copy(&style_dir, &style);
+    style_dir.text.color = LV_COLOR_BLUE;
+
+    files.names = malloc(TFT_FILES_ARENA);
+    files.offset = malloc(TFT_FILES_MAX * sizeof(uint16_t));
+    files.size = malloc(TFT_FILES_MAX * sizeof(uint32_t));
+
+    if(files.names && files.offset && files.size)
+        files_read(TFT_FILES_PATH);
+    else
+        files_free();
+
+    tft_vlist_create(scr, lv_obj_get_width(scr), lv_obj_get_height(scr), TFT_VLIST_ROW_HEIGHT,
+                      TFT_VLIST_TEXT_MAX, &style, &source, false);
+    tft_screen_focus(tft_vlist_obj());
+}
+
+static void screen_files_destroy(void) {
+    tft_vlist_delete();
+    files_free();
+}
+
+const tft_screen_t screen_files = {
+    .name = "files",
+    .create = screen_files_create,
+    .destroy = screen_files_destroy
+};
+
+#endif // TFT_ENABLE && SDCARD_ENABLE
@@ -0,0 +1,177 @@
+/*
+ * screen_heightmap.c - Probed surface heightmap screen
+ *
+ * Part of grblHAL TFT Plugin
+ *
+ * Copyright (c) 2025
+ *
+ * The grid is drawn as colour mapped cells, blue low to red high, by the
+ * design callback of a plain object: there is no pixel buffer, and only
+ * the cells inside the area being redrawn are painted. A new point
+ * invalidates just its cell, so a grid probe redraws one cell at a time.
+ * Row 0 (front) is at the bottom.
+ */
+
+#include "driver.h"
+#include "tft_config.h"
+
+#if TFT_ENABLE && TFT_PROBE_ENABLE
+
+#include <stdio.h>
+
+#include "tft_screens.h"
+#include "tft_heightmap.h"
+#include "tft_strings.h"
+
+#define LABEL_HEIGHT 24
+
+static struct {
+    lv_obj_t *scr;
+    lv_obj_t *map;
+    lv_obj_t *label;
+    lv_coord_t cell;            // Cell size, px
+    char text[64];
+} view;
+
+static lv_style_t style_bg, style_cell;
+static lv_design_cb_t ancestor_design;
+
+static lv_color_t cell_color(int16_t v, const tft_heightmap_t *map) {
+    if(v == TFT_HEIGHTMAP_NONE)
+        return LV_COLOR_GRAY;
+
+    uint32_t span = (uint32_t)(map->max - map->min);
+    uint16_t hue = span ? 240 - (uint32_t)(v - map->min) * 240 / span : 120;
+
+    return lv_color_hsv_to_rgb(hue, 100, 100);
+}
+
+static void cell_area(const lv_area_t *coords, uint8_t ix, uint8_t iy, lv_area_t *area) {
+    area->x1 = coords->x1 + ix * view.cell;
+    area->x2 = area->x1 + view.cell - 1;
+    area->y2 = coords->y2 - iy * view.cell;
+    area->y1 = area->y2 - view.cell + 1;
+}
+
+static bool map_design(lv_obj_t *obj, const lv_area_t *mask, lv_design_mode_t mode) {
+    const tft_heightmap_t *map = tft_heightmap_get_info();
+    lv_area_t coords, area;
+
+    if(mode != LV_DESIGN_DRAW_MAIN || map->nx == 0 || view.cell == 0)
+        return ancestor_design(obj, mask, mode);
+
+    lv_obj_get_coords(obj, &coords);
+
+    // Cells the mask touches
+    int32_t ix0 = (mask->x1 - coords.x1) / view.cell, ix1 = (mask->x2 - coords.x1) / view.cell;
+    int32_t iy0 = (coords.y2 - mask->y2) / view.cell, iy1 = (coords.y2 - mask->y1) / view.cell;
+
+    if(ix0 < 0)
+        ix0 = 0;
+    if(iy0 < 0)
+        iy0 = 0;
+    if(ix1 >= map->nx)
+        ix1 = map->nx - 1;
+    if(iy1 >= map->ny)
+        iy1 = map->ny - 1;
+
+    for(int32_t iy = iy0; iy <= iy1; iy++) {
+        for(int32_t ix = ix0; ix <= ix1; ix++) {
+            style_cell.body.main_color = style_cell.body.grad_color =
+                cell_color(tft_heightmap_get((uint8_t)ix, (uint8_t)iy), map);
+            cell_area(&coords, (uint8_t)ix, (uint8_t)iy, &area);
+            lv_draw_rect(&area, mask, &style_cell, LV_OPA_COVER);
+        }
+    }
+
+    return true;
+}
+
+static void update_label(const tft_heightmap_t *map) {
+    // The empty map text follows language switches
+    if(map->nx == 0) {
+        tft_str_bind(view.label, STR_MAP_EMPTY);
+        return;
+    }
+
+    tft_str_unbind(view.label);
+    snprintf(view.text, sizeof(view.text), "%ux%u  %u %s  %.3f..%.3f mm", (unsigned)map->nx, (unsigned)map->ny,
+              (unsigned)map->probed, tft_str(STR_MAP_PROBED), map->min / 1000.0f, map->max / 1000.0f);
+
+    lv_label_set_static_text(view.label, view.text);
+}
+
+// Size the cells to the grid
+static void layout(const tft_heightmap_t *map) {
+    lv_coord_t w = lv_obj_get_width(view.scr), h = lv_obj_get_height(view.scr) - LABEL_HEIGHT;
+
+    view.cell = 0;
+    if(map->nx) {
+        view.cell = w / map->nx < h / map->ny ? w / map->nx : h / map->ny;
+        if(view.cell == 0)
+            view.cell = 1;
+    }
+
+    lv_obj_set_size(view.map, view.cell * map->nx, view.cell * map->ny);
+    lv_obj_align(view.map, NULL, LV_ALIGN_IN_TOP_MID, 0, 0);
+    lv_obj_invalidate(view.map);
+}
+
+static void map_changed(int16_t ix, int16_t iy) {
+    const tft_heightmap_t *map = tft_heightmap_get_info();
+
+    if(ix < 0 || view.cell * map->nx != lv_obj_get_width(view.map))
+        layout(map);
+    else {
+        lv_area_t coords, area;
+
+        lv_obj_get_coords(view.map, &coords);
+        cell_area(&coords, (uint8_t)ix, (uint8_t)iy, &area);
+        lv_inv_area(lv_disp_get_default(), &area);
+    }
+
+    update_label(map);
+}
+
+static void screen_heightmap_create(lv_obj_t *scr) {
+    const tft_heightmap_t *map = tft_heightmap_get_info();
+
+    lv_style_copy(&style_bg, &lv_style_plain);
+    style_bg.body.main_color = style_bg.body.grad_color = LV_COLOR_BLACK;
+    style_bg.text.color = LV_COLOR_WHITE;
+    style_bg.text.font = &lv_font_roboto_16;
+    lv_style_copy(&style_cell, &lv_style_plain);
+    style_cell.body.radius = 0;
+
+    view.scr = scr;
+    lv_obj_set_style(scr, &style_bg);
+
+    view.map = lv_obj_create(scr, NULL);
+    lv_obj_set_style(view.map, &style_bg);
+    lv_obj_set_click(view.map, false);
+    ancestor_design = lv_obj_get_design_cb(view.map);
+    lv_obj_set_design_cb(view.map, map_design);
+
+    view.label = lv_label_create(scr, NULL);
+    lv_obj_set_style(view.label, &style_bg);
+    lv_obj_set_pos(view.label, 4, lv_obj_get_height(scr) - LABEL_HEIGHT + 4);
+
+    layout(map);
+    update_label(map);
+
+    tft_heightmap_set_listener(map_changed);
+}
+
+static void screen_heightmap_destroy(void) {
+    tft_heightmap_set_listener(NULL);
+    tft_str_unbind(view.label);
+    view.map = view.label = NULL;
+}
+
+const tft_screen_t screen_heightmap = {
+    .name = "heightmap",
+    .create = screen_heightmap_create,
+    .destroy = screen_heightmap_destroy
+};
+
+#endif // TFT_ENABLE && TFT_PROBE_ENABLE
@@ -0,0 +1,116 @@
+/*
+ * screen_macros.c - Macro buttons screen
+ *
+ * Part of grblHAL TFT Plugin
+ *
+ * Copyright (c) 2025
+ *
+ * One row per macro slot, tap a row to run its macro, tap the running one
+ * to abort it. Rows are read again only when the table or the run state
+ * has changed, checked every TFT_MACRO_REFRESH_MS.
+ */
+
+#include "driver.h"
+#include "tft_config.h"
+
+#if TFT_ENABLE && TFT_MACRO_ENABLE
+
+#include <stdio.h>
+
+#include "tft_screens.h"
+#include "tft_vlist.h"
+#include "tft_macro.h"
+#include "tft_strings.h"
+
+// Idle rows show no state
+static const tft_str_id_t state_text[] = {
+    [TFT_MACRO_SENDING] = STR_MACRO_RUNNING,
+    [TFT_MACRO_FINISHING] = STR_MACRO_FINISHING,
+    [TFT_MACRO_DONE] = STR_MACRO_DONE,
+    [TFT_MACRO_FAILED] = STR_MACRO_FAILED
+};
+
+static lv_task_t *task;
+static uint32_t generation;
+static lv_style_t style, style_empty, style_run;
+
+static void macros_range(uint32_t *first, uint32_t *end) {
+    *first = 0;
+    *end = TFT_MACRO_SLOTS;
+}
+
+static bool macros_item(uint32_t n, char *buf, size_t size, const lv_style_t **style) {
+    const tft_macro_status_t *run = tft_macro_get_status();
+    const char *name = tft_macro_name((uint8_t)n);
+
+    if(name == NULL) {
+        snprintf(buf, size, "%u  -", (unsigned)n);
+        *style = &style_empty;
+    } else if(run->state != TFT_MACRO_IDLE && run->slot == n) {
+        snprintf(buf, size, "%u  %s  %s %u/%u%s%s", (unsigned)n, name, tft_str(state_text[run->state]), (unsigned)run->line,
+                  (unsigned)run->lines, run->error ? ": " : "", run->error ? run->error : "");
+        *style = &style_run;
+    } else
+        snprintf(buf, size, "%u  %s  %u %s", (unsigned)n, name, (unsigned)tft_macro_lines((uint8_t)n), tft_str(STR_MACRO_LINES));
+
+    return true;
+}
+
+static void macros_clicked(uint32_t n) {
+    const tft_macro_status_t *run = tft_macro_get_status();
+
+    if((run->state == TFT_MACRO_SENDING || run->state == TFT_MACRO_FINISHING) && run->slot == n)
+        tft_macro_abort();
+    else
+        tft_macro_run((uint8_t)n);
+}
+
+static const tft_vlist_source_t source = {
+    .range = macros_range,
+    .item = macros_item,
+    .clicked = macros_clicked
+};
+
+static void macros_task(lv_task_t *t) {
+    if(generation != tft_macro_generation()) {
+        generation = tft_macro_generation();
+        tft_vlist_refresh();
+    }
+}
+
+static void screen_macros_create(lv_obj_t *scr) {
+    lv_style_copy(&style, &lv_style_plain);
+    style.body.padding.left = style.body.padding.right = 0;
+    style.body.padding.top = style.body.padding.bottom = 0;
+    style.text.font = &lv_font_roboto_16;
+    lv_style_copy(&style_empty, &style);
+    style_empty.text.color = LV_COLOR_GRAY;
+    lv_style_copy(&style_run, &style);
+    style_run.text.color = LV_COLOR_BLUE;
+
+    generation = tft_macro_generation();
+
+    if(!tft_vlist_create(scr, lv_obj_get_width(scr), lv_obj_get_height(scr), TFT_VLIST_ROW_HEIGHT,
+                          TFT_VLIST_TEXT_MAX, &style, &source, false))
+        return;
+
+    tft_screen_focus(tft_vlist_obj());
+
+    task = lv_task_create(macros_task, TFT_MACRO_REFRESH_MS, LV_TASK_PRIO_LOW, NULL);
+}
+
+static void screen_macros_destroy(void) {
+    if(task)
+        lv_task_del(task);
+    task = NULL;
+
+    tft_vlist_delete();
+}
+
+const tft_screen_t screen_macros = {
+    .name = "macros",
+    .create = screen_macros_create,
+    .destroy = screen_macros_destroy
+};
+
+#endif // TFT_ENABLE && TFT_MACRO_ENABLE
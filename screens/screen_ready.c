@@ -0,0 +1,43 @@
+/*
+ * screen_ready.c - Ready (idle) screen
+ *
+ * Part of grblHAL TFT Plugin
+ *
+ * Copyright (c) 2025
+ *
+ */
+
+#include "driver.h"
+
+#if TFT_ENABLE
+
+#include "tft_screens.h"
+#include "tft_strings.h"
+
+static lv_obj_t *label;
+
+static void screen_ready_create(lv_obj_t *scr) {
+    // Create "Hello World" label (text points into the string table)
+    label = lv_label_create(scr, NULL);
+    tft_str_bind(label, STR_READY_BANNER);
+
+    // Set larger font if available
+    static lv_style_t style;
+    lv_style_copy(&style, &lv_style_plain);
+    style.text.font = &lv_font_roboto_28;
+    lv_obj_set_style(label, &style);
+
+    lv_obj_align(label, NULL, LV_ALIGN_CENTER, 0, 0);
+}
+
+static void screen_ready_destroy(void) {
+    tft_str_unbind(label);
+}
+
+const tft_screen_t screen_ready = {
+    .name = "ready",
+    .create = screen_ready_create,
+    .destroy = screen_ready_destroy
+};
+
+#endif // TFT_ENABLE
@@ -0,0 +1,98 @@
+/*
+ * screen_settings.c - grblHAL $ settings list screen
+ *
+ * Part of grblHAL TFT Plugin
+ *
+ * Copyright (c) 2025
+ *
+ * The ids of the available settings are collected once when the screen is
+ * shown, into a heap array freed with it. Names and values are read from
+ * grblHAL only for the rows the recycling list binds.
+ */
+
+#include "driver.h"
+
+#if TFT_ENABLE
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "grbl/settings.h"
+
+#include "tft_config.h"
+#include "tft_screens.h"
+#include "tft_vlist.h"
+
+static uint16_t *ids = NULL;
+static uint16_t count = 0;
+static lv_style_t style;
+
+static void settings_range(uint32_t *first, uint32_t *end) {
+    *first = 0;
+    *end = count;
+}
+
+static bool settings_item(uint32_t n, char *buf, size_t size, const lv_style_t **style) {
+    const setting_detail_t *setting = setting_get_details((setting_id_t)ids[n], NULL);
+
+    if(setting == NULL)
+        return false;
+
+    snprintf(buf, size, "$%u=%s  %s", (unsigned)ids[n],
+              setting_get_value(setting, ids[n] - setting->id), setting->name ? setting->name : "");
+
+    return true;
+}
+
+static const tft_vlist_source_t source = {
+    .range = settings_range,
+    .item = settings_item
+};
+
+static void collect_ids(void) {
+    count = 0;
+
+    if((ids = malloc(Setting_SettingsMax * sizeof(uint16_t))) == NULL)
+        return;
+
+    for(uint_fast16_t id = 0; id < Setting_SettingsMax; id++) {
+        const setting_detail_t *setting = setting_get_details((setting_id_t)id, NULL);
+
+        if(setting && (setting->is_available == NULL || setting->is_available(setting)))
+            ids[count++] = (uint16_t)id;
+    }
+
+    // Keep only what is used
+    uint16_t *used = realloc(ids, (count ? count : 1) * sizeof(uint16_t));
+    if(used)
+        ids = used;
+}
+
+static void screen_settings_create(lv_obj_t *scr) {
+    lv_style_copy(&style, &lv_style_plain);
+    style.body.padding.left = style.body.padding.right = 0;
+    style.body.padding.top = style.body.padding.bottom = 0;
+    style.text.font = &lv_font_roboto_16;
+
+    collect_ids();
+
+    tft_vlist_create(scr, lv_obj_get_width(scr), lv_obj_get_height(scr), TFT_VLIST_ROW_HEIGHT,
+                      TFT_VLIST_TEXT_MAX, &style, &source, false);
+    tft_screen_focus(tft_vlist_obj());
+}
+
+static void screen_settings_destroy(void) {
+    tft_vlist_delete();
+
+    free(ids);
+    ids = NULL;
+    count = 0;
+}
+
+const tft_screen_t screen_settings = {
+    .name = "settings",
+    .create = screen_settings_create,
+    .destroy = screen_settings_destroy
+};
+
+#endif // TFT_ENABLE
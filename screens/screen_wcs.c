@@ -0,0 +1,98 @@
+/*
+ * screen_wcs.c - Work coordinate offset table screen
+ *
+ * Part of grblHAL TFT Plugin
+ *
+ * Copyright (c) 2025
+ *
+ * One row per coordinate system G54 - G59, the active one marked, plus G92
+ * and the tool length offset. Stored systems can change without the active
+ * offset changing (G10 L2 P<n>), so rows are read again every
+ * TFT_WCS_REFRESH_MS and a label is only set when its text changed.
+ */
+
+#include "driver.h"
+
+#if TFT_ENABLE
+
+#include <stdio.h>
+#include <string.h>
+
+#include "tft_config.h"
+#include "tft_screens.h"
+#include "tft_offsets.h"
+
+#define ROW_TEXT 64
+
+static const char *const row_names[TFT_OFFSET_COUNT] = {
+    "G54", "G55", "G56", "G57", "G58", "G59", "G92", "TLO"
+};
+
+static struct {
+    lv_obj_t *label[TFT_OFFSET_COUNT];
+    char text[TFT_OFFSET_COUNT][ROW_TEXT];
+    lv_task_t *task;
+} view;
+
+static lv_style_t style;
+
+static void row_text(tft_offset_t row, char *buf) {
+    float xyz[N_AXIS];
+    // G59.1 to G59.3 number on past G59, into the G92 and TLO rows: those are never active
+    bool active = row < TFT_OFFSET_G92 && row == tft_offsets_active();
+    char *p = buf + sprintf(buf, "%s%c", row_names[row], active ? '*' : ' ');
+
+    if(!tft_offsets_read(row, xyz)) {
+        strcpy(p, " -");
+        return;
+    }
+
+    for(uint_fast8_t idx = 0; idx < N_AXIS && idx < 3; idx++)
+        p += snprintf(p, ROW_TEXT - (p - buf), "  %c%9.3f", 'X' + idx, xyz[idx]);
+}
+
+static void refresh(void) {
+    char text[ROW_TEXT];
+
+    for(uint_fast8_t row = 0; row < TFT_OFFSET_COUNT; row++) {
+        row_text((tft_offset_t)row, text);
+        if(strcmp(text, view.text[row])) {
+            strcpy(view.text[row], text);
+            lv_label_set_static_text(view.label[row], view.text[row]);
+        }
+    }
+}
+
+static void wcs_task(lv_task_t *t) {
+    refresh();
+}
+
+static void screen_wcs_create(lv_obj_t *scr) {
+    lv_style_copy(&style, &lv_style_plain);
+    style.text.font = &lv_font_roboto_16;
+
+    for(uint_fast8_t row = 0; row < TFT_OFFSET_COUNT; row++) {
+        view.label[row] = lv_label_create(scr, NULL);
+        lv_obj_set_style(view.label[row], &style);
+        lv_obj_set_pos(view.label[row], 8, 8 + row * TFT_WCS_ROW_HEIGHT);
+        view.text[row][0] = '\0';
+    }
+
+    refresh();
+
+    view.task = lv_task_create(wcs_task, TFT_WCS_REFRESH_MS, LV_TASK_PRIO_LOW, NULL);
+}
+
+static void screen_wcs_destroy(void) {
+    if(view.task)
+        lv_task_del(view.task);
+    view.task = NULL;
+}
+
+const tft_screen_t screen_wcs = {
+    .name = "wcs",
+    .create = screen_wcs_create,
+    .destroy = screen_wcs_destroy
+};
+
+#endif // TFT_ENABLE
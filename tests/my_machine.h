@@ -0,0 +1,16 @@
+/*
+ * my_machine.h - Host test stand-in for the driver's machine configuration
+ *
+ * Part of grblHAL TFT Plugin
+ *
+ * Copyright (c) 2025
+ *
+ */
+
+#define TFT_ENABLE          1
+#define TFT_RESUME_ENABLE   1
+#define SDCARD_ENABLE       1
+#define TFT_WIDTH           480
+#define TFT_HEIGHT          320
+#define TFT_ROTATION        1
+#define LVGL_REFRESH_PERIOD 5
@@ -0,0 +1,88 @@
+/*
+ * test_modal.c - Host test for the G-code modal state follower
+ *
+ * Part of grblHAL TFT Plugin
+ *
+ * Copyright (c) 2025
+ *
+ */
+
+#include <stdio.h>
+#include <math.h>
+
+#include "tft_modal.h"
+
+static int failed;
+
+#define CHECK(cond) do { if(!(cond)) { printf("%s:%d: %s\n", __FILE__, __LINE__, #cond); failed++; } } while(0)
+
+static tft_modal_t follow(const char *line) {
+    tft_modal_t m = tft_modal_default;
+
+    tft_modal_apply(&m, line);
+
+    return m;
+}
+
+static bool near(float a, float b) {
+    return fabsf(a - b) < 1e-4f;
+}
+
+int main(void) {
+    tft_modal_t m;
+
+    // Unspaced words split at the next letter, not read as hex or exponent
+    m = follow("G0X10Y5");
+    CHECK(m.motion == 0);
+    CHECK(m.known == 0x03);
+    CHECK(near(m.pos[0], 10.0f) && near(m.pos[1], 5.0f));
+
+    m = follow("G1X1E2");
+    CHECK(m.motion == 1);
+    CHECK(m.known == 0x01);
+    CHECK(near(m.pos[0], 1.0f));
+
+    m = follow("G1X-1.5Z.25F300");
+    CHECK(m.known == 0x05);
+    CHECK(near(m.pos[0], -1.5f) && near(m.pos[2], 0.25f));
+    CHECK(near(m.feed, 300.0f));
+
+    m = follow("G0 X10 Y5 (comment X99) Z-0.05");
+    CHECK(m.known == 0x07);
+    CHECK(near(m.pos[0], 10.0f) && near(m.pos[2], -0.05f));
+
+    m = follow("G90G55G21M3S12000");
+    CHECK(m.wcs == 1 && m.spindle == 3);
+    CHECK(near(m.rpm, 12000.0f));
+
+    // Long mantissa keeps its magnitude
+    m = follow("X123456789.5");
+    CHECK(fabsf(m.pos[0] - 123456789.5f) < 100.0f);
+
+    // Tool length offsets, converted with the units
+    m = follow("G43.1Z-12.5");
+    CHECK(m.tlo_mode == TFT_TLO_DYNAMIC && near(m.tlo, -12.5f));
+    CHECK(m.known == 0);
+    tft_modal_apply(&m, "G20");
+    CHECK(near(m.tlo, -12.5f / 25.4f));
+    tft_modal_apply(&m, "G49");
+    CHECK(m.tlo_mode == TFT_TLO_CANCELLED);
+
+    m = follow("G43 H3");
+    CHECK(m.tlo_mode == TFT_TLO_TOOL && m.tool == 3);
+
+    m = follow("G43");
+    CHECK(m.tlo_mode == TFT_TLO_UNKNOWN);
+
+    m = follow("G0 X1 Y2 Z3");
+    CHECK(m.tlo_mode == TFT_TLO_UNCHANGED);
+
+    // A word without a number ends the line
+    m = follow("G0X Y5");
+    CHECK(m.known == 0);
+
+    if(!failed)
+        printf("modal: all passed\n");
+
+    return failed ? 1 : 0;
+}
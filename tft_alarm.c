@@ -0,0 +1,174 @@
+/*
+ * tft_alarm.c - Alarm and E-stop overlay with priority redraw
+ *
+ * Part of grblHAL TFT Plugin
+ *
+ * Copyright (c) 2025
+ *
+ */
+
+#include "driver.h"
+
+#if TFT_ENABLE
+
+#include <stdio.h>
+
+#include "esp_timer.h"
+#include "grbl/hal.h"
+#include "grbl/state_machine.h"
+
+#include "tft_config.h"
+#include "tft_commands.h"
+#include "tft_strings.h"
+#include "tft_beep.h"
+#include "tft_alarm.h"
+#include "lvgl_init.h"
+
+#define is_critical(state) ((state) == STATE_ALARM || (state) == STATE_ESTOP)
+
+// Written by the state hook
+static volatile struct {
+    sys_state_t state;
+    alarm_code_t alarm;
+    bool timed;                 // UI task was woken, measure time to glass
+    uint32_t changed_us;        // Time of the last critical transition
+} latched;
+
+static TaskHandle_t ui_task = NULL;
+
+// UI task
+static lv_obj_t *overlay = NULL, *label;
+static bool shown = false;
+static sys_state_t shown_state;
+static alarm_code_t shown_alarm;
+static char text[32];
+
+static struct {
+    uint32_t count;
+    uint32_t last_us;
+    uint32_t max_us;
+    uint64_t total_us;
+} stats;
+
+void tft_alarm_state_changed(sys_state_t state, alarm_code_t alarm) {
+    bool enter = is_critical(state) && !is_critical(latched.state);
+
+#if TFT_BEEP_ENABLE
+    if(enter)
+        tft_beep_play(TFT_BEEP_ALARM);
+    else if(!is_critical(state))
+        tft_beep_cancel(TFT_BEEP_ALARM);
+#endif
+
+    latched.alarm = alarm;
+    latched.state = state;
+
+    if(enter && ui_task) {
+        latched.changed_us = (uint32_t)esp_timer_get_time();
+        latched.timed = true;
+        lvgl_hold_flush();
+        xTaskNotifyGive(ui_task);
+    }
+}
+
+static void overlay_show(sys_state_t state, alarm_code_t alarm) {
+    if(state == STATE_ESTOP)
+        snprintf(text, sizeof(text), "%s", tft_str(STR_ESTOP));
+    else
+        snprintf(text, sizeof(text), "%s %u", tft_str(STR_ALARM), (unsigned)alarm);
+
+    lv_label_set_static_text(label, text);
+    lv_obj_align(label, NULL, LV_ALIGN_CENTER, 0, 0);
+    lv_obj_set_hidden(overlay, false);
+
+    shown = true;
+    shown_state = state;
+    shown_alarm = alarm;
+}
+
+void tft_alarm_poll(void) {
+    if(overlay == NULL)
+        return;
+
+    sys_state_t state = latched.state;
+    alarm_code_t alarm = latched.alarm;
+
+    if(is_critical(state)) {
+        if(!shown) {
+            bool timed = latched.timed;
+            uint32_t changed_us = latched.changed_us;
+            lv_area_t area;
+
+            latched.timed = false;
+
+            overlay_show(state, alarm);
+            lv_obj_get_coords(overlay, &area);
+            lvgl_refresh_critical(&area);
+
+            // Not timed when the state was critical before the UI task started
+            if(timed) {
+                uint32_t us = (uint32_t)esp_timer_get_time() - changed_us;
+                stats.count++;
+                stats.last_us = us;
+                stats.total_us += us;
+                if(us > stats.max_us)
+                    stats.max_us = us;
+            }
+        } else if(state != shown_state || alarm != shown_alarm)
+            overlay_show(state, alarm);     // Alarm to E-stop or new code, normal redraw
+    } else {
+        if(shown) {
+            lv_obj_set_hidden(overlay, true);
+            shown = false;
+        }
+        // The critical state may have ended before it was drawn
+        latched.timed = false;
+        lvgl_release_flush();
+    }
+}
+
+bool tft_alarm_active(void) {
+    return is_critical(latched.state);
+}
+
+status_code_t tft_alarm_command(char *args) {
+    char *arg = tft_command_arg(&args);
+
+    if(arg) {
+        if(!tft_command_is(arg, "RESET") || args)
+            return Status_InvalidStatement;
+        stats.count = stats.last_us = stats.max_us = 0;
+        stats.total_us = 0;
+        return Status_OK;
+    }
+
+    char msg[80];
+    snprintf(msg, sizeof(msg), "[TFTALARM:count=%u,last_us=%u,avg_us=%u,max_us=%u]" ASCII_EOL,
+              (unsigned)stats.count, (unsigned)stats.last_us,
+              (unsigned)(stats.count ? stats.total_us / stats.count : 0), (unsigned)stats.max_us);
+    hal.stream.write(msg);
+
+    return Status_OK;
+}
+
+void tft_alarm_init(void) {
+    static lv_style_t style;
+
+    lv_style_copy(&style, &lv_style_plain);
+    style.body.main_color = style.body.grad_color = LV_COLOR_RED;
+    style.text.color = LV_COLOR_WHITE;
+    style.text.font = &lv_font_roboto_28;
+
+    // Top layer keeps the banner above every screen
+    overlay = lv_cont_create(lv_layer_top(), NULL);
+    lv_obj_set_style(overlay, &style);
+    lv_obj_set_size(overlay, TFT_DISPLAY_WIDTH, TFT_ALARM_OVERLAY_HEIGHT);
+    lv_obj_set_pos(overlay, 0, 0);
+    lv_obj_set_hidden(overlay, true);
+
+    label = lv_label_create(overlay, NULL);
+
+    ui_task = xTaskGetCurrentTaskHandle();
+}
+
+#endif // TFT_ENABLE
@@ -0,0 +1,45 @@
+/*
+ * tft_alarm.h - Alarm and E-stop overlay with priority redraw
+ *
+ * Part of grblHAL TFT Plugin
+ *
+ * Copyright (c) 2025
+ *
+ * Entering STATE_ALARM or STATE_ESTOP takes a fast path that does not
+ * depend on the event queue: the state hook holds back non-critical
+ * flushes and wakes the UI task, which shows a banner prebuilt on the top
+ * layer and redraws only the banner area before anything else. The time
+ * from the state change to the banner being on glass is reported with
+ * $TFT=ALARM.
+ */
+
+#ifndef _TFT_ALARM_H_
+#define _TFT_ALARM_H_
+
+#include <stdint.h>
+#include "grbl/hal.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Build the hidden overlay and take the calling (UI) task as the one to wake
+void tft_alarm_init(void);
+
+// Called from the on_state_change hook for every state change, any task
+void tft_alarm_state_changed(sys_state_t state, alarm_code_t alarm);
+
+// Show or hide the overlay to match the latest state, UI task
+void tft_alarm_poll(void);
+
+// Latest state is alarm or E-stop, any task
+bool tft_alarm_active(void);
+
+// $TFT=ALARM[,RESET]
+status_code_t tft_alarm_command(char *args);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // _TFT_ALARM_H_
@@ -0,0 +1,202 @@
+/*
+ * tft_beep.c - Non-blocking beeper tone sequencer
+ *
+ * Part of grblHAL TFT Plugin
+ *
+ * Copyright (c) 2025
+ *
+ */
+
+#include "driver.h"
+
+#if TFT_ENABLE && TFT_BEEP_ENABLE
+
+#include <stdio.h>
+
+#include "esp_timer.h"
+#include "grbl/hal.h"
+
+#include "tft_config.h"
+#include "tft_commands.h"
+#include "tft_driver.h"
+#include "tft_beep.h"
+
+// On and off times in ms, starting with on, 0 terminated
+static const uint16_t click[] = { TFT_BEEP_CLICK_MS, 0 };
+static const uint16_t chime[] = { 80, 60, 80, 60, 250, 150, 0 };   // Ends silent, keeps queued chimes apart
+static const uint16_t alarm[] = { 250, 150, 250, 700, 0 };
+
+static const struct {
+    const char *name;
+    const uint16_t *steps;
+    bool repeat;
+} patterns[TFT_BEEP_COUNT] = {
+    [TFT_BEEP_CLICK] = { "CLICK", click, false },
+    [TFT_BEEP_CHIME] = { "CHIME", chime, false },
+    [TFT_BEEP_ALARM] = { "ALARM", alarm, true },
+};
+
+static struct {
+    uint8_t queue[TFT_BEEP_QUEUE_SIZE];
+    uint8_t head, tail, count;
+    int8_t playing;             // Pattern, -1 when silent
+    uint8_t step;
+    uint32_t played;
+    uint32_t dropped;
+} seq = {
+    .playing = -1
+};
+
+static esp_timer_handle_t timer = NULL;
+static portMUX_TYPE lock = portMUX_INITIALIZER_UNLOCKED;
+
+// Only the timer callback drives the pin and advances the pattern
+static void beep_timer(void *arg) {
+    bool on = false;
+    uint32_t ms = 0;
+
+    portENTER_CRITICAL(&lock);
+
+    if(seq.playing >= 0 && patterns[seq.playing].steps[seq.step] == 0) {
+        if(patterns[seq.playing].repeat)
+            seq.step = 0;
+        else
+            seq.playing = -1;
+    }
+
+    if(seq.playing < 0 && seq.count) {
+        seq.playing = seq.queue[seq.tail];
+        seq.tail = (seq.tail + 1) % TFT_BEEP_QUEUE_SIZE;
+        seq.count--;
+        seq.step = 0;
+        seq.played++;
+    }
+
+    if(seq.playing >= 0) {
+        ms = patterns[seq.playing].steps[seq.step];
+        on = !(seq.step & 1);
+        seq.step++;
+    }
+
+    portEXIT_CRITICAL(&lock);
+
+    if(on)
+        tft_beeper_on();
+    else
+        tft_beeper_off();
+
+    if(ms)
+        esp_timer_start_once(timer, ms * 1000ULL);
+}
+
+// Run the timer callback now, restarting a step in progress if preempting
+static void kick(bool preempt) {
+    if(preempt)
+        esp_timer_stop(timer);
+
+    esp_timer_start_once(timer, 0);
+}
+
+static void flush_queue(void) {
+    seq.dropped += seq.count;
+    seq.head = seq.tail = seq.count = 0;
+    seq.playing = -1;
+}
+
+bool tft_beep_play(tft_beep_pattern_t pattern) {
+    bool ok = true, preempt = false, silent;
+
+    if(timer == NULL || pattern >= TFT_BEEP_COUNT)
+        return false;
+
+    portENTER_CRITICAL(&lock);
+
+    silent = seq.playing < 0 && seq.count == 0;
+
+    if(pattern == TFT_BEEP_ALARM) {
+        preempt = !silent;
+        flush_queue();
+    } else if(seq.playing == TFT_BEEP_ALARM || seq.count == TFT_BEEP_QUEUE_SIZE || (pattern == TFT_BEEP_CLICK && !silent))
+        ok = false;
+
+    if(ok) {
+        seq.queue[seq.head] = (uint8_t)pattern;
+        seq.head = (seq.head + 1) % TFT_BEEP_QUEUE_SIZE;
+        seq.count++;
+    } else
+        seq.dropped++;
+
+    portEXIT_CRITICAL(&lock);
+
+    if(ok && (silent || preempt))
+        kick(preempt);
+
+    return ok;
+}
+
+void tft_beep_cancel(tft_beep_pattern_t pattern) {
+    bool stop;
+
+    portENTER_CRITICAL(&lock);
+    stop = seq.playing == (int8_t)pattern;
+    portEXIT_CRITICAL(&lock);
+
+    if(stop)
+        tft_beep_stop();
+}
+
+void tft_beep_stop(void) {
+    if(timer == NULL)
+        return;
+
+    portENTER_CRITICAL(&lock);
+    flush_queue();
+    portEXIT_CRITICAL(&lock);
+
+    kick(true);
+}
+
+/*
+ * $TFT=BEEP
+ */
+
+status_code_t tft_beep_command(char *args) {
+    char *arg = tft_command_arg(&args);
+
+    if(arg == NULL) {
+        char msg[80];
+        int8_t playing = seq.playing;
+
+        snprintf(msg, sizeof(msg), "[TFTBEEP:%s,queued=%u,played=%u,dropped=%u]" ASCII_EOL,
+                  playing < 0 ? "silent" : patterns[playing].name, (unsigned)seq.count,
+                  (unsigned)seq.played, (unsigned)seq.dropped);
+        hal.stream.write(msg);
+        return Status_OK;
+    }
+
+    if(args)
+        return Status_InvalidStatement;
+
+    if(tft_command_is(arg, "STOP")) {
+        tft_beep_stop();
+        return Status_OK;
+    }
+
+    for(uint_fast8_t i = 0; i < TFT_BEEP_COUNT; i++) {
+        if(tft_command_is(arg, patterns[i].name))
+            return tft_beep_play((tft_beep_pattern_t)i) ? Status_OK : Status_InvalidStatement;
+    }
+
+    return Status_InvalidStatement;
+}
+
+bool tft_beep_init(void) {
+    const esp_timer_create_args_t timer_args = {
+        .callback = beep_timer,
+        .name = "tft_beep"
+    };
+
+    return esp_timer_create(&timer_args, &timer) == ESP_OK;
+}
+
+#endif // TFT_ENABLE && TFT_BEEP_ENABLE
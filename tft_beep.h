@@ -0,0 +1,52 @@
+/*
+ * tft_beep.h - Non-blocking beeper tone sequencer
+ *
+ * Part of grblHAL TFT Plugin
+ *
+ * Copyright (c) 2025
+ *
+ * Patterns are on/off durations played by a one-shot esp_timer, so neither
+ * the caller nor the UI task waits for them. Patterns queue behind each
+ * other, up to TFT_BEEP_QUEUE_SIZE. A touch click is only played when the
+ * beeper is silent. The alarm pattern repeats, preempts anything queued
+ * and blocks other patterns until it is cancelled.
+ */
+
+#ifndef _TFT_BEEP_H_
+#define _TFT_BEEP_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "grbl/hal.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef enum {
+    TFT_BEEP_CLICK = 0,         // Touch feedback
+    TFT_BEEP_CHIME,             // Job complete
+    TFT_BEEP_ALARM,             // Alarm / E-stop, repeats
+    TFT_BEEP_COUNT
+} tft_beep_pattern_t;
+
+// Create the timer, call after tft_driver_init()
+bool tft_beep_init(void);
+
+// Queue a pattern, false if dropped. Any task.
+bool tft_beep_play(tft_beep_pattern_t pattern);
+
+// Silence the beeper if pattern is playing, queued patterns are dropped with it. Any task.
+void tft_beep_cancel(tft_beep_pattern_t pattern);
+
+// Silence the beeper and drop the queue. Any task.
+void tft_beep_stop(void);
+
+// $TFT=BEEP[,CLICK|CHIME|ALARM|STOP]
+status_code_t tft_beep_command(char *args);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // _TFT_BEEP_H_
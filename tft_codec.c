@@ -0,0 +1,170 @@
+/*
+ * tft_codec.c - Checksum and encoding helpers for framebuffer data
+ *
+ * Part of grblHAL TFT Plugin
+ *
+ * Copyright (c) 2025
+ *
+ */
+
+#include "driver.h"
+
+#if TFT_ENABLE
+
+#include <stdio.h>
+
+#include "grbl/hal.h"
+
+#include "tft_config.h"
+#include "tft_codec.h"
+
+// Nibble table keeps the CRC at 64 bytes of flash
+static const uint32_t crc_nibble[16] = {
+    0x00000000, 0x1DB71064, 0x3B6E20C8, 0x26D930AC, 0x76DC4190, 0x6B6B51F4, 0x4DB26158, 0x5005713C,
+    0xEDB88320, 0xF00F9344, 0xD6D6A3E8, 0xCB61B38C, 0x9B64C2B0, 0x86D3D2D4, 0xA00AE278, 0xBDBDF21C
+};
+
+uint32_t tft_crc32(uint32_t crc, const void *data, size_t len) {
+    const uint8_t *p = (const uint8_t *)data;
+
+    crc = ~crc;
+    while(len--) {
+        crc ^= *p++;
+        crc = (crc >> 4) ^ crc_nibble[crc & 0x0F];
+        crc = (crc >> 4) ^ crc_nibble[crc & 0x0F];
+    }
+
+    return ~crc;
+}
+
+// Encoder output, one byte at a time, NULL only counts
+static void (*rle_put)(uint8_t b);
+static uint8_t *rle_out;
+
+static void put_buffer(uint8_t b) {
+    *rle_out++ = b;
+}
+
+static size_t rle16_encode(const uint16_t *pixels, size_t count) {
+    size_t len = 0, i = 0;
+
+#define PUT(b) { if(rle_put) rle_put((uint8_t)(b)); len++; }
+#define PUT_PIXEL(v) { PUT(v); PUT((v) >> 8); }
+
+    while(i < count) {
+        size_t run = 1;
+
+        while(i + run < count && run < 129 && pixels[i + run] == pixels[i])
+            run++;
+
+        if(run >= 2) {
+            PUT(0x7E + run);
+            PUT_PIXEL(pixels[i]);
+            i += run;
+        } else {
+            // Collect literals up to the next run of at least two
+            size_t n = 1;
+
+            while(i + n < count && n < 128 && !(i + n + 1 < count && pixels[i + n] == pixels[i + n + 1]))
+                n++;
+
+            PUT(n - 1);
+            while(n--) {
+                PUT_PIXEL(pixels[i]);
+                i++;
+            }
+        }
+    }
+
+#undef PUT
+#undef PUT_PIXEL
+
+    return len;
+}
+
+size_t tft_rle16_encode(uint8_t *out, const uint16_t *pixels, size_t count) {
+    rle_out = out;
+    rle_put = out ? put_buffer : NULL;
+
+    return rle16_encode(pixels, count);
+}
+
+static const char base64_chars[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+
+size_t tft_base64_encode(char *out, const void *data, size_t len) {
+    const uint8_t *p = (const uint8_t *)data;
+    char *start = out;
+
+    while(len >= 3) {
+        uint32_t v = (p[0] << 16) | (p[1] << 8) | p[2];
+        *out++ = base64_chars[v >> 18];
+        *out++ = base64_chars[(v >> 12) & 0x3F];
+        *out++ = base64_chars[(v >> 6) & 0x3F];
+        *out++ = base64_chars[v & 0x3F];
+        p += 3;
+        len -= 3;
+    }
+
+    if(len) {
+        uint32_t v = (p[0] << 16) | (len == 2 ? p[1] << 8 : 0);
+        *out++ = base64_chars[v >> 18];
+        *out++ = base64_chars[(v >> 12) & 0x3F];
+        *out++ = len == 2 ? base64_chars[(v >> 6) & 0x3F] : '=';
+        *out++ = '=';
+    }
+
+    *out = '\0';
+
+    return out - start;
+}
+
+/*
+ * Area lines, encoded in two passes so no band sized buffer is needed
+ */
+
+static struct {
+    void (*write)(const char *s);
+    const char *tag;
+    size_t sent;
+    uint_fast8_t fill;
+    uint8_t chunk[TFT_CODEC_LINE_BYTES];
+    char line[24 + 4 * ((TFT_CODEC_LINE_BYTES + 2) / 3)];
+} area_out;
+
+static void write_chunk(void) {
+    char *p = area_out.line + sprintf(area_out.line, "[%s:D,", area_out.tag);
+
+    p += tft_base64_encode(p, area_out.chunk, area_out.fill);
+    p += sprintf(p, "]" ASCII_EOL);
+    area_out.write(area_out.line);
+    area_out.sent += p - area_out.line;
+    area_out.fill = 0;
+}
+
+static void put_line(uint8_t b) {
+    area_out.chunk[area_out.fill++] = b;
+    if(area_out.fill == TFT_CODEC_LINE_BYTES)
+        write_chunk();
+}
+
+size_t tft_codec_write_area(void (*write)(const char *s), const char *tag,
+                             int16_t x1, int16_t y1, int16_t x2, int16_t y2, const uint16_t *pixels) {
+    size_t count = (size_t)(x2 - x1 + 1) * (y2 - y1 + 1);
+    size_t len = tft_rle16_encode(NULL, pixels, count);
+
+    area_out.write = write;
+    area_out.tag = tag;
+    area_out.fill = 0;
+    area_out.sent = snprintf(area_out.line, sizeof(area_out.line), "[%s:R,%d,%d,%d,%d,%u]" ASCII_EOL,
+                              tag, x1, y1, x2, y2, (unsigned)len);
+    write(area_out.line);
+
+    rle_put = put_line;
+    rle16_encode(pixels, count);
+    if(area_out.fill)
+        write_chunk();
+
+    return area_out.sent;
+}
+
+#endif // TFT_ENABLE
@@ -0,0 +1,52 @@
+/*
+ * tft_codec.h - Checksum and encoding helpers for framebuffer data
+ *
+ * Part of grblHAL TFT Plugin
+ *
+ * Copyright (c) 2025
+ *
+ */
+
+#ifndef _TFT_CODEC_H_
+#define _TFT_CODEC_H_
+
+#include <stdint.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// CRC-32 (IEEE 802.3), start with crc = 0 and feed data in any chunking
+uint32_t tft_crc32(uint32_t crc, const void *data, size_t len);
+
+/*
+ * RLE for RGB565 pixels. Each packet starts with a control byte n:
+ *   n < 0x80   n + 1 literal pixels follow
+ *   n >= 0x80  one pixel follows, repeated n - 0x7E times (2..129)
+ * Pixels are stored little endian. Worst case output size is
+ * TFT_RLE16_MAX_SIZE(count) bytes, out = NULL returns the size only.
+ */
+#define TFT_RLE16_MAX_SIZE(count) ((count) * 2 + ((count) + 127) / 128)
+
+size_t tft_rle16_encode(uint8_t *out, const uint16_t *pixels, size_t count);
+
+// Base64 (RFC 4648), writes 4 * ((len + 2) / 3) characters plus a terminating NUL
+size_t tft_base64_encode(char *out, const void *data, size_t len);
+
+/*
+ * Send an area as text lines, encoded on the fly:
+ *
+ *   [<tag>:R,<x1>,<y1>,<x2>,<y2>,<bytes>]   inclusive coordinates
+ *   [<tag>:D,<base64>]                      RLE data until <bytes> received
+ *
+ * Returns the number of characters written. UI task only.
+ */
+size_t tft_codec_write_area(void (*write)(const char *s), const char *tag,
+                             int16_t x1, int16_t y1, int16_t x2, int16_t y2, const uint16_t *pixels);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // _TFT_CODEC_H_
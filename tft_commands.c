@@ -0,0 +1,387 @@
+/*
+ * tft_commands.c - $TFT system command for diagnostics and tooling
+ *
+ * Part of grblHAL TFT Plugin
+ *
+ * Copyright (c) 2025
+ *
+ */
+
+#include "driver.h"
+
+#if TFT_ENABLE
+
+#include <stdio.h>
+#include <string.h>
+#include <ctype.h>
+
+#include "grbl/hal.h"
+#include "grbl/system.h"
+
+#include "tft_config.h"
+#include "tft_commands.h"
+#include "tft_profiler.h"
+#include "tft_latency.h"
+#include "tft_trace.h"
+#include "tft_touch_script.h"
+#include "tft_mirror.h"
+#include "tft_remote_input.h"
+#include "tft_screenshot.h"
+#include "tft_throttle.h"
+#include "tft_alarm.h"
+#include "tft_idle.h"
+#include "tft_beep.h"
+#include "tft_stream_tap.h"
+#include "tft_console.h"
+#include "tft_screens.h"
+#include "tft_vlist.h"
+#include "tft_override.h"
+#include "tft_probe.h"
+#include "tft_heightmap.h"
+#include "tft_offsets.h"
+#include "tft_macro.h"
+#include "tft_history.h"
+#include "tft_resume.h"
+#include "tft_events.h"
+#include "tft_strings.h"
+
+typedef status_code_t (*tft_subcommand_ptr)(char *args);
+
+typedef struct {
+    const char *name;
+    tft_subcommand_ptr execute;
+    const char *help;
+} tft_subcommand_t;
+
+static status_code_t cmd_profiler(char *args) {
+#if TFT_PROFILER_ENABLE
+    char *arg = tft_command_arg(&args);
+
+    if(arg == NULL)
+        tft_profiler_report();
+    else if(tft_command_is(arg, "RESET"))
+        tft_profiler_reset();
+    else
+        return Status_InvalidStatement;
+#else
+    hal.stream.write("[TFT:profiler not enabled, set TFT_PROFILER_ENABLE]" ASCII_EOL);
+#endif
+
+    return Status_OK;
+}
+
+static status_code_t cmd_latency(char *args) {
+#if TFT_LATENCY_ENABLE
+    char *arg = tft_command_arg(&args);
+
+    if(arg == NULL)
+        tft_latency_report();
+    else if(tft_command_is(arg, "RESET"))
+        tft_latency_reset();
+    else
+        return Status_InvalidStatement;
+#else
+    hal.stream.write("[TFT:latency measurement not enabled, set TFT_LATENCY_ENABLE]" ASCII_EOL);
+#endif
+
+    return Status_OK;
+}
+
+static status_code_t cmd_trace(char *args) {
+#if TFT_TRACE_ENABLE
+    return tft_trace_command(args);
+#else
+    hal.stream.write("[TFT:trace recorder not enabled, set TFT_TRACE_ENABLE]" ASCII_EOL);
+
+    return Status_OK;
+#endif
+}
+
+static status_code_t cmd_touch(char *args) {
+#if TFT_AUTOMATION_ENABLE
+    return tft_touch_script_command(args);
+#else
+    hal.stream.write("[TFT:touch automation not enabled, set TFT_AUTOMATION_ENABLE]" ASCII_EOL);
+
+    return Status_OK;
+#endif
+}
+
+static status_code_t cmd_bench(char *args) {
+#if TFT_AUTOMATION_ENABLE
+    return tft_bench_command(args);
+#else
+    hal.stream.write("[TFT:screen benchmark not enabled, set TFT_AUTOMATION_ENABLE]" ASCII_EOL);
+
+    return Status_OK;
+#endif
+}
+
+static status_code_t cmd_mirror(char *args) {
+#if TFT_MIRROR_ENABLE
+    return tft_mirror_command(args);
+#else
+    hal.stream.write("[TFT:framebuffer mirror not enabled, set TFT_MIRROR_ENABLE]" ASCII_EOL);
+
+    return Status_OK;
+#endif
+}
+
+static status_code_t cmd_input(char *args) {
+#if TFT_REMOTE_INPUT_ENABLE
+    return tft_remote_input_command(args);
+#else
+    hal.stream.write("[TFT:remote input not enabled, set TFT_REMOTE_INPUT_ENABLE]" ASCII_EOL);
+
+    return Status_OK;
+#endif
+}
+
+static status_code_t cmd_throttle(char *args) {
+#if TFT_THROTTLE_ENABLE
+    return tft_throttle_command(args);
+#else
+    hal.stream.write("[TFT:throttling not enabled, set TFT_THROTTLE_ENABLE]" ASCII_EOL);
+
+    return Status_OK;
+#endif
+}
+
+static status_code_t cmd_idle(char *args) {
+#if TFT_IDLE_ENABLE
+    return tft_idle_command(args);
+#else
+    hal.stream.write("[TFT:idle sleep not enabled, set TFT_IDLE_ENABLE]" ASCII_EOL);
+
+    return Status_OK;
+#endif
+}
+
+static status_code_t cmd_beep(char *args) {
+#if TFT_BEEP_ENABLE
+    return tft_beep_command(args);
+#else
+    hal.stream.write("[TFT:beeper not enabled, set TFT_BEEP_ENABLE]" ASCII_EOL);
+
+    return Status_OK;
+#endif
+}
+
+static status_code_t cmd_stream(char *args) {
+#if TFT_STREAM_TAP_ENABLE
+    return tft_stream_tap_command(args);
+#else
+    hal.stream.write("[TFT:stream tap not enabled, set TFT_STREAM_TAP_ENABLE]" ASCII_EOL);
+
+    return Status_OK;
+#endif
+}
+
+static status_code_t cmd_console(char *args) {
+#if TFT_CONSOLE_ENABLE
+    return tft_console_command(args);
+#else
+    hal.stream.write("[TFT:console not enabled, set TFT_CONSOLE_ENABLE]" ASCII_EOL);
+
+    return Status_OK;
+#endif
+}
+
+static status_code_t cmd_probe(char *args) {
+#if TFT_PROBE_ENABLE
+    return tft_probe_command(args);
+#else
+    hal.stream.write("[TFT:probe wizards not enabled, set TFT_PROBE_ENABLE]" ASCII_EOL);
+
+    return Status_OK;
+#endif
+}
+
+static status_code_t cmd_map(char *args) {
+#if TFT_PROBE_ENABLE
+    return tft_heightmap_command(args);
+#else
+    hal.stream.write("[TFT:probe wizards not enabled, set TFT_PROBE_ENABLE]" ASCII_EOL);
+
+    return Status_OK;
+#endif
+}
+
+static status_code_t cmd_macro(char *args) {
+#if TFT_MACRO_ENABLE
+    return tft_macro_command(args);
+#else
+    hal.stream.write("[TFT:macros not enabled, set TFT_MACRO_ENABLE]" ASCII_EOL);
+
+    return Status_OK;
+#endif
+}
+
+static status_code_t cmd_history(char *args) {
+#if TFT_CHARTS_ENABLE
+    return tft_history_command(args);
+#else
+    hal.stream.write("[TFT:charts not enabled, set TFT_CHARTS_ENABLE]" ASCII_EOL);
+
+    return Status_OK;
+#endif
+}
+
+static status_code_t cmd_resume(char *args) {
+#if TFT_RESUME_ENABLE
+    return tft_resume_command(args);
+#else
+    hal.stream.write("[TFT:resume not enabled, set TFT_RESUME_ENABLE]" ASCII_EOL);
+
+    return Status_OK;
+#endif
+}
+
+static void ui_screen_show(uint32_t id) {
+    tft_screen_show((tft_screen_id_t)id);
+}
+
+static status_code_t cmd_screen(char *args) {
+    char *arg = tft_command_arg(&args);
+    tft_screen_id_t id;
+
+    if(arg == NULL) {
+        for(uint_fast8_t i = 0; i < TFT_SCREEN_COUNT; i++) {
+            hal.stream.write(i == tft_screen_active() ? "[TFTSCREEN:*" : "[TFTSCREEN:");
+            hal.stream.write(tft_screen_name((tft_screen_id_t)i));
+            hal.stream.write("]" ASCII_EOL);
+        }
+        return Status_OK;
+    }
+
+    if(args || !tft_screen_find(arg, &id))
+        return Status_InvalidStatement;
+
+    return tft_ui_call(ui_screen_show, id) ? Status_OK : Status_InvalidStatement;
+}
+
+static void ui_set_language(uint32_t lang) {
+    tft_set_language((tft_lang_id_t)lang);
+}
+
+static status_code_t cmd_lang(char *args) {
+    char *arg = tft_command_arg(&args);
+    tft_lang_id_t lang;
+
+    if(arg == NULL) {
+        for(uint_fast8_t i = 0; i < TFT_LANG_COUNT; i++) {
+            hal.stream.write(i == tft_get_language() ? "[TFTLANG:*" : "[TFTLANG:");
+            hal.stream.write(tft_lang_tables[i].code);
+            hal.stream.write(",");
+            hal.stream.write(tft_lang_tables[i].name);
+            hal.stream.write("]" ASCII_EOL);
+        }
+        return Status_OK;
+    }
+
+    if(args || !tft_find_language(arg, &lang))
+        return Status_InvalidStatement;
+
+    return tft_ui_call(ui_set_language, lang) ? Status_OK : Status_InvalidStatement;
+}
+
+static status_code_t cmd_list(char *args) {
+    char msg[80];
+    const tft_vlist_stats_t *stats = tft_vlist_get_stats();
+
+    if(args)
+        return Status_InvalidStatement;
+
+    snprintf(msg, sizeof(msg), "[TFTLIST:top=%u,rows=%u,binds=%u,scrolls=%u]" ASCII_EOL,
+              (unsigned)tft_vlist_top(), (unsigned)stats->rows, (unsigned)stats->binds, (unsigned)stats->scrolls);
+    hal.stream.write(msg);
+
+    return Status_OK;
+}
+
+static const tft_subcommand_t subcommands[] = {
+    { "PROF", cmd_profiler, "PROF[,RESET] - report or reset UI task profile" },
+    { "LAT", cmd_latency, "LAT[,RESET] - report or reset input to photon latency histogram" },
+    { "TRACE", cmd_trace, "TRACE[,REC|STOP|CLEAR|DUMP|LOAD,<hex>|PLAY[,FAST]] - grblHAL event trace" },
+    { "TOUCH", cmd_touch, "TOUCH[,TAP|LONG|DRAG|WAIT|EXPECT,...|CRC|RUN|CLEAR] - scripted touch input" },
+    { "BENCH", cmd_bench, "BENCH - render every screen, report time and LVGL memory" },
+    { "MIRROR", cmd_mirror, "MIRROR[,ON[,<bytes/s>]|OFF] - stream screen updates to a remote viewer" },
+    { "IN", cmd_input, "IN[,P,x,y[,t]|R[,t]|K,<key>[,t]] - inject remote pointer press/move, release or key" },
+    { "SHOT", tft_screenshot_command, "SHOT - dump active screen as RLE compressed base64 lines" },
+    { "THROTTLE", cmd_throttle, "THROTTLE[,RESET] - report UI throttling mode and time spent in each" },
+    { "ALARM", tft_alarm_command, "ALARM[,RESET] - alarm state change to banner on glass latency" },
+    { "IDLE", cmd_idle, "IDLE[,SLEEP|WAKE|RESET] - idle dim/sleep state, wake latency and skipped frames" },
+    { "BEEP", cmd_beep, "BEEP[,CLICK|CHIME|ALARM|STOP] - beeper sequencer state, play or stop a pattern" },
+    { "STREAM", cmd_stream, "STREAM[,RESET] - output lines classified by the stream tap and its cost per byte" },
+    { "CONSOLE", cmd_console, "CONSOLE[,CLEAR] - console scrollback lines and bytes used, or clear it" },
+    { "SCREEN", cmd_screen, "SCREEN[,<name>] - list screens (* active) or show one" },
+    { "LANG", cmd_lang, "LANG[,<code>] - list languages (* active) or switch the UI to one" },
+    { "LIST", cmd_list, "LIST - recycling list rows and the row text reads and scroll steps since shown" },
+    { "OVR", tft_override_command, "OVR[,FEED|RAPID|SPINDLE,<percent>] - overrides, targets and steps left, or walk one to a target" },
+    { "PROBE", cmd_probe, "PROBE[,Z[,<plate>]|CORNER|TOOL[,REF]|GRID,<w>,<d>,<nx>,<ny>|ABORT] - probe wizard state and results, run or abort one" },
+    { "MAP", cmd_map, "MAP[,DUMP|CLEAR|SAVE,<file>|LOAD,<file>] - probed heightmap, its heights in um, or save/load it" },
+    { "WCO", tft_offsets_command, "WCO - cached work coordinate offset, active system, recomputes and reports served" },
+    { "MACRO", cmd_macro, "MACRO[,SAVE,<slot>,<name>,<line>...|SHOW,<slot>|DELETE,<slot>|RUN,<slot>|ABORT] - stored macros and the run state" },
+    { "HIST", cmd_history, "HIST[,CLEAR] - feed and spindle history buckets per level and the newest min/max, or clear it" },
+    { "RESUME", cmd_resume, "RESUME[,SCAN,<file>|<line>[,RUN]|LAST[,RUN]|ABORT] - scan a file for checkpoints, or write and run it resumed at a line" },
+};
+
+char *tft_command_arg(char **args) {
+    char *arg = *args;
+
+    if(arg == NULL || *arg == '\0')
+        return NULL;
+
+    char *sep = strchr(arg, ',');
+    if(sep) {
+        *sep = '\0';
+        *args = sep + 1;
+    } else
+        *args = NULL;
+
+    return arg;
+}
+
+bool tft_command_is(const char *arg, const char *keyword) {
+    while(*arg && toupper((unsigned char)*arg) == *keyword) {
+        arg++;
+        keyword++;
+    }
+
+    return *arg == '\0' && *keyword == '\0';
+}
+
+static status_code_t tft_command(sys_state_t state, char *args) {
+    char *name = args ? tft_command_arg(&args) : NULL;
+
+    if(name == NULL) {
+        for(uint_fast8_t i = 0; i < sizeof(subcommands) / sizeof(tft_subcommand_t); i++) {
+            hal.stream.write("[TFT:");
+            hal.stream.write(subcommands[i].help);
+            hal.stream.write("]" ASCII_EOL);
+        }
+        return Status_OK;
+    }
+
+    for(uint_fast8_t i = 0; i < sizeof(subcommands) / sizeof(tft_subcommand_t); i++) {
+        if(tft_command_is(name, subcommands[i].name))
+            return subcommands[i].execute(args);
+    }
+
+    return Status_InvalidStatement;
+}
+
+static const sys_command_t tft_command_list[] = {
+    { "TFT", tft_command, { .allow_blocking = On }, { .str = "TFT plugin diagnostics, $TFT lists subcommands" } }
+};
+
+static sys_commands_t tft_commands = {
+    .n_commands = sizeof(tft_command_list) / sizeof(sys_command_t),
+    .commands = tft_command_list
+};
+
+void tft_commands_init(void) {
+    system_register_commands(&tft_commands);
+}
+
+#endif // TFT_ENABLE
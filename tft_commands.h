@@ -0,0 +1,34 @@
+/*
+ * tft_commands.h - $TFT system command for diagnostics and tooling
+ *
+ * Part of grblHAL TFT Plugin
+ *
+ * Copyright (c) 2025
+ *
+ * Usage: $TFT=<subcommand>[,<arg>...]
+ * $TFT without arguments lists the available subcommands.
+ */
+
+#ifndef _TFT_COMMANDS_H_
+#define _TFT_COMMANDS_H_
+
+#include "grbl/hal.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Register $TFT with grblHAL
+void tft_commands_init(void);
+
+// Split next comma separated argument off args (NULL when exhausted)
+char *tft_command_arg(char **args);
+
+// Case insensitive match of argument against keyword
+bool tft_command_is(const char *arg, const char *keyword);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // _TFT_COMMANDS_H_
@@ -23,8 +23,15 @@ extern "C" {
 #define TFT_DISPLAY_HEIGHT      TFT_HEIGHT      // 320 pixels
 #define TFT_DISPLAY_ROTATION    TFT_ROTATION    // 1 = landscape
 
-// LVGL Buffer Configuration
-#define TFT_LVGL_BUFFER_SIZE    LVGL_BUFFER_SIZE    // 4800 pixels (10 rows)
+// LVGL Buffer Configuration, draw buffers come from DMA capable heap
+#ifdef LVGL_BUFFER_SIZE
+#define TFT_LVGL_BUFFER_LINES   (LVGL_BUFFER_SIZE / TFT_WIDTH)  // 10 rows
+#else
+#define TFT_LVGL_BUFFER_LINES   0       // Size from free memory
+#endif
+#define TFT_LVGL_BUFFER_MIN_LINES   4
+#define TFT_LVGL_BUFFER_MAX_LINES   40  // Sized from free memory: at most this many lines
+#define TFT_LVGL_BUFFER_HEAP_PCT    25  // and this share of the largest free DMA block
 #define TFT_LVGL_REFRESH_MS     LVGL_REFRESH_PERIOD // 5ms task cycle
 
 // Display Driver: ST7796
@@ -66,6 +73,8 @@ extern "C" {
     #define TFT_BEEPER_PIN      TFT_BEEP_PIN
     // Beeper macros will be defined in tft_driver.h
 #endif
+#define TFT_BEEP_QUEUE_SIZE     4       // Patterns waiting behind the one playing ($TFT=BEEP)
+#define TFT_BEEP_CLICK_MS       15      // Touch click length
 
 // Touch Controller: XPT2046
 #define TFT_TOUCH_XPT2046       1
@@ -90,14 +99,200 @@ extern "C" {
 #define TFT_TASK_PRIORITY       2       // Moderate priority
 #define TFT_TASK_CORE           0       // Core 0 for UI (Core 1 for motion)
 
+// First id of the runtime settings ($450 - $459), see tft_settings.h.
+// Loop/refresh/touch periods, buffer lines, task priority/core, DMA and
+// idle times are their defaults.
+#ifndef TFT_SETTING_BASE
+#define TFT_SETTING_BASE        Setting_UserDefined_0
+#endif
+
+// Motion aware throttling ($TFT=THROTTLE), periods in ms
+#ifndef TFT_THROTTLE_ENABLE
+#define TFT_THROTTLE_ENABLE     1
+#endif
+#define TFT_THROTTLE_CYCLE_LOOP_MS      20      // Job running: UI loop,
+#define TFT_THROTTLE_CYCLE_REFR_MS      50      // display refresh
+#define TFT_THROTTLE_CYCLE_INDEV_MS     60      // and touch read periods
+#define TFT_THROTTLE_STREAM_LOOP_MS     40      // Job running with busy stream
+#define TFT_THROTTLE_STREAM_REFR_MS     100
+#define TFT_THROTTLE_STREAM_INDEV_MS    100
+#define TFT_THROTTLE_PLANNER_LOW        4       // Stream is busy when the planner has this few free blocks
+#define TFT_THROTTLE_RX_BUSY_PCT        50      // or the receive buffer is this full
+#define TFT_THROTTLE_SETTLE_MS          500     // Stream must stay busy this long before slowing further
+#define TFT_THROTTLE_TOUCH_MS           3000    // Full rate for this long after a touch
+
+// Idle dim and display sleep ($TFT=IDLE), times are the $457 - $459 defaults
+#ifndef TFT_IDLE_ENABLE
+#define TFT_IDLE_ENABLE         1
+#endif
+#define TFT_IDLE_DIM_S          300     // Dim after 5 minutes without touch or state change
+#define TFT_IDLE_SLEEP_S        900     // Backlight off and panel asleep after 15 minutes
+#define TFT_IDLE_DIM_PCT        20      // Dimmed brightness, percent
+#define TFT_IDLE_DIM_FADE_MS    1000    // Fade time when dimming
+#define TFT_IDLE_LOOP_MS        50      // UI loop period while asleep, bounds touch wake latency
+
+// grblHAL output tap, classifies ok/error/ALARM/[MSG:]/[GC:] lines for the UI ($TFT=STREAM)
+#ifndef TFT_STREAM_TAP_ENABLE
+#define TFT_STREAM_TAP_ENABLE   1
+#endif
+#define TFT_STREAM_TEXT_SIZE    512     // Message text ring, bytes, power of 2
+#define TFT_STREAM_TEXT_MAX     80      // Longer message text is truncated
+
+// Recycling list used by the settings, files and console screens ($TFT=LIST)
+#define TFT_VLIST_OVERSCAN      1       // Rows bound ahead above and below the visible ones
+#define TFT_VLIST_ROW_HEIGHT    24      // Settings and file list row pitch, px
+#define TFT_VLIST_TEXT_MAX      64      // Longer row text is cut
+#define TFT_FILES_PATH          "/"     // Directory listed by the files screen
+#define TFT_FILES_MAX           1024    // Entries kept
+#define TFT_FILES_ARENA         (16 * 1024)  // Bytes of names kept, at most 64K
+
+// Console scrollback of grblHAL output (console screen, $TFT=CONSOLE), needs the stream tap
+#ifndef TFT_CONSOLE_ENABLE
+#define TFT_CONSOLE_ENABLE      TFT_STREAM_TAP_ENABLE
+#endif
+#define TFT_CONSOLE_BYTES       4096    // Text ring, power of 2
+#define TFT_CONSOLE_LINES       128     // Line index, power of 2
+#define TFT_CONSOLE_LINE_MAX    80      // Longer lines are truncated
+#define TFT_CONSOLE_ROW_HEIGHT  16      // Console screen row pitch, px
+#define TFT_CONSOLE_REFRESH_MS  100     // Console screen picks up new lines this often
+
+// Override controller, walks feed/rapid/spindle overrides to a target ($TFT=OVR)
+#define TFT_OVERRIDE_STEP_MS    20      // At most one realtime command per override this often
+#define TFT_OVERRIDE_SETTLE_MS  250     // A command not reported as applied by then is planned again
+#define TFT_OVERRIDE_RETRIES    3       // Target dropped after this many in a row
+
+// Probing and tool length wizards ($TFT=PROBE), mm and mm/min
+#ifndef TFT_PROBE_ENABLE
+#define TFT_PROBE_ENABLE        1
+#endif
+#define TFT_PROBE_FAST_FEED     200.0f  // First touch
+#define TFT_PROBE_SLOW_FEED     25.0f   // Second touch, its contact is used
+#define TFT_PROBE_BACKOFF       2.0f    // Retract between the two
+#define TFT_PROBE_TRAVEL        25.0f   // Longest Z touch
+#define TFT_PROBE_CLEARANCE     5.0f    // Retract after a touch, clearance from faces
+#define TFT_PROBE_PLATE         0.0f    // Default touch plate thickness (Z wizard)
+#define TFT_PROBE_TIP_DIAMETER  2.0f    // Probe tip, corner wizard faces
+#define TFT_PROBE_CORNER_INSET  10.0f   // Start position inside the corner, X and Y
+#define TFT_PROBE_CORNER_DEPTH  3.0f    // Faces touched this far below the top
+#define TFT_PROBE_TOOL_X        0.0f    // Tool setter, machine coordinates
+#define TFT_PROBE_TOOL_Y        0.0f
+#define TFT_PROBE_TOOL_SAFE_Z   -1.0f   // Machine Z travelled at
+#define TFT_PROBE_TOOL_TRAVEL   100.0f  // Longest touch down to the setter
+#define TFT_GRID_FEED           50.0f   // Grid points are touched once, at this feed
+#define TFT_GRID_TRAVEL         5.0f    // Furthest a grid point may be below the one before it
+#define TFT_PROBE_TIMEOUT_MS    120000  // Longest touch, moves up to it included
+#define TFT_HEIGHTMAP_POINTS    1024    // Heightmap arena, int16 each
+
+// Work offset table screen
+#define TFT_WCS_ROW_HEIGHT      28      // px
+#define TFT_WCS_REFRESH_MS      500     // Stored offsets are read again this often
+
+// G-code macros stored in NVS ($TFT=MACRO, macros screen)
+#ifndef TFT_MACRO_ENABLE
+#define TFT_MACRO_ENABLE        1
+#endif
+#define TFT_MACRO_SLOTS         8
+#define TFT_MACRO_NAME_LEN      12      // Including the NUL
+#define TFT_MACRO_BYTES         512     // Normalized text of all macros
+#define TFT_MACRO_LINE_MAX      64      // Longest normalized line
+#define TFT_MACRO_REFRESH_MS    200     // Macros screen picks up run progress this often
+
+// Feed rate and spindle speed charts ($TFT=HIST, charts screen)
+#ifndef TFT_CHARTS_ENABLE
+#define TFT_CHARTS_ENABLE       1
+#endif
+#define TFT_HISTORY_SAMPLE_MS   250     // Level 0 bucket
+#define TFT_HISTORY_COLUMNS     240     // Buckets per level, one chart column each
+#define TFT_HISTORY_LEVELS      4       // Window of each level TFT_HISTORY_RATIO times the one below
+#define TFT_HISTORY_RATIO       4
+#define TFT_CHART_HEIGHT        120     // px
+
+// Resume a job from a line, from modal state checkpoints taken by a pre-scan ($TFT=RESUME)
+#ifndef TFT_RESUME_ENABLE
+#define TFT_RESUME_ENABLE       SDCARD_ENABLE
+#endif
+#define TFT_RESUME_INTERVAL     500     // Lines between checkpoints, doubled while the table is full
+#define TFT_RESUME_CHECKPOINTS  128
+#define TFT_RESUME_CHUNK        4096    // File bytes read per UI loop
+#define TFT_RESUME_LINE_MAX     240     // Longest line copied
+#define TFT_RESUME_FILE         "/resume.nc"
+#define TFT_RESUME_SAFE_Z       -1.0f   // Machine Z travelled at, mm
+#define TFT_RESUME_CLEARANCE    2.0f    // Rapid down to this far above the resume point, mm
+#define TFT_RESUME_PLUNGE_FEED  100.0f  // Fastest feed down to the resume point, mm/min
+#define TFT_RESUME_SPINUP_S     3.0f    // Dwell after starting the spindle, s
+
+// Alarm / E-stop banner on the top layer, drawn ahead of anything else ($TFT=ALARM)
+#define TFT_ALARM_OVERLAY_HEIGHT        64
+
+// Event queue between grblHAL hooks and the UI task
+#define TFT_EVENT_QUEUE_SIZE    16      // Events other than realtime reports, the latest of which has a slot of its own
+
+// Command lines queued for the grblHAL parser (tft_send_command)
+#define TFT_INJECT_BYTES        512
+#define TFT_INJECT_RESULTS      16      // Statuses kept of the last lines
+
+// Profiler ($TFT=PROF), compiled out by default
+#ifndef TFT_PROFILER_ENABLE
+#define TFT_PROFILER_ENABLE     0
+#endif
+
+// Input to photon latency histogram ($TFT=LAT), compiled out by default
+#ifndef TFT_LATENCY_ENABLE
+#define TFT_LATENCY_ENABLE      0
+#endif
+#define TFT_LATENCY_TIMEOUT_MS  1000    // Press without a redraw within this time counts as no response
+
+// grblHAL event trace recorder/replayer ($TFT=TRACE), compiled out by default
+#ifndef TFT_TRACE_ENABLE
+#define TFT_TRACE_ENABLE        0
+#endif
+#define TFT_TRACE_BUFFER_SIZE   (8 * 1024)  // Bytes, about 2 minutes of 5 Hz reports while moving
+#define TFT_TRACE_DUMP_BYTES    64          // Trace bytes per $TFT=TRACE,DUMP line
+
+// Scripted touch automation and screen benchmark ($TFT=TOUCH, $TFT=BENCH), compiled out by default
+#ifndef TFT_AUTOMATION_ENABLE
+#define TFT_AUTOMATION_ENABLE   0
+#endif
+#define TFT_TOUCH_SCRIPT_STEPS  32      // Queued script steps
+#define TFT_TOUCH_TAP_MS        100     // Press time of a tap
+#define TFT_TOUCH_LONG_MS       1000    // Default long press time
+#define TFT_TOUCH_DRAG_MS       300     // Default drag time
+#define TFT_TOUCH_RELEASE_MS    100     // Released time after each gesture
+#define TFT_BENCH_PASSES        3       // Full screen refreshes averaged per screen
+
+// RLE bytes per base64 line of screen data (mirror and screenshot), 96 gives 128 characters
+#define TFT_CODEC_LINE_BYTES    96
+
+// Remote framebuffer mirror ($TFT=MIRROR), compiled out by default
+#ifndef TFT_MIRROR_ENABLE
+#define TFT_MIRROR_ENABLE       0
+#endif
+#define TFT_MIRROR_RATE         20000   // Default output limit, bytes per second
+#define TFT_MIRROR_TX_BACKLOG   256     // Hold output while the stream has more than this queued
+#define TFT_MIRROR_TX_BUFFER    1024    // Stream TX buffer, a flush writes no more than its free space
+
+// Remote pointer and key injection ($TFT=IN), compiled out by default
+#ifndef TFT_REMOTE_INPUT_ENABLE
+#define TFT_REMOTE_INPUT_ENABLE 0
+#endif
+#define TFT_REMOTE_QUEUE_SIZE   16      // Pointer and key events each
+#define TFT_REMOTE_HOLDOFF_MS   500     // Remote input ignored this long after a physical touch
+
 // Splash Screen Timing
-#define TFT_SPLASH_BACKLIGHT_DELAY_MS   500     // Turn on backlight after 500ms
-#define TFT_SPLASH_DURATION_MS          2000    // Show splash for 2 seconds
+#define TFT_SPLASH_BACKLIGHT_DELAY_MS   500     // Start breathing after 500ms
+#define TFT_SPLASH_DURATION_MS          2000    // Show splash for 2 seconds, then fade to full
+#define TFT_SPLASH_BREATHE_MS           500     // Breathing, dark to full in this time and back
+
+// Localization (0 = Chinese, 1 = English, 2 = German, see lang/*.txt)
+#ifndef TFT_LANGUAGE_DEFAULT
+#define TFT_LANGUAGE_DEFAULT    1
+#endif
+#define TFT_STR_MAX_BINDINGS    32      // Labels relabeled on language switch
 
-// Breathing Effect Configuration
-#define TFT_BREATHING_STEP      15      // PWM step size
-#define TFT_BREATHING_MIN       0       // Minimum brightness
-#define TFT_BREATHING_MAX       255     // Maximum brightness
+// Backlight fades, run from an esp_timer (tft_fade.h)
+#define TFT_BACKLIGHT_GAMMA     2.2f    // Perceived brightness 0-255 to PWM duty
+#define TFT_FADE_TICK_MS        10      // Fade timer period
+#define TFT_FADE_MS             300     // Default fade time
 
 #ifdef __cplusplus
 }
@@ -0,0 +1,205 @@
+/*
+ * tft_console.c - Console scrollback of grblHAL output
+ *
+ * Part of grblHAL TFT Plugin
+ *
+ * Copyright (c) 2025
+ *
+ */
+
+#include "driver.h"
+#include "tft_config.h"
+
+#if TFT_ENABLE && TFT_CONSOLE_ENABLE
+
+#include <stdio.h>
+#include <string.h>
+
+#include "grbl/hal.h"
+
+#include "tft_commands.h"
+#include "tft_stream_tap.h"
+#include "tft_console.h"
+
+#define BYTES_MASK (TFT_CONSOLE_BYTES - 1)
+#define LINES_MASK (TFT_CONSOLE_LINES - 1)
+
+#if (TFT_CONSOLE_BYTES & BYTES_MASK) || (TFT_CONSOLE_LINES & LINES_MASK)
+#error "TFT_CONSOLE_BYTES and TFT_CONSOLE_LINES must be powers of 2"
+#endif
+
+#if TFT_CONSOLE_LINE_MAX > 255 || TFT_CONSOLE_LINE_MAX > TFT_CONSOLE_BYTES
+#error "TFT_CONSOLE_LINE_MAX out of range"
+#endif
+
+typedef struct {
+    uint32_t pos;               // Byte position of the text, from boot
+    uint8_t len;
+    int8_t kind;                // tft_stream_kind_t or -1
+} line_t;
+
+static struct {
+    char text[TFT_CONSOLE_BYTES];
+    line_t lines[TFT_CONSOLE_LINES];
+    uint32_t head;              // Byte position after the last committed line
+    uint32_t first, end;        // Lines kept are first to end - 1
+    uint32_t evicted;
+} con;
+
+// Line being appended, writing task only
+static struct {
+    uint32_t pos;
+    uint8_t len;
+    bool started;
+    bool skip;                  // Realtime report or empty
+} pending;
+
+static portMUX_TYPE lock = portMUX_INITIALIZER_UNLOCKED;
+static tft_stream_line_ptr line_sink;
+
+// Drop lines starting before pos, called with the lock held
+static void evict(uint32_t pos) {
+    while(con.first != con.end && (int32_t)(con.lines[con.first & LINES_MASK].pos - pos) < 0) {
+        con.first++;
+        con.evicted++;
+    }
+}
+
+static void append(const char *s, size_t len) {
+    uint32_t pos = pending.pos + pending.len;
+    size_t n = TFT_CONSOLE_BYTES - (pos & BYTES_MASK);
+
+    if(n > len)
+        n = len;
+
+    portENTER_CRITICAL(&lock);
+    evict(pos + len - TFT_CONSOLE_BYTES);
+    memcpy(&con.text[pos & BYTES_MASK], s, n);
+    memcpy(con.text, s + n, len - n);
+    portEXIT_CRITICAL(&lock);
+
+    pending.len += len;
+}
+
+static void commit(int8_t kind) {
+    portENTER_CRITICAL(&lock);
+
+    if(con.end - con.first == TFT_CONSOLE_LINES) {
+        con.first++;
+        con.evicted++;
+    }
+
+    line_t *line = &con.lines[con.end & LINES_MASK];
+    line->pos = pending.pos;
+    line->len = pending.len;
+    line->kind = kind;
+    con.end++;
+    con.head = pending.pos + pending.len;
+
+    portEXIT_CRITICAL(&lock);
+}
+
+static void console_line(const char *s, size_t len, int8_t kind, bool eol) {
+    if(line_sink)
+        line_sink(s, len, kind, eol);
+
+    if(!pending.started) {
+        pending.started = true;
+        pending.skip = len && *s == '<';
+        pending.pos = con.head;
+        pending.len = 0;
+    }
+
+    if(!pending.skip) {
+        if(len && s[len - 1] == '\r')
+            len--;
+
+        if(len > (size_t)(TFT_CONSOLE_LINE_MAX - pending.len))
+            len = TFT_CONSOLE_LINE_MAX - pending.len;
+
+        if(len)
+            append(s, len);
+
+        if(eol && pending.len)
+            commit(kind);
+    }
+
+    if(eol)
+        pending.started = false;
+}
+
+uint32_t tft_console_first(void) {
+    return con.first;
+}
+
+uint32_t tft_console_end(void) {
+    return con.end;
+}
+
+bool tft_console_line(uint32_t n, char *buf, size_t size, int8_t *kind) {
+    bool ok;
+
+    portENTER_CRITICAL(&lock);
+
+    if((ok = n - con.first < con.end - con.first)) {
+        const line_t *line = &con.lines[n & LINES_MASK];
+        size_t len = line->len < size ? line->len : size - 1;
+
+        for(size_t i = 0; i < len; i++)
+            buf[i] = con.text[(line->pos + i) & BYTES_MASK];
+        buf[len] = '\0';
+
+        if(kind)
+            *kind = line->kind;
+    }
+
+    portEXIT_CRITICAL(&lock);
+
+    if(!ok)
+        *buf = '\0';
+
+    return ok;
+}
+
+/*
+ * $TFT=CONSOLE
+ */
+
+status_code_t tft_console_command(char *args) {
+    char *arg = tft_command_arg(&args);
+
+    if(arg == NULL) {
+        char msg[128];
+        uint32_t first, end, bytes;
+
+        portENTER_CRITICAL(&lock);
+        first = con.first;
+        end = con.end;
+        bytes = first == end ? 0 : con.head - con.lines[first & LINES_MASK].pos;
+        portEXIT_CRITICAL(&lock);
+
+        snprintf(msg, sizeof(msg), "[TFTCONSOLE:first=%u,end=%u,lines=%u/%u,bytes=%u/%u,evicted=%u]" ASCII_EOL,
+                  (unsigned)first, (unsigned)end, (unsigned)(end - first), TFT_CONSOLE_LINES,
+                  (unsigned)bytes, TFT_CONSOLE_BYTES, (unsigned)con.evicted);
+        hal.stream.write(msg);
+        return Status_OK;
+    }
+
+    if(args)
+        return Status_InvalidStatement;
+
+    if(tft_command_is(arg, "CLEAR")) {
+        portENTER_CRITICAL(&lock);
+        con.first = con.end;
+        portEXIT_CRITICAL(&lock);
+        return Status_OK;
+    }
+
+    return Status_InvalidStatement;
+}
+
+void tft_console_init(void) {
+    line_sink = tft_stream_tap_set_line_sink(console_line);
+}
+
+#endif // TFT_ENABLE && TFT_CONSOLE_ENABLE
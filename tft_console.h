@@ -0,0 +1,47 @@
+/*
+ * tft_console.h - Console scrollback of grblHAL output
+ *
+ * Part of grblHAL TFT Plugin
+ *
+ * Copyright (c) 2025
+ *
+ * Output lines handed over by the stream tap are appended to a fixed
+ * TFT_CONSOLE_BYTES byte ring with a TFT_CONSOLE_LINES entry line index.
+ * Appending is O(1) and evicts the oldest lines, so memory never grows.
+ * Lines are numbered from boot; the console screen reads the visible ones
+ * by number. Realtime reports (<...>) are left out.
+ */
+
+#ifndef _TFT_CONSOLE_H_
+#define _TFT_CONSOLE_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include "grbl/hal.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Attach to the stream tap, call after tft_stream_tap_init()
+void tft_console_init(void);
+
+// Number of the oldest line kept
+uint32_t tft_console_first(void);
+
+// Number of the next line to be appended
+uint32_t tft_console_end(void);
+
+// Copy line n, NUL terminated, false if evicted or not appended yet.
+// kind is the tft_stream_kind_t of the line, or -1. Any task.
+bool tft_console_line(uint32_t n, char *buf, size_t size, int8_t *kind);
+
+// $TFT=CONSOLE[,CLEAR]
+status_code_t tft_console_command(char *args);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // _TFT_CONSOLE_H_
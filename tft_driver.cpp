@@ -13,18 +13,14 @@
 #include <TFT_eSPI.h>
 #include "tft_config.h"
 #include "tft_driver.h"
+#include "tft_fade.h"
 
 #if TFT_ENABLE
 
 // TFT_eSPI instance (global, used by lvgl_init.cpp)
 TFT_eSPI tft = TFT_eSPI();
 
-// Backlight state
-static struct {
-    uint8_t level;              // Current brightness (0-255)
-    uint8_t breathing_value;    // Breathing effect counter
-    bool breathing_up;          // Breathing direction
-} backlight_state = {0};
+static void backlight_write(uint32_t duty);
 
 /*
  * Initialize TFT display hardware
@@ -33,6 +29,7 @@ void tft_driver_init(void) {
     // Initialize backlight PWM
     ledcSetup(TFT_BACKLIGHT_CHANNEL, TFT_BACKLIGHT_FREQ, TFT_BACKLIGHT_BITS);
     ledcAttachPin(TFT_PIN_BL, TFT_BACKLIGHT_CHANNEL);
+    tft_fade_init(backlight_write, TFT_BACKLIGHT_MAX);
 
     // Turn off backlight initially
     tft_backlight_off();
@@ -59,12 +56,7 @@ void tft_driver_init(void) {
  * Backlight Control Functions
  */
 
-void tft_set_backlight(uint8_t level) {
-    backlight_state.level = level;
-
-    // Map 0-255 to PWM duty cycle
-    uint32_t duty = (uint32_t)level * TFT_BACKLIGHT_MAX / 255;
-
+static void backlight_write(uint32_t duty) {
 #ifdef USE_BOARD_V2_0
     // V2.0 boards: backlight is active LOW
     duty = TFT_BACKLIGHT_MAX - duty;
@@ -73,6 +65,10 @@ void tft_set_backlight(uint8_t level) {
     ledcWrite(TFT_BACKLIGHT_CHANNEL, duty);
 }
 
+void tft_set_backlight(uint8_t level) {
+    tft_fade_set(level);
+}
+
 void tft_backlight_on(uint8_t level) {
     tft_set_backlight(level);
 }
@@ -81,27 +77,16 @@ void tft_backlight_off(void) {
     tft_set_backlight(0);
 }
 
-bool tft_backlight_breathing(void) {
-    // Breathing effect: fade in and out
-    if(backlight_state.breathing_up) {
-        backlight_state.breathing_value += TFT_BREATHING_STEP;
-        if(backlight_state.breathing_value >= TFT_BREATHING_MAX) {
-            backlight_state.breathing_value = TFT_BREATHING_MAX;
-            backlight_state.breathing_up = false;
-        }
-    } else {
-        if(backlight_state.breathing_value > TFT_BREATHING_STEP) {
-            backlight_state.breathing_value -= TFT_BREATHING_STEP;
-        } else {
-            backlight_state.breathing_value = TFT_BREATHING_MIN;
-            backlight_state.breathing_up = true;
-            // One full cycle complete
-            return true;
-        }
-    }
-
-    tft_set_backlight(backlight_state.breathing_value);
-    return false;
+uint8_t tft_get_backlight(void) {
+    return tft_fade_level();
+}
+
+void tft_backlight_fade(uint8_t level, uint32_t ms) {
+    tft_fade_to(level, ms);
+}
+
+void tft_backlight_breathe(uint8_t low, uint8_t high, uint32_t ms) {
+    tft_fade_breathe(low, high, ms);
 }
 
 /*
@@ -126,15 +111,24 @@ void tft_beeper_off(void) {
     digitalWrite(TFT_BEEPER_PIN, LOW);
 }
 
-void tft_beep_touch(void) {
-    // Quick beep for touch feedback
-    // This is called from touch callback
-    // Actual timing controlled by LVGL/touch driver
-    tft_beeper_on();
-}
-
 #endif // TFT_BEEP_ENABLE
 
+/*
+ * Panel Sleep
+ */
+
+void tft_display_sleep(bool sleep) {
+#if TFT_USE_DMA
+    tft.dmaWait();
+#endif
+
+    tft.writecommand(sleep ? TFT_SLPIN : TFT_SLPOUT);
+
+    // SLPOUT: supply and clock need 5 ms before the next command
+    if(!sleep)
+        delay(5);
+}
+
 /*
  * Display Information
  */
@@ -34,7 +34,7 @@ void tft_driver_init(void);
  * Backlight Control
  */
 
-// Set backlight brightness (0-255)
+// Set backlight brightness (0-255), gamma corrected, ends a running fade
 // 0 = off, 255 = full brightness
 void tft_set_backlight(uint8_t level);
 
@@ -44,9 +44,14 @@ void tft_backlight_on(uint8_t level);
 // Turn backlight off
 void tft_backlight_off(void);
 
-// Breathing effect for startup (call repeatedly)
-// Returns true when breathing cycle is complete
-bool tft_backlight_breathing(void);
+// Current brightness (0-255), follows a running fade
+uint8_t tft_get_backlight(void);
+
+// Fade to level in ms, returns at once (timer driven, see tft_fade.h)
+void tft_backlight_fade(uint8_t level, uint32_t ms);
+
+// Breathing effect for startup, runs until the next set or fade
+void tft_backlight_breathe(uint8_t low, uint8_t high, uint32_t ms);
 
 /*
  * Beeper Control
@@ -63,11 +68,18 @@ void tft_beeper_on(void);
 // Turn beeper off
 void tft_beeper_off(void);
 
-// Quick beep for touch feedback (non-blocking)
-void tft_beep_touch(void);
+// Timed patterns are played by the sequencer in tft_beep.h
 
 #endif // TFT_BEEP_ENABLE
 
+/*
+ * Panel Sleep
+ */
+
+// ST7796 sleep in (SLPIN) or out (SLPOUT), frame memory is kept.
+// Waking blocks for the 5 ms the panel needs before the next command.
+void tft_display_sleep(bool sleep);
+
 /*
  * Display Information
  */
@@ -0,0 +1,100 @@
+/*
+ * tft_events.c - grblHAL to UI task event queue
+ *
+ * Part of grblHAL TFT Plugin
+ *
+ * Copyright (c) 2025
+ *
+ */
+
+#include "driver.h"
+
+#if TFT_ENABLE
+
+#include "tft_config.h"
+#include "tft_events.h"
+
+static QueueHandle_t queue = NULL;
+static tft_event_stats_t stats = {0};
+
+// Realtime reports only matter as the latest one, they keep a slot of their own
+// so a burst of them never crowds state, probe, stream and call events out
+static portMUX_TYPE report_lock = portMUX_INITIALIZER_UNLOCKED;
+static tft_event_t report;
+static bool report_pending = false;
+
+bool tft_events_init(void) {
+    if(queue == NULL)
+        queue = xQueueCreate(TFT_EVENT_QUEUE_SIZE, sizeof(tft_event_t));
+
+    return queue != NULL;
+}
+
+bool tft_event_try_post(const tft_event_t *evt) {
+    if(evt->type == TFT_EVT_REPORT) {
+        portENTER_CRITICAL(&report_lock);
+        if(report_pending)
+            stats.coalesced++;
+        report = *evt;
+        report_pending = true;
+        stats.posted++;
+        portEXIT_CRITICAL(&report_lock);
+
+        return true;
+    }
+
+    if(queue == NULL || xQueueSend(queue, evt, 0) != pdTRUE)
+        return false;
+
+    UBaseType_t depth = uxQueueMessagesWaiting(queue);
+
+    stats.posted++;
+    if(depth > stats.max_depth)
+        stats.max_depth = depth;
+
+    return true;
+}
+
+bool tft_event_post(const tft_event_t *evt) {
+    bool ok = tft_event_try_post(evt);
+
+    if(!ok)
+        stats.dropped++;
+
+    return ok;
+}
+
+bool tft_event_get(tft_event_t *evt) {
+    bool ok;
+
+    if(queue != NULL && xQueueReceive(queue, evt, 0) == pdTRUE)
+        return true;
+
+    portENTER_CRITICAL(&report_lock);
+    if((ok = report_pending)) {
+        *evt = report;
+        report_pending = false;
+    }
+    portEXIT_CRITICAL(&report_lock);
+
+    return ok;
+}
+
+bool tft_ui_call(void (*fn)(uint32_t arg), uint32_t arg) {
+    tft_event_t evt = { .type = TFT_EVT_CALL };
+
+    evt.call.fn = fn;
+    evt.call.arg = arg;
+
+    return tft_event_post(&evt);
+}
+
+uint32_t tft_events_pending(void) {
+    return (queue ? uxQueueMessagesWaiting(queue) : 0) + (report_pending ? 1 : 0);
+}
+
+const tft_event_stats_t *tft_events_get_stats(void) {
+    return &stats;
+}
+
+#endif // TFT_ENABLE
@@ -0,0 +1,101 @@
+/*
+ * tft_events.h - grblHAL to UI task event queue
+ *
+ * Part of grblHAL TFT Plugin
+ *
+ * Copyright (c) 2025
+ *
+ * grblHAL hooks run in the grblHAL task and must not touch LVGL. They post
+ * compact events here, the UI task drains the queue once per loop.
+ */
+
+#ifndef _TFT_EVENTS_H_
+#define _TFT_EVENTS_H_
+
+#include "grbl/hal.h"
+#include "grbl/system.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef enum {
+    TFT_EVT_STATE = 0,          // Machine state changed
+    TFT_EVT_REPORT,             // Realtime report (position, feed)
+    TFT_EVT_PROGRAM,            // Program completed
+    TFT_EVT_RESET,              // Soft reset
+    TFT_EVT_CALL,               // Run function in UI task (not traced)
+    TFT_EVT_STREAM,             // error, ALARM, [MSG:] or [GC:] line sent to the host (not traced)
+    TFT_EVT_PROBE,              // Probe cycle completed (not traced)
+    TFT_EVT_COUNT
+} tft_event_type_t;
+
+typedef struct {
+    uint8_t type;               // tft_event_type_t
+    union {
+        struct {
+            sys_state_t state;
+            alarm_code_t alarm;
+        } state;
+        struct {
+            float mpos[N_AXIS];
+            float wpos[N_AXIS];
+            float feed_rate;
+            float spindle_rpm;  // Not traced
+            uint32_t line_number;   // Not traced
+        } report;
+        struct {
+            uint8_t flow;       // program_flow_t
+            bool check_mode;
+        } program;
+        struct {
+            void (*fn)(uint32_t arg);
+            uint32_t arg;
+        } call;
+        struct {
+            uint8_t kind;       // tft_stream_kind_t
+            uint8_t len;        // Text length
+            uint16_t code;      // error/alarm code
+            uint32_t text;      // Text position, see tft_stream_tap_text()
+        } stream;
+        struct {
+            float mpos[N_AXIS]; // Contact point, machine coordinates
+            bool ok;
+        } probe;
+    };
+} tft_event_t;
+
+typedef struct {
+    uint32_t posted;
+    uint32_t dropped;           // Queue full
+    uint32_t coalesced;         // Realtime reports replaced by a newer one before being taken
+    uint32_t max_depth;
+} tft_event_stats_t;
+
+// Create queue, call before any hook is attached
+bool tft_events_init(void);
+
+// Post event without blocking, returns false (and counts a drop) if the queue is full.
+// A realtime report replaces one not taken yet instead, it is never dropped.
+bool tft_event_post(const tft_event_t *evt);
+
+// Post event without blocking, a full queue is not counted as a drop
+bool tft_event_try_post(const tft_event_t *evt);
+
+// Fetch next event (UI task), the latest realtime report after the queued events.
+// Returns false if none pending.
+bool tft_event_get(tft_event_t *evt);
+
+// Run fn(arg) in the UI task, for callers outside it that need LVGL access
+bool tft_ui_call(void (*fn)(uint32_t arg), uint32_t arg);
+
+// Events currently queued
+uint32_t tft_events_pending(void);
+
+const tft_event_stats_t *tft_events_get_stats(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // _TFT_EVENTS_H_
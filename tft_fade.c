@@ -0,0 +1,151 @@
+/*
+ * tft_fade.c - Gamma corrected backlight fade engine
+ *
+ * Part of grblHAL TFT Plugin
+ *
+ * Copyright (c) 2025
+ *
+ */
+
+#include "driver.h"
+
+#if TFT_ENABLE
+
+#include <math.h>
+
+#include "esp_timer.h"
+
+#include "tft_config.h"
+#include "tft_fade.h"
+
+static struct {
+    tft_fade_write_ptr write;
+    uint8_t level;              // Last level written
+    uint8_t from, to;
+    uint32_t start_ms;
+    uint32_t ms;                // Fade time, each way when breathing
+    bool breathe;
+    bool running;
+} fade;
+
+static uint16_t gamma_lut[256];
+static esp_timer_handle_t timer = NULL;
+static portMUX_TYPE lock = portMUX_INITIALIZER_UNLOCKED;
+
+static uint32_t now_ms(void) {
+    return (uint32_t)(esp_timer_get_time() / 1000);
+}
+
+static void fade_timer(void *arg) {
+    tft_fade_step(now_ms());
+}
+
+// One shot, rearmed by each step while a fade runs, so a fade started while
+// the last step of the previous one ends is never left without a timer
+static void timer_arm(void) {
+    if(timer && !esp_timer_is_active(timer))
+        esp_timer_start_once(timer, TFT_FADE_TICK_MS * 1000ULL);
+}
+
+// Called with the lock held, so a step computed before a tft_fade_set() can
+// not overwrite the level it sets. The write is a LEDC register update.
+static void write_level(uint8_t level) {
+    if(fade.write)
+        fade.write(gamma_lut[level]);
+}
+
+uint32_t tft_fade_duty(uint8_t level) {
+    return gamma_lut[level];
+}
+
+void tft_fade_step(uint32_t now) {
+    uint8_t level;
+    bool running;
+
+    portENTER_CRITICAL(&lock);
+
+    if(!fade.running) {
+        portEXIT_CRITICAL(&lock);
+        return;
+    }
+
+    uint32_t t = now - fade.start_ms;
+
+    if(fade.breathe) {
+        // Triangle wave, from to to and back
+        t %= 2 * fade.ms;
+        if(t >= fade.ms)
+            t = 2 * fade.ms - t;
+    } else if(t >= fade.ms) {
+        t = fade.ms;
+        fade.running = false;
+    }
+
+    level = (uint8_t)((int32_t)fade.from + ((int32_t)fade.to - fade.from) * (int32_t)t / (int32_t)fade.ms);
+    if(level != fade.level) {
+        fade.level = level;
+        write_level(level);
+    }
+    running = fade.running;
+
+    portEXIT_CRITICAL(&lock);
+
+    if(running)
+        timer_arm();
+}
+
+static void fade_start(uint8_t from, uint8_t to, uint32_t ms, bool breathe) {
+    portENTER_CRITICAL(&lock);
+    fade.from = from;
+    fade.to = to;
+    fade.ms = ms ? ms : 1;
+    fade.start_ms = now_ms();
+    fade.breathe = breathe;
+    fade.running = true;
+    portEXIT_CRITICAL(&lock);
+
+    timer_arm();
+}
+
+void tft_fade_set(uint8_t level) {
+    portENTER_CRITICAL(&lock);
+    fade.running = false;
+    fade.level = level;
+    write_level(level);
+    portEXIT_CRITICAL(&lock);
+}
+
+void tft_fade_to(uint8_t level, uint32_t ms) {
+    if(ms == 0)
+        tft_fade_set(level);
+    else
+        fade_start(fade.level, level, ms, false);
+}
+
+void tft_fade_breathe(uint8_t low, uint8_t high, uint32_t ms) {
+    fade_start(low, high, ms, true);
+}
+
+uint8_t tft_fade_level(void) {
+    return fade.level;
+}
+
+bool tft_fade_running(void) {
+    return fade.running;
+}
+
+bool tft_fade_init(tft_fade_write_ptr write, uint32_t max_duty) {
+    const esp_timer_create_args_t args = {
+        .callback = fade_timer,
+        .name = "tft_fade"
+    };
+
+    fade.write = write;
+
+    for(uint_fast16_t i = 0; i < 256; i++)
+        gamma_lut[i] = (uint16_t)(powf(i / 255.0f, TFT_BACKLIGHT_GAMMA) * max_duty + 0.5f);
+
+    return esp_timer_create(&args, &timer) == ESP_OK;
+}
+
+#endif // TFT_ENABLE
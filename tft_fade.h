@@ -0,0 +1,58 @@
+/*
+ * tft_fade.h - Gamma corrected backlight fade engine
+ *
+ * Part of grblHAL TFT Plugin
+ *
+ * Copyright (c) 2025
+ *
+ * Levels are perceived brightness 0-255, mapped to PWM duty through a
+ * TFT_BACKLIGHT_GAMMA lookup table, so a linear fade in level looks linear.
+ * Fades and breathing run from an esp_timer every TFT_FADE_TICK_MS, the
+ * calls below return at once and cost the UI task nothing.
+ *
+ * The engine only talks to the hardware through the write callback given
+ * to tft_fade_init(), and tft_fade_step() can be called with any clock, so
+ * it can be run on the host against a mocked LEDC.
+ */
+
+#ifndef _TFT_FADE_H_
+#define _TFT_FADE_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Write PWM duty, 0 to max_duty
+typedef void (*tft_fade_write_ptr)(uint32_t duty);
+
+// Build the gamma table for max_duty and create the timer, level starts at 0 (not written)
+bool tft_fade_init(tft_fade_write_ptr write, uint32_t max_duty);
+
+// Set level now, ends a running fade. Any task.
+void tft_fade_set(uint8_t level);
+
+// Fade from the current level to level in ms. Any task.
+void tft_fade_to(uint8_t level, uint32_t ms);
+
+// Fade between low and high and back, ms each way, until the next set or fade. Any task.
+void tft_fade_breathe(uint8_t low, uint8_t high, uint32_t ms);
+
+// Current level
+uint8_t tft_fade_level(void);
+
+bool tft_fade_running(void);
+
+// Advance a running fade, called by the timer
+void tft_fade_step(uint32_t now_ms);
+
+// Duty for a level
+uint32_t tft_fade_duty(uint8_t level);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // _TFT_FADE_H_
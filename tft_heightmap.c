@@ -0,0 +1,302 @@
+/*
+ * tft_heightmap.c - Probed surface height grid
+ *
+ * Part of grblHAL TFT Plugin
+ *
+ * Copyright (c) 2025
+ *
+ */
+
+#include "driver.h"
+#include "tft_config.h"
+
+#if TFT_ENABLE && TFT_PROBE_ENABLE
+
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+
+#include "grbl/hal.h"
+#if SDCARD_ENABLE
+#include "grbl/vfs.h"
+#endif
+
+#include "tft_commands.h"
+#include "tft_events.h"
+#include "tft_heightmap.h"
+#include "tft_probe.h"
+
+static tft_heightmap_t map;
+static int16_t z_um[TFT_HEIGHTMAP_POINTS];
+static void (*listener)(int16_t ix, int16_t iy) = NULL;
+
+static void notify(int16_t ix, int16_t iy) {
+    if(listener)
+        listener(ix, iy);
+}
+
+// The grid wizard writes the map point by point
+static bool grid_running(void) {
+    const tft_probe_status_t *probe = tft_probe_get_status();
+
+    return probe->wizard == TFT_PROBE_GRID && (probe->state == TFT_PROBE_FAST || probe->state == TFT_PROBE_SLOW);
+}
+
+static void clear(void) {
+    for(uint_fast16_t i = 0; i < TFT_HEIGHTMAP_POINTS; i++)
+        z_um[i] = TFT_HEIGHTMAP_NONE;
+
+    map.probed = 0;
+    map.min = map.max = 0;
+}
+
+bool tft_heightmap_begin(uint8_t nx, uint8_t ny, float x0, float y0, float dx, float dy) {
+    if(nx == 0 || ny == 0 || nx * ny > TFT_HEIGHTMAP_POINTS)
+        return false;
+
+    clear();
+    map.nx = nx;
+    map.ny = ny;
+    map.x0 = x0;
+    map.y0 = y0;
+    map.dx = dx;
+    map.dy = dy;
+    map.zref = 0.0f;
+
+    notify(-1, -1);
+
+    return true;
+}
+
+void tft_heightmap_set(uint8_t ix, uint8_t iy, float z) {
+    if(ix >= map.nx || iy >= map.ny)
+        return;
+
+    if(map.probed == 0)
+        map.zref = z;
+
+    // um, kept clear of the not probed marker
+    float um = roundf((z - map.zref) * 1000.0f);
+    int16_t v = um > INT16_MAX ? INT16_MAX : (um < -INT16_MAX ? -INT16_MAX : (int16_t)um);
+    bool grown = map.probed == 0 || v < map.min || v > map.max;
+    int16_t *p = &z_um[iy * map.nx + ix];
+
+    if(*p == TFT_HEIGHTMAP_NONE)
+        map.probed++;
+    *p = v;
+
+    if(map.probed == 1 || v < map.min)
+        map.min = v;
+    if(map.probed == 1 || v > map.max)
+        map.max = v;
+
+    // The colour scale follows the range, a wider one recolours every point
+    if(grown && map.probed > 1)
+        notify(-1, -1);
+    else
+        notify(ix, iy);
+}
+
+int16_t tft_heightmap_get(uint8_t ix, uint8_t iy) {
+    return ix < map.nx && iy < map.ny ? z_um[iy * map.nx + ix] : TFT_HEIGHTMAP_NONE;
+}
+
+const tft_heightmap_t *tft_heightmap_get_info(void) {
+    return &map;
+}
+
+void tft_heightmap_set_listener(void (*changed)(int16_t ix, int16_t iy)) {
+    listener = changed;
+}
+
+/*
+ * SD card files
+ */
+
+#if SDCARD_ENABLE
+
+static void put_f32(uint8_t *p, float v) {
+    memcpy(p, &v, sizeof(float));
+}
+
+static float get_f32(const uint8_t *p) {
+    float v;
+
+    memcpy(&v, p, sizeof(float));
+
+    return v;
+}
+
+static status_code_t map_save(const char *filename) {
+    uint8_t hdr[TFT_HEIGHTMAP_HDR_SIZE];
+    size_t n = map.nx * map.ny;
+    vfs_file_t *file;
+
+    if(map.nx == 0)
+        return Status_InvalidStatement;
+
+    memcpy(hdr, TFT_HEIGHTMAP_MAGIC, 4);
+    hdr[4] = TFT_HEIGHTMAP_VERSION;
+    hdr[5] = map.nx;
+    hdr[6] = map.ny;
+    hdr[7] = 0;
+    put_f32(&hdr[8], map.x0);
+    put_f32(&hdr[12], map.y0);
+    put_f32(&hdr[16], map.dx);
+    put_f32(&hdr[20], map.dy);
+    put_f32(&hdr[24], map.zref);
+
+    if((file = vfs_open(filename, "w")) == NULL)
+        return Status_FileOpenFailed;
+
+    bool ok = vfs_write(hdr, 1, sizeof(hdr), file) == sizeof(hdr) &&
+               vfs_write(z_um, sizeof(int16_t), n, file) == n;
+
+    vfs_close(file);
+
+    return ok ? Status_OK : Status_FileOpenFailed;
+}
+
+static char load_path[64];
+
+static status_code_t map_load(const char *filename) {
+    uint8_t hdr[TFT_HEIGHTMAP_HDR_SIZE];
+    size_t n;
+    vfs_file_t *file;
+
+    if((file = vfs_open(filename, "r")) == NULL)
+        return Status_FileOpenFailed;
+
+    if(vfs_read(hdr, 1, sizeof(hdr), file) != sizeof(hdr) || memcmp(hdr, TFT_HEIGHTMAP_MAGIC, 4) ||
+        hdr[4] != TFT_HEIGHTMAP_VERSION || hdr[5] == 0 || hdr[6] == 0 || hdr[5] * hdr[6] > TFT_HEIGHTMAP_POINTS) {
+        vfs_close(file);
+        return Status_InvalidStatement;
+    }
+
+    clear();
+    n = hdr[5] * hdr[6];
+
+    if(vfs_read(z_um, sizeof(int16_t), n, file) != n) {
+        vfs_close(file);
+        clear();
+        map.nx = map.ny = 0;
+        return Status_InvalidStatement;
+    }
+
+    vfs_close(file);
+
+    map.nx = hdr[5];
+    map.ny = hdr[6];
+    map.x0 = get_f32(&hdr[8]);
+    map.y0 = get_f32(&hdr[12]);
+    map.dx = get_f32(&hdr[16]);
+    map.dy = get_f32(&hdr[20]);
+    map.zref = get_f32(&hdr[24]);
+
+    for(uint_fast16_t i = 0; i < n; i++) {
+        if(z_um[i] != TFT_HEIGHTMAP_NONE) {
+            if(map.probed == 0 || z_um[i] < map.min)
+                map.min = z_um[i];
+            if(map.probed == 0 || z_um[i] > map.max)
+                map.max = z_um[i];
+            map.probed++;
+        }
+    }
+
+    notify(-1, -1);
+
+    return Status_OK;
+}
+
+// UI task, the map is drawn and probed into there
+static void ui_map_load(uint32_t arg) {
+    status_code_t status = grid_running() ? Status_IdleError : map_load(load_path);
+
+    if(status != Status_OK) {
+        char msg[64];
+
+        snprintf(msg, sizeof(msg), "[MSG:TFT heightmap not loaded, error %u]" ASCII_EOL, (unsigned)status);
+        hal.stream.write(msg);
+    }
+}
+
+#endif // SDCARD_ENABLE
+
+/*
+ * $TFT=MAP
+ */
+
+static void map_dump(void) {
+    char msg[16];
+
+    for(uint_fast8_t iy = 0; iy < map.ny; iy++) {
+        hal.stream.write("[TFTMAP:");
+        for(uint_fast8_t ix = 0; ix < map.nx; ix++) {
+            int16_t v = z_um[iy * map.nx + ix];
+            if(v == TFT_HEIGHTMAP_NONE)
+                strcpy(msg, ix ? ",-" : "-");
+            else
+                snprintf(msg, sizeof(msg), ix ? ",%d" : "%d", (int)v);
+            hal.stream.write(msg);
+        }
+        hal.stream.write("]" ASCII_EOL);
+    }
+}
+
+static void ui_map_clear(uint32_t arg) {
+    if(grid_running())
+        return;
+
+    clear();
+    map.nx = map.ny = 0;
+    notify(-1, -1);
+}
+
+status_code_t tft_heightmap_command(char *args) {
+    char *arg = tft_command_arg(&args);
+
+    if(arg == NULL) {
+        char msg[128];
+
+        snprintf(msg, sizeof(msg), "[TFTMAP:%ux%u,probed=%u,origin=%.3f,%.3f,step=%.3f,%.3f,zref=%.3f,min=%d,max=%d]" ASCII_EOL,
+                  (unsigned)map.nx, (unsigned)map.ny, (unsigned)map.probed, map.x0, map.y0, map.dx, map.dy, map.zref,
+                  (int)map.min, (int)map.max);
+        hal.stream.write(msg);
+
+        return Status_OK;
+    }
+
+    if(tft_command_is(arg, "DUMP")) {
+        if(args)
+            return Status_InvalidStatement;
+        map_dump();
+        return Status_OK;
+    }
+
+    if(tft_command_is(arg, "CLEAR")) {
+        if(grid_running())
+            return Status_IdleError;
+        return args == NULL && tft_ui_call(ui_map_clear, 0) ? Status_OK : Status_InvalidStatement;
+    }
+
+#if SDCARD_ENABLE
+    if(tft_command_is(arg, "SAVE"))
+        return args && *args ? map_save(args) : Status_InvalidStatement;
+
+    if(tft_command_is(arg, "LOAD")) {
+        if(args == NULL || *args == '\0' || strlen(args) >= sizeof(load_path))
+            return Status_InvalidStatement;
+        if(grid_running())
+            return Status_IdleError;
+
+        // Loaded by the UI task, errors are reported as a message
+        strcpy(load_path, args);
+
+        return tft_ui_call(ui_map_load, 0) ? Status_OK : Status_InvalidStatement;
+    }
+#endif
+
+    return Status_InvalidStatement;
+}
+
+#endif // TFT_ENABLE && TFT_PROBE_ENABLE
@@ -0,0 +1,68 @@
+/*
+ * tft_heightmap.h - Probed surface height grid
+ *
+ * Part of grblHAL TFT Plugin
+ *
+ * Copyright (c) 2025
+ *
+ * Heights are kept in a static arena of TFT_HEIGHTMAP_POINTS int16 values,
+ * micrometres relative to the first point probed, so a grid costs no heap
+ * and survives screen changes. Filled by the grid probe wizard, drawn by
+ * the heightmap screen, which is told about each point as it arrives.
+ *
+ * File format ($TFT=MAP,SAVE / LOAD), little endian:
+ *
+ *   'T' 'F' 'H' 'M'  version:u8  nx:u8  ny:u8  reserved:u8
+ *   x0  y0  dx  dy  zref: f32     machine coordinates of point 0,0, spacing,
+ *                                 machine Z the heights are relative to
+ *   z_um[ny][nx]: i16             row by row, TFT_HEIGHTMAP_NONE if not probed
+ */
+
+#ifndef _TFT_HEIGHTMAP_H_
+#define _TFT_HEIGHTMAP_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "grbl/hal.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define TFT_HEIGHTMAP_MAGIC     "TFHM"
+#define TFT_HEIGHTMAP_VERSION   1
+#define TFT_HEIGHTMAP_HDR_SIZE  28
+#define TFT_HEIGHTMAP_NONE      INT16_MIN
+
+typedef struct {
+    uint8_t nx, ny;             // Points, 0 when there is no grid
+    float x0, y0;               // Point 0,0, machine coordinates
+    float dx, dy;               // Spacing
+    float zref;                 // Machine Z of height 0
+    uint16_t probed;            // Points with a height
+    int16_t min, max;           // Lowest and highest height, um
+} tft_heightmap_t;
+
+// Start a new grid of nx x ny points, false if it does not fit the arena
+bool tft_heightmap_begin(uint8_t nx, uint8_t ny, float x0, float y0, float dx, float dy);
+
+// Store the machine Z probed at point ix, iy. The first point sets zref.
+void tft_heightmap_set(uint8_t ix, uint8_t iy, float z);
+
+// Height at point ix, iy in um, TFT_HEIGHTMAP_NONE if not probed
+int16_t tft_heightmap_get(uint8_t ix, uint8_t iy);
+
+const tft_heightmap_t *tft_heightmap_get_info(void);
+
+// Called in the UI task with the point changed, or -1, -1 when all may have
+// (new grid, range grown or a grid loaded). NULL to detach.
+void tft_heightmap_set_listener(void (*changed)(int16_t ix, int16_t iy));
+
+// $TFT=MAP[,DUMP|CLEAR|SAVE,<file>|LOAD,<file>]
+status_code_t tft_heightmap_command(char *args);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // _TFT_HEIGHTMAP_H_
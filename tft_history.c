@@ -0,0 +1,217 @@
+/*
+ * tft_history.c - Feed rate and spindle speed history
+ *
+ * Part of grblHAL TFT Plugin
+ *
+ * Copyright (c) 2025
+ *
+ */
+
+#include "driver.h"
+#include "tft_config.h"
+
+#if TFT_ENABLE && TFT_CHARTS_ENABLE
+
+#include <stdio.h>
+#include <string.h>
+
+#include "grbl/hal.h"
+
+#include "tft_commands.h"
+#include "tft_events.h"
+#include "tft_history.h"
+
+static tft_history_bucket_t ring[TFT_HISTORY_COUNT][TFT_HISTORY_LEVELS][TFT_HISTORY_COLUMNS];
+
+static struct {
+    uint16_t head[TFT_HISTORY_LEVELS];
+    uint16_t count[TFT_HISTORY_LEVELS];
+    tft_history_bucket_t open[TFT_HISTORY_COUNT][TFT_HISTORY_LEVELS];
+    uint8_t merged[TFT_HISTORY_LEVELS]; // Buckets in the open one, levels above 0
+    bool added;                 // Level 0 bucket got a report
+    uint16_t last[TFT_HISTORY_COUNT];   // Last reported values, for buckets without a report
+    uint32_t due_ms;            // Level 0 bucket closes
+    bool started;
+} hist;
+
+static tft_history_listener_ptr listener;
+
+static const tft_history_bucket_t empty = { .min = UINT16_MAX, .max = 0 };
+
+static uint16_t clamp(float v) {
+    return v <= 0.0f ? 0 : v >= (float)UINT16_MAX ? UINT16_MAX : (uint16_t)(v + 0.5f);
+}
+
+static void merge(tft_history_bucket_t *into, const tft_history_bucket_t *b) {
+    if(b->min < into->min)
+        into->min = b->min;
+    if(b->max > into->max)
+        into->max = b->max;
+}
+
+// Empty rings and open buckets, keep the last values
+static void reset(void) {
+    uint16_t last[TFT_HISTORY_COUNT];
+
+    memcpy(last, hist.last, sizeof(last));
+    memset(&hist, 0, sizeof(hist));
+    memcpy(hist.last, last, sizeof(last));
+
+    for(uint_fast8_t s = 0; s < TFT_HISTORY_COUNT; s++) {
+        for(uint_fast8_t level = 0; level < TFT_HISTORY_LEVELS; level++)
+            hist.open[s][level] = empty;
+    }
+}
+
+void tft_history_add(float feed, float rpm) {
+    tft_history_bucket_t b;
+
+    // Open buckets are set up by the first tick
+    if(!hist.started)
+        return;
+
+    hist.last[TFT_HISTORY_FEED] = clamp(feed);
+    hist.last[TFT_HISTORY_SPINDLE] = clamp(rpm);
+
+    for(uint_fast8_t s = 0; s < TFT_HISTORY_COUNT; s++) {
+        b.min = b.max = hist.last[s];
+        merge(&hist.open[s][0], &b);
+    }
+
+    hist.added = true;
+}
+
+// Close the open level 0 bucket, and the levels above it that fill up
+static void close_buckets(uint16_t *closed) {
+    if(!hist.added)
+        tft_history_add(hist.last[TFT_HISTORY_FEED], hist.last[TFT_HISTORY_SPINDLE]);
+    hist.added = false;
+
+    for(uint_fast8_t level = 0; level < TFT_HISTORY_LEVELS; level++) {
+        uint16_t head = hist.head[level];
+
+        for(uint_fast8_t s = 0; s < TFT_HISTORY_COUNT; s++) {
+            ring[s][level][head] = hist.open[s][level];
+            if(level + 1 < TFT_HISTORY_LEVELS)
+                merge(&hist.open[s][level + 1], &hist.open[s][level]);
+            hist.open[s][level] = empty;
+        }
+
+        hist.head[level] = head + 1 == TFT_HISTORY_COLUMNS ? 0 : head + 1;
+        if(hist.count[level] < TFT_HISTORY_COLUMNS)
+            hist.count[level]++;
+        if(closed[level] < TFT_HISTORY_COLUMNS)
+            closed[level]++;
+
+        // The level above closes after TFT_HISTORY_RATIO of these
+        if(level + 1 == TFT_HISTORY_LEVELS || ++hist.merged[level + 1] < TFT_HISTORY_RATIO)
+            break;
+        hist.merged[level + 1] = 0;
+    }
+}
+
+void tft_history_tick(uint32_t now_ms) {
+    uint16_t closed[TFT_HISTORY_LEVELS] = {0};
+    uint_fast16_t n = 0;
+
+    if(!hist.started) {
+        reset();
+        hist.started = true;
+        hist.due_ms = now_ms + TFT_HISTORY_SAMPLE_MS;
+        return;
+    }
+
+    // A stalled UI loop catches up, but fills at most one ring
+    while((int32_t)(now_ms - hist.due_ms) >= 0) {
+        if(n++ < TFT_HISTORY_COLUMNS)
+            close_buckets(closed);
+        hist.due_ms += TFT_HISTORY_SAMPLE_MS;
+    }
+
+    if(n && listener)
+        listener(closed);
+}
+
+void tft_history_clear(void) {
+    uint16_t closed[TFT_HISTORY_LEVELS];
+
+    reset();                    // Started again by the next tick
+
+    for(uint_fast8_t level = 0; level < TFT_HISTORY_LEVELS; level++)
+        closed[level] = TFT_HISTORY_COLUMNS;
+
+    if(listener)
+        listener(closed);
+}
+
+uint16_t tft_history_head(uint8_t level) {
+    return level < TFT_HISTORY_LEVELS ? hist.head[level] : 0;
+}
+
+uint16_t tft_history_count(uint8_t level) {
+    return level < TFT_HISTORY_LEVELS ? hist.count[level] : 0;
+}
+
+const tft_history_bucket_t *tft_history_at(tft_history_series_t series, uint8_t level, uint16_t index) {
+    if(series >= TFT_HISTORY_COUNT || level >= TFT_HISTORY_LEVELS || index >= TFT_HISTORY_COLUMNS)
+        return NULL;
+
+    // Filled from the head back
+    uint16_t age = (hist.head[level] + TFT_HISTORY_COLUMNS - 1 - index) % TFT_HISTORY_COLUMNS;
+
+    return age < hist.count[level] ? &ring[series][level][index] : NULL;
+}
+
+uint32_t tft_history_span_ms(uint8_t level) {
+    uint32_t ms = TFT_HISTORY_SAMPLE_MS;
+
+    while(level--)
+        ms *= TFT_HISTORY_RATIO;
+
+    return ms;
+}
+
+void tft_history_set_listener(tft_history_listener_ptr cb) {
+    listener = cb;
+}
+
+/*
+ * $TFT=HIST
+ */
+
+static void ui_history_clear(uint32_t arg) {
+    tft_history_clear();
+}
+
+status_code_t tft_history_command(char *args) {
+    char *arg = tft_command_arg(&args), msg[96];
+
+    if(arg) {
+        if(args == NULL && tft_command_is(arg, "CLEAR"))
+            return tft_ui_call(ui_history_clear, 0) ? Status_OK : Status_InvalidStatement;
+
+        return Status_InvalidStatement;
+    }
+
+    for(uint_fast8_t level = 0; level < TFT_HISTORY_LEVELS; level++) {
+        uint16_t newest = (hist.head[level] + TFT_HISTORY_COLUMNS - 1) % TFT_HISTORY_COLUMNS;
+        const tft_history_bucket_t *feed = tft_history_at(TFT_HISTORY_FEED, level, newest),
+                                   *rpm = tft_history_at(TFT_HISTORY_SPINDLE, level, newest);
+
+        snprintf(msg, sizeof(msg), "[TFTHIST:%u,window_s=%u,buckets=%u/%u", (unsigned)level,
+                  (unsigned)(tft_history_span_ms(level) * TFT_HISTORY_COLUMNS / 1000), (unsigned)hist.count[level],
+                  (unsigned)TFT_HISTORY_COLUMNS);
+        if(feed && rpm)
+            sprintf(strchr(msg, '\0'), ",feed=%u-%u,rpm=%u-%u", (unsigned)feed->min, (unsigned)feed->max,
+                     (unsigned)rpm->min, (unsigned)rpm->max);
+        strcat(msg, "]" ASCII_EOL);
+        hal.stream.write(msg);
+    }
+
+    snprintf(msg, sizeof(msg), "[TFTHIST:bytes=%u]" ASCII_EOL, (unsigned)(sizeof(ring) + sizeof(hist)));
+    hal.stream.write(msg);
+
+    return Status_OK;
+}
+
+#endif // TFT_ENABLE && TFT_CHARTS_ENABLE
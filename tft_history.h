@@ -0,0 +1,76 @@
+/*
+ * tft_history.h - Feed rate and spindle speed history
+ *
+ * Part of grblHAL TFT Plugin
+ *
+ * Copyright (c) 2025
+ *
+ * Every realtime report widens the open level 0 bucket, a min/max pair
+ * per series, and every TFT_HISTORY_SAMPLE_MS the bucket is closed into a
+ * ring of TFT_HISTORY_COLUMNS. A closed bucket is merged into the open
+ * bucket of the next level, which closes after TFT_HISTORY_RATIO of them,
+ * and so on up: each level covers RATIO times the time of the one below
+ * in the same number of buckets. Closing costs O(1) amortized, and memory
+ * is fixed whatever the window.
+ *
+ * With the defaults the levels span 1, 4, 16 and 64 minutes. UI task only.
+ */
+
+#ifndef _TFT_HISTORY_H_
+#define _TFT_HISTORY_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "grbl/hal.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef enum {
+    TFT_HISTORY_FEED = 0,       // mm/min
+    TFT_HISTORY_SPINDLE,        // RPM
+    TFT_HISTORY_COUNT
+} tft_history_series_t;
+
+typedef struct {
+    uint16_t min;
+    uint16_t max;
+} tft_history_bucket_t;
+
+// Called with the buckets each level closed, TFT_HISTORY_LEVELS counts, after a stall
+// up to TFT_HISTORY_COLUMNS. A clear passes TFT_HISTORY_COLUMNS for every level.
+typedef void (*tft_history_listener_ptr)(const uint16_t *closed);
+
+// Add a reported feed rate and spindle speed to the open bucket
+void tft_history_add(float feed, float rpm);
+
+// Close the buckets due by now, call every UI loop
+void tft_history_tick(uint32_t now_ms);
+
+// Forget everything
+void tft_history_clear(void);
+
+// Ring index the next bucket of level goes to
+uint16_t tft_history_head(uint8_t level);
+
+// Buckets of level closed, up to TFT_HISTORY_COLUMNS
+uint16_t tft_history_count(uint8_t level);
+
+// Bucket at ring index of level, NULL if not closed yet
+const tft_history_bucket_t *tft_history_at(tft_history_series_t series, uint8_t level, uint16_t index);
+
+// Time covered by one bucket of level, ms
+uint32_t tft_history_span_ms(uint8_t level);
+
+// Set the listener, NULL to remove it
+void tft_history_set_listener(tft_history_listener_ptr listener);
+
+// $TFT=HIST[,CLEAR]
+status_code_t tft_history_command(char *args);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // _TFT_HISTORY_H_
@@ -0,0 +1,214 @@
+/*
+ * tft_idle.c - Idle dim and display sleep
+ *
+ * Part of grblHAL TFT Plugin
+ *
+ * Copyright (c) 2025
+ *
+ */
+
+#include "driver.h"
+#include "tft_config.h"
+
+#if TFT_ENABLE && TFT_IDLE_ENABLE
+
+#include <stdio.h>
+
+#include "esp_timer.h"
+#include "grbl/hal.h"
+#include "grbl/state_machine.h"
+
+#include "tft_commands.h"
+#include "tft_driver.h"
+#include "tft_events.h"
+#include "tft_settings.h"
+#include "tft_idle.h"
+#include "lvgl_init.h"
+
+static const char *const level_names[] = { "active", "dim", "sleep" };
+
+// UI task state
+static struct {
+    tft_idle_level_t level;
+    sys_state_t state;
+    uint32_t activity_ms;       // Last touch, state change or wake
+    uint8_t brightness;         // Restored on wake
+    bool swallow;               // Waking touch, hidden from LVGL until released
+    bool waking;                // Backlight comes on with the first flush
+    uint32_t wake_us;
+    uint32_t skipped_base;      // lvgl_skipped_frames() when the counters were reset
+} idle;
+
+static struct {
+    uint32_t sleeps;
+    uint32_t wakes;
+    uint32_t last_us;           // Wake to first flush
+    uint32_t max_us;
+    uint32_t no_frame;          // Wakes without a flush within TFT_LATENCY_TIMEOUT_MS
+} stats;
+
+static lvgl_touch_filter_ptr touch_filter;
+static lvgl_flush_tap_ptr flush_tap;
+
+static void backlight_restore(void) {
+    idle.waking = false;
+    tft_set_backlight(idle.brightness);
+}
+
+static void idle_flush_tap(const lv_area_t *area, const lv_color_t *pixels) {
+    if(flush_tap)
+        flush_tap(area, pixels);
+
+    if(idle.waking) {
+        uint32_t us = (uint32_t)esp_timer_get_time() - idle.wake_us;
+
+        stats.last_us = us;
+        if(us > stats.max_us)
+            stats.max_us = us;
+        backlight_restore();
+    }
+}
+
+static bool idle_touch_filter(bool touched, uint16_t *x, uint16_t *y) {
+    if(touch_filter)
+        touched = touch_filter(touched, x, y);
+
+    if(touched) {
+        if(idle.level != TFT_IDLE_ACTIVE) {
+            idle.swallow = true;
+            tft_idle_wake();
+        }
+        idle.activity_ms = hal.get_elapsed_ticks();
+    }
+
+    if(idle.swallow) {
+        if(!touched)
+            idle.swallow = false;
+        return false;
+    }
+
+    return touched;
+}
+
+static void idle_dim(void) {
+    idle.brightness = tft_get_backlight();
+    idle.level = TFT_IDLE_DIM;
+    tft_backlight_fade((uint32_t)idle.brightness * tft_settings.idle_dim_pct / 100, TFT_IDLE_DIM_FADE_MS);
+}
+
+static void idle_sleep(void) {
+    if(idle.level == TFT_IDLE_ACTIVE)
+        idle.brightness = tft_get_backlight();
+
+    idle.level = TFT_IDLE_SLEEP;
+    idle.waking = false;
+    stats.sleeps++;
+
+    tft_backlight_off();
+    lvgl_display_sleep();
+    tft_display_sleep(true);
+}
+
+void tft_idle_wake(void) {
+    idle.activity_ms = hal.get_elapsed_ticks();
+
+    if(idle.level == TFT_IDLE_SLEEP) {
+        idle.wake_us = (uint32_t)esp_timer_get_time();
+        idle.waking = true;
+        stats.wakes++;
+
+        tft_display_sleep(false);
+        if(!lvgl_display_wake())
+            hal.stream.write("[MSG:TFT draw buffer allocation failed on wake]" ASCII_EOL);
+    } else if(idle.level == TFT_IDLE_DIM)
+        tft_set_backlight(idle.brightness);
+
+    idle.level = TFT_IDLE_ACTIVE;
+}
+
+uint32_t tft_idle_update(sys_state_t state, uint32_t now_ms, uint32_t loop_ms) {
+    // A full refresh ($TFT=BENCH, SHOT, TOUCH CRC) woke LVGL behind our back,
+    // wake the panel too and draw a frame for the backlight to come on with
+    if(idle.level == TFT_IDLE_SLEEP && !lvgl_display_asleep()) {
+        lv_obj_invalidate(lv_scr_act());
+        tft_idle_wake();
+    }
+
+    // Anything but a quiet idle machine keeps the display on
+    if(state != idle.state) {
+        idle.state = state;
+        tft_idle_wake();
+    } else if(state != STATE_IDLE)
+        idle.activity_ms = now_ms;
+
+    if(idle.waking && (uint32_t)esp_timer_get_time() - idle.wake_us > TFT_LATENCY_TIMEOUT_MS * 1000UL) {
+        stats.no_frame++;
+        backlight_restore();
+    }
+
+    uint32_t idle_s = (now_ms - idle.activity_ms) / 1000;
+
+    if(idle.level != TFT_IDLE_SLEEP && tft_settings.idle_sleep_s && idle_s >= tft_settings.idle_sleep_s)
+        idle_sleep();
+    else if(idle.level == TFT_IDLE_ACTIVE && tft_settings.idle_dim_s && idle_s >= tft_settings.idle_dim_s)
+        idle_dim();
+
+    return idle.level == TFT_IDLE_SLEEP && loop_ms < TFT_IDLE_LOOP_MS ? TFT_IDLE_LOOP_MS : loop_ms;
+}
+
+tft_idle_level_t tft_idle_level(void) {
+    return idle.level;
+}
+
+/*
+ * $TFT=IDLE
+ */
+
+static void ui_idle_sleep(uint32_t arg) {
+    if(idle.level != TFT_IDLE_SLEEP)
+        idle_sleep();
+}
+
+static void ui_idle_wake(uint32_t arg) {
+    tft_idle_wake();
+}
+
+status_code_t tft_idle_command(char *args) {
+    char *arg = tft_command_arg(&args);
+
+    if(arg == NULL) {
+        char msg[128];
+        snprintf(msg, sizeof(msg), "[TFTIDLE:%s,sleeps=%u,wakes=%u,last_wake_us=%u,max_wake_us=%u,no_frame=%u,skipped=%u]" ASCII_EOL,
+                  level_names[idle.level], (unsigned)stats.sleeps, (unsigned)stats.wakes, (unsigned)stats.last_us,
+                  (unsigned)stats.max_us, (unsigned)stats.no_frame, (unsigned)(lvgl_skipped_frames() - idle.skipped_base));
+        hal.stream.write(msg);
+        return Status_OK;
+    }
+
+    if(args)
+        return Status_InvalidStatement;
+
+    if(tft_command_is(arg, "SLEEP"))
+        return tft_ui_call(ui_idle_sleep, 0) ? Status_OK : Status_InvalidStatement;
+
+    if(tft_command_is(arg, "WAKE"))
+        return tft_ui_call(ui_idle_wake, 0) ? Status_OK : Status_InvalidStatement;
+
+    if(tft_command_is(arg, "RESET")) {
+        stats.sleeps = stats.wakes = stats.last_us = stats.max_us = stats.no_frame = 0;
+        idle.skipped_base = lvgl_skipped_frames();
+        return Status_OK;
+    }
+
+    return Status_InvalidStatement;
+}
+
+void tft_idle_init(void) {
+    idle.level = TFT_IDLE_ACTIVE;
+    idle.activity_ms = hal.get_elapsed_ticks();
+
+    touch_filter = lvgl_set_touch_filter(idle_touch_filter);
+    flush_tap = lvgl_set_flush_tap(idle_flush_tap);
+}
+
+#endif // TFT_ENABLE && TFT_IDLE_ENABLE
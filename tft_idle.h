@@ -0,0 +1,54 @@
+/*
+ * tft_idle.h - Idle dim and display sleep
+ *
+ * Part of grblHAL TFT Plugin
+ *
+ * Copyright (c) 2025
+ *
+ * While the machine is idle and nobody touches the panel the backlight is
+ * dimmed after $457 seconds. After $458 seconds it is switched off, the
+ * ST7796 is put to sleep, LVGL stops rendering and the draw buffers are
+ * freed. A touch, any state change or an alarm wakes the display; the
+ * touch that wakes it is not passed on to the UI. The backlight comes back
+ * with the first flushed area, the time from wake to that flush is
+ * measured. $TFT=IDLE reports it together with the frames skipped while
+ * asleep. A full screen refresh wakes LVGL on its own, the next update
+ * sees that and wakes the panel as well.
+ */
+
+#ifndef _TFT_IDLE_H_
+#define _TFT_IDLE_H_
+
+#include <stdint.h>
+#include "grbl/hal.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef enum {
+    TFT_IDLE_ACTIVE = 0,
+    TFT_IDLE_DIM,
+    TFT_IDLE_SLEEP
+} tft_idle_level_t;
+
+// Install touch filter and flush tap, call once after lvgl_init() and the other input filters
+void tft_idle_init(void);
+
+// Back to full brightness and rendering, UI task
+void tft_idle_wake(void);
+
+// Run the idle timers for the machine state, any change of state wakes the display.
+// Returns the UI loop period, loop_ms unless asleep. UI task, outside lv_task_handler().
+uint32_t tft_idle_update(sys_state_t state, uint32_t now_ms, uint32_t loop_ms);
+
+tft_idle_level_t tft_idle_level(void);
+
+// $TFT=IDLE[,SLEEP|WAKE|RESET]
+status_code_t tft_idle_command(char *args);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // _TFT_IDLE_H_
@@ -20,17 +20,124 @@
 #include "grbl/system.h"
 #include "grbl/settings.h"
 
+#include "tft_config.h"
 #include "tft_interface.h"
+#include "tft_stream_tap.h"
+#include "tft_override.h"
 
 /*
  * Command Injection
+ *
+ * Lines are queued here and read by the grblHAL parser through a hook on
+ * hal.stream.read, only between host lines. One line is read at a time and
+ * the status it gets is trapped: not reported to the host, kept for
+ * tft_command_status() instead.
  */
 
-void tft_send_command(const char *cmd) {
-    hal.stream.write(cmd);
+static portMUX_TYPE inject_lock = portMUX_INITIALIZER_UNLOCKED;
+
+static struct {
+    char buf[TFT_INJECT_BYTES];     // Queued lines, each \n terminated
+    uint16_t head, tail;
+    uint32_t queued;                // Lines queued, the ticket of the last one
+    volatile uint32_t done;         // Lines that got their status
+    bool awaiting;                  // A line has been read, its status is next
+    bool host_line;                 // The host is part way through a line
+    bool host_cr;                   // The host line ended with CR, its LF may follow
+    bool split_crlf;                // A line was read between the host's CR and LF
+    status_code_t result[TFT_INJECT_RESULTS];
+} inject;
+
+static stream_read_ptr read_orig;
+static status_message_ptr status_message;
+static on_stream_changed_ptr on_stream_changed;
+
+static int32_t inject_read(void) {
+    int32_t c = SERIAL_NO_DATA;
+
+    portENTER_CRITICAL(&inject_lock);
+    if(!inject.host_line && !inject.awaiting && inject.tail != inject.head) {
+        c = (uint8_t)inject.buf[inject.tail];
+        inject.tail = (inject.tail + 1) % TFT_INJECT_BYTES;
+        inject.awaiting = c == '\n';
+        inject.split_crlf |= inject.host_cr;
+        inject.host_cr = false;
+    }
+    portEXIT_CRITICAL(&inject_lock);
+
+    // Lines are queued whole, once started a line is read to its end before the host again
+    if(c != SERIAL_NO_DATA)
+        return c;
+
+    if((c = read_orig()) == SERIAL_NO_DATA)
+        return c;
+
+    // The parser pairs LF with the CR before it, after a line read in between it
+    // would end an empty line and the host would get an extra ok
+    if(inject.split_crlf) {
+        inject.split_crlf = false;
+        if(c == '\n' && (c = read_orig()) == SERIAL_NO_DATA)
+            return c;
+    }
+
+    inject.host_line = !(c == '\n' || c == '\r');
+    inject.host_cr = c == '\r';
+
+    return c;
+}
+
+static status_code_t inject_status(status_code_t status_code) {
+    if(!inject.awaiting)
+        return status_message ? status_message(status_code) : status_code;
+
+    inject.result[(inject.done + 1) % TFT_INJECT_RESULTS] = status_code;
+    inject.awaiting = false;
+    inject.done++;
+
+    return status_code;
+}
+
+// grblHAL replaces hal.stream on a stream change, attach again
+static void inject_attach(void) {
+    if(hal.stream.read && hal.stream.read != inject_read) {
+        read_orig = hal.stream.read;
+        hal.stream.read = inject_read;
+    }
+}
+
+static void inject_stream_changed(stream_type_t type) {
+    if(on_stream_changed)
+        on_stream_changed(type);
+
+    inject_attach();
+}
+
+uint32_t tft_send_command(const char *cmd) {
+    size_t len = strlen(cmd);
+    bool eol = len && cmd[len - 1] == '\n';
+    uint32_t lines = eol ? 0 : 1, ticket = 0;
+
+    for(size_t i = 0; i < len; i++)
+        lines += cmd[i] == '\n';
+
+    portENTER_CRITICAL(&inject_lock);
+    if(len && len + (eol ? 0 : 1) <= (size_t)((inject.tail + TFT_INJECT_BYTES - inject.head - 1) % TFT_INJECT_BYTES)) {
+        for(size_t i = 0; i < len; i++) {
+            inject.buf[inject.head] = cmd[i];
+            inject.head = (inject.head + 1) % TFT_INJECT_BYTES;
+        }
+        if(!eol) {
+            inject.buf[inject.head] = '\n';
+            inject.head = (inject.head + 1) % TFT_INJECT_BYTES;
+        }
+        ticket = inject.queued += lines;
+    }
+    portEXIT_CRITICAL(&inject_lock);
+
+    return ticket;
 }
 
-void tft_send_command_fmt(const char *fmt, ...) {
+uint32_t tft_send_command_fmt(const char *fmt, ...) {
     char buffer[128];
     va_list args;
 
@@ -38,7 +145,39 @@ void tft_send_command_fmt(const char *fmt, ...) {
     vsnprintf(buffer, sizeof(buffer), fmt, args);
     va_end(args);
 
-    hal.stream.write(buffer);
+    return tft_send_command(buffer);
+}
+
+bool tft_command_status(uint32_t ticket, status_code_t *status_code) {
+    uint32_t done = inject.done;
+
+    if(ticket == 0 || (int32_t)(done - ticket) < 0)
+        return false;
+
+    // Older than the results kept, its status is lost and must not pass for success
+    if(status_code)
+        *status_code = done - ticket < TFT_INJECT_RESULTS ? inject.result[ticket % TFT_INJECT_RESULTS] : Status_Unhandled;
+
+    return true;
+}
+
+void tft_command_flush(void) {
+    portENTER_CRITICAL(&inject_lock);
+    inject.tail = inject.head;
+    while(inject.done != inject.queued)
+        inject.result[++inject.done % TFT_INJECT_RESULTS] = Status_Unhandled;
+    inject.awaiting = inject.host_line = inject.host_cr = inject.split_crlf = false;
+    portEXIT_CRITICAL(&inject_lock);
+}
+
+void tft_interface_init(void) {
+    inject_attach();
+
+    on_stream_changed = grbl.on_stream_changed;
+    grbl.on_stream_changed = inject_stream_changed;
+
+    status_message = grbl.report.status_message;
+    grbl.report.status_message = inject_status;
 }
 
 /*
@@ -123,6 +262,22 @@ void tft_reset(void) {
     hal.stream.enqueue_rt_command(CMD_RESET);
 }
 
+/*
+ * Overrides
+ */
+
+void tft_set_feed_override(uint16_t percent) {
+    tft_override_set(TFT_OVERRIDE_FEED, percent);
+}
+
+void tft_set_rapid_override(uint16_t percent) {
+    tft_override_set(TFT_OVERRIDE_RAPID, percent);
+}
+
+void tft_set_spindle_override(uint16_t percent) {
+    tft_override_set(TFT_OVERRIDE_SPINDLE, percent);
+}
+
 /*
  * State Queries
  */
@@ -136,9 +291,12 @@ alarm_code_t tft_get_alarm(void) {
 }
 
 uint8_t tft_get_error(void) {
-    // grblHAL doesn't store last error code in sys structure
-    // Return 0 for now - errors are reported via messages
+#if TFT_STREAM_TAP_ENABLE
+    // grblHAL doesn't store the last error code, the stream tap picks it out of the output
+    return tft_stream_tap_last_error();
+#else
     return 0;
+#endif
 }
 
 bool tft_is_homing_enabled(void) {
@@ -20,11 +20,22 @@ extern "C" {
  * Command Injection - Send G-code commands to grblHAL
  */
 
-// Send raw G-code command
-void tft_send_command(const char *cmd);
+// Hook the stream read and status report the commands go through
+void tft_interface_init(void);
+
+// Queue G-code or $ command lines for the parser, read between host lines. Returns
+// a ticket for the last line, 0 if the queue is full. Their status is not reported.
+uint32_t tft_send_command(const char *cmd);
 
 // Send formatted G-code command
-void tft_send_command_fmt(const char *fmt, ...);
+uint32_t tft_send_command_fmt(const char *fmt, ...);
+
+// True once the line of ticket has been parsed, with its status. Status_Unhandled
+// once more than TFT_INJECT_RESULTS lines have completed after it.
+bool tft_command_status(uint32_t ticket, status_code_t *status_code);
+
+// Drop the queued lines, they complete with Status_Unhandled. On reset.
+void tft_command_flush(void);
 
 /*
  * Motion Commands
@@ -71,6 +82,19 @@ void tft_stop(void);
 // Soft reset
 void tft_reset(void);
 
+/*
+ * Overrides - walked to the target in realtime command steps, see tft_override.h
+ */
+
+// Feed override, 10 - 200%
+void tft_set_feed_override(uint16_t percent);
+
+// Rapid override, nearest of 25, 50 and 100%
+void tft_set_rapid_override(uint16_t percent);
+
+// Spindle speed override, 10 - 200%
+void tft_set_spindle_override(uint16_t percent);
+
 /*
  * State Queries
  */
@@ -81,7 +105,7 @@ sys_state_t tft_get_state(void);
 // Get alarm code
 alarm_code_t tft_get_alarm(void);
 
-// Get error code
+// Get code of the last error response, 0 once a later command returned ok
 uint8_t tft_get_error(void);
 
 // Check if homing is enabled
@@ -0,0 +1,127 @@
+/*
+ * tft_latency.c - Input to photon latency measurement
+ *
+ * Part of grblHAL TFT Plugin
+ *
+ * Copyright (c) 2025
+ *
+ */
+
+#include "driver.h"
+
+#if TFT_ENABLE && TFT_LATENCY_ENABLE
+
+#include <stdio.h>
+#include <string.h>
+
+#include "grbl/hal.h"
+
+#include "tft_latency.h"
+
+const uint16_t tft_latency_bucket_ms[TFT_LATENCY_BUCKETS - 1] = {
+    10, 20, 30, 50, 75, 100, 150, 250, 500
+};
+
+static struct {
+    bool pending;
+    bool flushed;
+    uint32_t press_us;
+    uint32_t first_flush_us;
+    uint32_t last_flush_us;
+} sample;
+
+static tft_latency_stats_t stats;
+
+void tft_latency_press(uint32_t now_us) {
+    // A press still waiting for a frame has produced no visible change
+    if(sample.pending)
+        stats.no_response++;
+
+    sample.pending = true;
+    sample.flushed = false;
+    sample.press_us = now_us;
+}
+
+bool tft_latency_pending(void) {
+    return sample.pending;
+}
+
+void tft_latency_flush_start(uint32_t now_us, bool related) {
+    if(sample.pending && related && !sample.flushed) {
+        sample.flushed = true;
+        sample.first_flush_us = now_us;
+    }
+}
+
+void tft_latency_flush_done(uint32_t now_us) {
+    if(sample.pending && sample.flushed)
+        sample.last_flush_us = now_us;
+}
+
+void tft_latency_frame_end(uint32_t now_us) {
+    if(!sample.pending)
+        return;
+
+    if(!sample.flushed) {
+        if(now_us - sample.press_us > TFT_LATENCY_TIMEOUT_MS * 1000UL) {
+            sample.pending = false;
+            stats.no_response++;
+        }
+        return;
+    }
+
+    uint32_t us = sample.last_flush_us - sample.press_us;
+    uint32_t ms = us / 1000;
+    uint_fast8_t idx = 0;
+
+    while(idx < TFT_LATENCY_BUCKETS - 1 && ms >= tft_latency_bucket_ms[idx])
+        idx++;
+
+    stats.bucket[idx]++;
+    stats.samples++;
+    stats.total_us += us;
+    stats.render_total_us += sample.first_flush_us - sample.press_us;
+    stats.last_us = us;
+    if(us > stats.max_us)
+        stats.max_us = us;
+    if(stats.min_us == 0 || us < stats.min_us)
+        stats.min_us = us;
+
+    sample.pending = false;
+}
+
+const tft_latency_stats_t *tft_latency_get_stats(void) {
+    return &stats;
+}
+
+void tft_latency_reset(void) {
+    memset(&stats, 0, sizeof(stats));
+    sample.pending = false;
+}
+
+void tft_latency_report(void) {
+    char buf[80];
+
+    snprintf(buf, sizeof(buf), "[TFTLAT:samples=%u,no_response=%u,min_ms=%.1f,avg_ms=%.1f,max_ms=%.1f]" ASCII_EOL,
+              (unsigned)stats.samples,
+              (unsigned)stats.no_response,
+              (float)stats.min_us / 1000.0f,
+              stats.samples ? (float)(stats.total_us / stats.samples) / 1000.0f : 0.0f,
+              (float)stats.max_us / 1000.0f);
+    hal.stream.write(buf);
+
+    snprintf(buf, sizeof(buf), "[TFTLAT:avg_to_first_flush_ms=%.1f,last_ms=%.1f]" ASCII_EOL,
+              stats.samples ? (float)(stats.render_total_us / stats.samples) / 1000.0f : 0.0f,
+              (float)stats.last_us / 1000.0f);
+    hal.stream.write(buf);
+
+    for(uint_fast8_t i = 0; i < TFT_LATENCY_BUCKETS; i++) {
+        if(i < TFT_LATENCY_BUCKETS - 1)
+            snprintf(buf, sizeof(buf), "[TFTLAT:<%u,%u]" ASCII_EOL, tft_latency_bucket_ms[i], (unsigned)stats.bucket[i]);
+        else
+            snprintf(buf, sizeof(buf), "[TFTLAT:>=%u,%u]" ASCII_EOL, tft_latency_bucket_ms[i - 1], (unsigned)stats.bucket[i]);
+        hal.stream.write(buf);
+    }
+}
+
+#endif // TFT_ENABLE && TFT_LATENCY_ENABLE
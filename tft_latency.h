@@ -0,0 +1,70 @@
+/*
+ * tft_latency.h - Input to photon latency measurement
+ *
+ * Part of grblHAL TFT Plugin
+ *
+ * Copyright (c) 2025
+ *
+ * A sample starts when the touch driver first reports a press and ends
+ * when the last related area flushed by the first refresh with one has
+ * finished its transfer to the panel. An area is related when it overlaps
+ * the object pressed, so a refresh of something else that happens to
+ * follow the press does not end the sample; a press that changes nothing
+ * on screen times out as no response. The caller decides what is related
+ * and passes timestamps in, so the module has no platform dependencies.
+ * Reported and reset with $TFT=LAT and $TFT=LAT,RESET.
+ */
+
+#ifndef _TFT_LATENCY_H_
+#define _TFT_LATENCY_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "tft_config.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define TFT_LATENCY_BUCKETS     10
+
+typedef struct {
+    uint32_t samples;
+    uint32_t no_response;               // Presses not followed by a flush within TFT_LATENCY_TIMEOUT_MS
+    uint32_t min_us;
+    uint32_t max_us;
+    uint64_t total_us;
+    uint64_t render_total_us;           // Press to first flush start
+    uint32_t last_us;
+    uint32_t bucket[TFT_LATENCY_BUCKETS];
+} tft_latency_stats_t;
+
+// Upper bucket bounds in ms, the last bucket is open ended
+extern const uint16_t tft_latency_bucket_ms[TFT_LATENCY_BUCKETS - 1];
+
+// Touch driver reported a new press
+void tft_latency_press(uint32_t now_us);
+
+// Returns true while a press is waiting for its first frame
+bool tft_latency_pending(void);
+
+// A flush is about to start / has completed its transfer. related: the area
+// overlaps the pressed object, only those end a sample
+void tft_latency_flush_start(uint32_t now_us, bool related);
+void tft_latency_flush_done(uint32_t now_us);
+
+// lv_task_handler() returned, closes the pending sample if a frame was flushed
+void tft_latency_frame_end(uint32_t now_us);
+
+const tft_latency_stats_t *tft_latency_get_stats(void);
+
+void tft_latency_reset(void);
+
+// Output histogram to stream
+void tft_latency_report(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // _TFT_LATENCY_H_
@@ -0,0 +1,498 @@
+/*
+ * tft_macro.c - Stored G-code macros
+ *
+ * Part of grblHAL TFT Plugin
+ *
+ * Copyright (c) 2025
+ *
+ */
+
+#include "driver.h"
+#include "tft_config.h"
+
+#if TFT_ENABLE && TFT_MACRO_ENABLE
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+
+#include "grbl/hal.h"
+#include "grbl/settings.h"
+#include "grbl/nvs_buffer.h"
+#include "grbl/planner.h"
+#include "grbl/state_machine.h"
+
+#include "tft_commands.h"
+#include "tft_interface.h"
+#include "tft_macro.h"
+
+typedef struct {
+    char name[TFT_MACRO_NAME_LEN];
+    uint16_t offset;            // Text in tft_macro_table_t.text
+    uint16_t length;            // Bytes, 0 = empty slot
+    uint8_t lines;
+} tft_macro_slot_t;
+
+// As stored in NVS. Lines are \n separated, the last one not terminated.
+typedef struct {
+    tft_macro_slot_t slot[TFT_MACRO_SLOTS];
+    char text[TFT_MACRO_BYTES];
+} tft_macro_table_t;
+
+static tft_macro_table_t table;
+static nvs_address_t nvs_address;
+static volatile uint32_t generation;
+
+static const char *const state_names[] = { "idle", "sending", "finishing", "done", "failed" };
+
+static tft_macro_status_t status;
+
+static struct {
+    uint16_t next;              // Text offset of the next line
+    uint16_t end;
+    uint32_t ticket;            // of the line in flight, 0 while not queued
+} run;
+
+static bool running(void) {
+    return status.state == TFT_MACRO_SENDING || status.state == TFT_MACRO_FINISHING;
+}
+
+static uint16_t table_used(void) {
+    uint16_t used = 0;
+
+    for(uint_fast8_t i = 0; i < TFT_MACRO_SLOTS; i++)
+        used += table.slot[i].length;
+
+    return used;
+}
+
+static void table_write(void) {
+    if(nvs_address)
+        hal.nvs.memcpy_to_nvs(nvs_address, (uint8_t *)&table, sizeof(tft_macro_table_t), true);
+
+    generation++;
+}
+
+// Empty slot, the text of the macros after it moves down
+static void drop(uint8_t slot) {
+    tft_macro_slot_t *old = &table.slot[slot];
+
+    if(old->length) {
+        uint16_t tail = old->offset + old->length;
+
+        memmove(table.text + old->offset, table.text + tail, table_used() - tail);
+        for(uint_fast8_t i = 0; i < TFT_MACRO_SLOTS; i++) {
+            if(table.slot[i].length && table.slot[i].offset > old->offset)
+                table.slot[i].offset -= old->length;
+        }
+    }
+
+    memset(old, 0, sizeof(tft_macro_slot_t));
+}
+
+/*
+ * Checking and normalizing, once when saved
+ */
+
+// A letter followed by a number, repeated
+static status_code_t check_words(const char *s) {
+    while(*s) {
+        bool digits = false;
+
+        if(!isupper((unsigned char)*s))
+            return Status_ExpectedCommandLetter;
+        s++;
+
+        if(*s == '-' || *s == '+')
+            s++;
+        while(isdigit((unsigned char)*s)) {
+            digits = true;
+            s++;
+        }
+        if(*s == '.')
+            s++;
+        while(isdigit((unsigned char)*s)) {
+            digits = true;
+            s++;
+        }
+
+        if(!digits)
+            return Status_BadNumberFormat;
+    }
+
+    return Status_OK;
+}
+
+// Strip blanks and comments of line (len chars), upper case into out. *out_len is 0 for a line left empty.
+static status_code_t normalize(const char *line, size_t len, char *out, size_t *out_len) {
+    size_t n = 0;
+    bool comment = false;
+
+    for(size_t i = 0; i < len && line[i] != ';'; i++) {
+        char c = line[i];
+
+        if(comment) {
+            comment = c != ')';
+            continue;
+        }
+
+        if(c == '(')
+            comment = true;
+        else if(c == ' ' || c == '\t' || c == '\r')
+            continue;
+        else if(c < ' ' || c > '~' || c == '?' || c == '!' || c == '~')
+            return Status_InvalidStatement;    // Control or realtime character
+        else if(n == TFT_MACRO_LINE_MAX)
+            return Status_Overflow;
+        else
+            out[n++] = (char)toupper((unsigned char)c);
+    }
+
+    if(comment)
+        return Status_InvalidStatement;
+
+    out[n] = '\0';
+    *out_len = n;
+
+    if(n == 0)
+        return Status_OK;
+
+    // Homing and jogging are the only system commands that belong in a macro
+    if(*out == '$') {
+        if(out[1] == 'H')
+            return strspn(out + 2, "XYZABC") == n - 2 ? Status_OK : Status_InvalidStatement;
+
+        return strncmp(out, "$J=", 3) == 0 && n > 3 ? check_words(out + 3) : Status_InvalidStatement;
+    }
+
+    return check_words(out);
+}
+
+status_code_t tft_macro_save(uint8_t slot, const char *name, const char *text) {
+    static char buf[TFT_MACRO_BYTES];
+    char line[TFT_MACRO_LINE_MAX + 1];
+    size_t len = 0, line_len, room;
+    uint8_t lines = 0;
+    status_code_t retval;
+
+    if(slot >= TFT_MACRO_SLOTS || *name == '\0' || strlen(name) >= TFT_MACRO_NAME_LEN)
+        return Status_InvalidStatement;
+
+    // The running macro's text would move under it
+    if(running())
+        return Status_IdleError;
+
+    // Free space, plus what the macro replaced takes up
+    room = TFT_MACRO_BYTES - table_used() + table.slot[slot].length;
+
+    while(*text) {
+        const char *eol = strchr(text, '\n');
+        size_t n = eol ? (size_t)(eol - text) : strlen(text);
+
+        if((retval = normalize(text, n, line, &line_len)) != Status_OK)
+            return retval;
+
+        if(line_len) {
+            if(len + line_len + (len ? 1 : 0) > room || lines == UINT8_MAX)
+                return Status_Overflow;
+            if(len)
+                buf[len++] = '\n';
+            memcpy(buf + len, line, line_len);
+            len += line_len;
+            lines++;
+        }
+
+        text += n + (eol ? 1 : 0);
+    }
+
+    if(lines == 0)
+        return Status_InvalidStatement;
+
+    drop(slot);
+
+    tft_macro_slot_t *macro = &table.slot[slot];
+
+    macro->offset = table_used();
+    macro->length = (uint16_t)len;
+    macro->lines = lines;
+    strcpy(macro->name, name);
+    memcpy(table.text + macro->offset, buf, len);
+
+    table_write();
+
+    return Status_OK;
+}
+
+bool tft_macro_delete(uint8_t slot) {
+    if(slot >= TFT_MACRO_SLOTS || table.slot[slot].length == 0 || running())
+        return false;
+
+    drop(slot);
+    table_write();
+
+    return true;
+}
+
+const char *tft_macro_name(uint8_t slot) {
+    return slot < TFT_MACRO_SLOTS && table.slot[slot].length ? table.slot[slot].name : NULL;
+}
+
+uint8_t tft_macro_lines(uint8_t slot) {
+    return slot < TFT_MACRO_SLOTS ? table.slot[slot].lines : 0;
+}
+
+/*
+ * Running, UI task
+ */
+
+static void fail(const char *error) {
+    status.state = TFT_MACRO_FAILED;
+    status.error = error;
+    generation++;
+}
+
+static void send_line(void) {
+    char line[TFT_MACRO_LINE_MAX + 2];
+    const char *s = table.text + run.next, *eol = memchr(s, '\n', run.end - run.next);
+    size_t n = eol ? (size_t)(eol - s) : (size_t)(run.end - run.next);
+
+    memcpy(line, s, n);
+    line[n] = '\n';
+    line[n + 1] = '\0';
+
+    // Sent again by the next poll while the command queue is full
+    if((run.ticket = tft_send_command(line)))
+        run.next += n + (eol ? 1 : 0);
+}
+
+bool tft_macro_run(uint8_t slot) {
+    if(running() || slot >= TFT_MACRO_SLOTS || table.slot[slot].length == 0 || state_get() != STATE_IDLE)
+        return false;
+
+    memset(&status, 0, sizeof(tft_macro_status_t));
+    status.state = TFT_MACRO_SENDING;
+    status.slot = slot;
+    status.lines = table.slot[slot].lines;
+    run.next = table.slot[slot].offset;
+    run.end = run.next + table.slot[slot].length;
+    generation++;
+
+    send_line();
+
+    return true;
+}
+
+void tft_macro_abort(void) {
+    if(!running())
+        return;
+
+    tft_stop();
+    fail("aborted");
+}
+
+void tft_macro_poll(void) {
+    status_code_t code;
+
+    switch(status.state) {
+
+        case TFT_MACRO_SENDING:
+            if(run.ticket == 0)
+                send_line();
+            else if(tft_command_status(run.ticket, &code)) {
+                // The lines after a rejected one would not do what the macro says
+                if(code != Status_OK) {
+                    status.code = code;
+                    tft_stop();
+                    fail("error");
+                    break;
+                }
+                status.line++;
+                generation++;
+                if(run.next < run.end)
+                    send_line();
+                else
+                    status.state = TFT_MACRO_FINISHING;
+            }
+            break;
+
+        case TFT_MACRO_FINISHING:
+            // Blocks may be planned before the cycle starts, idle alone is not enough
+            if(state_get() == STATE_IDLE && plan_get_current_block() == NULL) {
+                status.state = TFT_MACRO_DONE;
+                generation++;
+            }
+            break;
+
+        default:
+            break;
+    }
+}
+
+void tft_macro_event(const tft_event_t *evt) {
+    if(!running())
+        return;
+
+    switch((tft_event_type_t)evt->type) {
+
+        case TFT_EVT_STATE:
+            if(evt->state.state & (STATE_ALARM | STATE_ESTOP))
+                fail("alarm");
+            break;
+
+        case TFT_EVT_RESET:
+            fail("reset");
+            break;
+
+        default:
+            break;
+    }
+}
+
+const tft_macro_status_t *tft_macro_get_status(void) {
+    return &status;
+}
+
+uint32_t tft_macro_generation(void) {
+    return generation;
+}
+
+/*
+ * NVS table, loaded with the $ settings
+ */
+
+static void tft_macro_restore(void) {
+    memset(&table, 0, sizeof(tft_macro_table_t));
+
+    table_write();
+}
+
+static void tft_macro_load(void) {
+    if(hal.nvs.memcpy_from_nvs((uint8_t *)&table, nvs_address, sizeof(tft_macro_table_t), true) != NVS_TransferResult_OK)
+        tft_macro_restore();
+    else
+        generation++;
+}
+
+static setting_details_t setting_details = {
+    .load = tft_macro_load,
+    .restore = tft_macro_restore
+};
+
+void tft_macro_init(void) {
+    if((nvs_address = nvs_alloc(sizeof(tft_macro_table_t))))
+        settings_register(&setting_details);
+    else
+        hal.stream.write("[MSG:TFT macros not stored, no NVS space]" ASCII_EOL);
+}
+
+/*
+ * $TFT=MACRO
+ */
+
+static void ui_macro_run(uint32_t slot) {
+    tft_macro_run((uint8_t)slot);
+}
+
+static void ui_macro_abort(uint32_t arg) {
+    tft_macro_abort();
+}
+
+static bool parse_slot(char **args, uint8_t *slot) {
+    char *arg = tft_command_arg(args), *end;
+
+    if(arg == NULL)
+        return false;
+
+    unsigned long n = strtoul(arg, &end, 10);
+    *slot = (uint8_t)n;
+
+    return *end == '\0' && end != arg && n < TFT_MACRO_SLOTS;
+}
+
+status_code_t tft_macro_command(char *args) {
+    char *arg = tft_command_arg(&args), msg[TFT_MACRO_LINE_MAX + 32];
+    uint8_t slot;
+
+    if(arg == NULL) {
+        for(uint_fast8_t i = 0; i < TFT_MACRO_SLOTS; i++) {
+            if(table.slot[i].length) {
+                snprintf(msg, sizeof(msg), "[TFTMACRO:%u,%s,lines=%u,bytes=%u]" ASCII_EOL, (unsigned)i,
+                          table.slot[i].name, (unsigned)table.slot[i].lines, (unsigned)table.slot[i].length);
+                hal.stream.write(msg);
+            }
+        }
+
+        snprintf(msg, sizeof(msg), "[TFTMACRO:used=%u/%u,%s,slot=%u,line=%u/%u%s%s]" ASCII_EOL,
+                  (unsigned)table_used(), (unsigned)TFT_MACRO_BYTES, state_names[status.state], (unsigned)status.slot,
+                  (unsigned)status.line, (unsigned)status.lines, status.error ? ",error=" : "", status.error ? status.error : "");
+        if(status.code)
+            sprintf(strchr(msg, ']'), ":%u]" ASCII_EOL, (unsigned)status.code);
+        hal.stream.write(msg);
+
+        return Status_OK;
+    }
+
+    if(tft_command_is(arg, "ABORT"))
+        return args == NULL && tft_ui_call(ui_macro_abort, 0) ? Status_OK : Status_InvalidStatement;
+
+    if(!parse_slot(&args, &slot))
+        return Status_InvalidStatement;
+
+    if(tft_command_is(arg, "SHOW")) {
+        if(args || table.slot[slot].length == 0)
+            return Status_InvalidStatement;
+
+        const char *s = table.text + table.slot[slot].offset, *end = s + table.slot[slot].length;
+
+        while(s < end) {
+            const char *eol = memchr(s, '\n', end - s);
+            int n = eol ? (int)(eol - s) : (int)(end - s);
+
+            snprintf(msg, sizeof(msg), "[TFTMACRO:%.*s]" ASCII_EOL, n, s);
+            hal.stream.write(msg);
+            s += n + 1;
+        }
+
+        return Status_OK;
+    }
+
+    if(tft_command_is(arg, "DELETE"))
+        return args == NULL && tft_macro_delete(slot) ? Status_OK : Status_InvalidStatement;
+
+    if(tft_command_is(arg, "RUN")) {
+        if(args || table.slot[slot].length == 0)
+            return Status_InvalidStatement;
+        if(running() || state_get() != STATE_IDLE)
+            return Status_IdleError;
+
+        return tft_ui_call(ui_macro_run, slot) ? Status_OK : Status_InvalidStatement;
+    }
+
+    if(tft_command_is(arg, "SAVE")) {
+        static char text[TFT_MACRO_BYTES];
+        char *name = tft_command_arg(&args);
+        size_t len = 0;
+
+        if(name == NULL || args == NULL)
+            return Status_InvalidStatement;
+
+        // One argument per line
+        while((arg = tft_command_arg(&args))) {
+            size_t n = strlen(arg);
+
+            if(len + n + 1 >= sizeof(text))
+                return Status_Overflow;
+            memcpy(text + len, arg, n);
+            len += n;
+            text[len++] = '\n';
+        }
+        text[len] = '\0';
+
+        return tft_macro_save(slot, name, text);
+    }
+
+    return Status_InvalidStatement;
+}
+
+#endif // TFT_ENABLE && TFT_MACRO_ENABLE
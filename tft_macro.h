@@ -0,0 +1,91 @@
+/*
+ * tft_macro.h - Stored G-code macros
+ *
+ * Part of grblHAL TFT Plugin
+ *
+ * Copyright (c) 2025
+ *
+ * Up to TFT_MACRO_SLOTS macros (park, tool change position, spindle warm
+ * up...) kept in one NVS table: a name and text offset per slot, and the
+ * text of all of them packed into TFT_MACRO_BYTES. Lines are checked and
+ * normalized once when a macro is saved, comments and blanks stripped,
+ * upper case, each a run of letter + number words or $H / $J=, so a run
+ * sends them as they are.
+ *
+ * A run is stepped by the UI task and has one line in flight: the next is
+ * sent through tft_send_command() once the parser has returned the status
+ * of the last, by its ticket, so host lines and other commands are not
+ * mistaken for it. A rejected line stops the run. After the last line it
+ * completes when the machine is idle with the planner empty. An alarm or
+ * a reset fails it, so does an abort, which also stops the motion.
+ */
+
+#ifndef _TFT_MACRO_H_
+#define _TFT_MACRO_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "grbl/hal.h"
+#include "tft_events.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef enum {
+    TFT_MACRO_IDLE = 0,
+    TFT_MACRO_SENDING,          // A line is waiting for its status
+    TFT_MACRO_FINISHING,        // All lines accepted, motion running
+    TFT_MACRO_DONE,
+    TFT_MACRO_FAILED
+} tft_macro_state_t;
+
+typedef struct {
+    tft_macro_state_t state;
+    uint8_t slot;               // Macro run last
+    uint8_t line;               // Lines accepted
+    uint8_t lines;              // of
+    const char *error;          // Why it failed
+    uint16_t code;              // error:N of the line rejected
+} tft_macro_status_t;
+
+// Reserve NVS space and register the table load and restore ($RST=* clears it)
+void tft_macro_init(void);
+
+// Check, normalize and store text, lines separated by \n, in slot. grblHAL task.
+status_code_t tft_macro_save(uint8_t slot, const char *name, const char *text);
+
+// Clear slot. grblHAL task.
+bool tft_macro_delete(uint8_t slot);
+
+// Name of the macro in slot, NULL if empty
+const char *tft_macro_name(uint8_t slot);
+
+// Lines of the macro in slot
+uint8_t tft_macro_lines(uint8_t slot);
+
+// Start the macro in slot, false if empty, one is running or the machine is not idle. UI task.
+bool tft_macro_run(uint8_t slot);
+
+// Stop a running macro and the motion. UI task.
+void tft_macro_abort(void);
+
+// Send the next line once the last one is accepted, call every UI loop. UI task.
+void tft_macro_poll(void);
+
+// Fail a run on alarms, errors and resets, call with every event taken from the queue. UI task.
+void tft_macro_event(const tft_event_t *evt);
+
+const tft_macro_status_t *tft_macro_get_status(void);
+
+// Changes with the table and the run state, for screens polling them
+uint32_t tft_macro_generation(void);
+
+// $TFT=MACRO[,SAVE,<slot>,<name>,<line>[,<line>...]|SHOW,<slot>|DELETE,<slot>|RUN,<slot>|ABORT]
+status_code_t tft_macro_command(char *args);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // _TFT_MACRO_H_
@@ -0,0 +1,213 @@
+/*
+ * tft_mirror.c - Remote framebuffer mirror
+ *
+ * Part of grblHAL TFT Plugin
+ *
+ * Copyright (c) 2025
+ *
+ */
+
+#include "driver.h"
+
+#if TFT_ENABLE && TFT_MIRROR_ENABLE
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "grbl/hal.h"
+
+#include "tft_config.h"
+#include "tft_codec.h"
+#include "tft_commands.h"
+#include "tft_events.h"
+#include "tft_mirror.h"
+#include "lvgl_init.h"
+
+static struct {
+    bool active;                    // UI task only
+    stream_write_ptr write;         // Stream that enabled the mirror
+    get_stream_buffer_count_ptr get_tx_count;
+    uint32_t rate;                  // Bytes per second
+    int32_t tokens;                 // Byte budget, may go negative after a large area
+    uint32_t last_ms;
+    bool has_pending;
+    lv_area_t pending;              // Union of areas not sent yet
+    uint32_t areas;
+    uint32_t coalesced;
+    uint32_t raw_bytes;
+    uint32_t sent_bytes;
+} mirror = {
+    .rate = TFT_MIRROR_RATE
+};
+
+static lvgl_flush_tap_ptr flush_tap;
+
+static bool link_ready(void) {
+    return mirror.tokens >= 0 && (mirror.get_tx_count == NULL || mirror.get_tx_count() < TFT_MIRROR_TX_BACKLOG);
+}
+
+// Characters that can be written now without waiting on the stream
+static int32_t link_budget(void) {
+    int32_t room = mirror.get_tx_count ? TFT_MIRROR_TX_BUFFER - (int32_t)mirror.get_tx_count() : INT32_MAX;
+
+    return room < mirror.tokens ? room : mirror.tokens;
+}
+
+// Text sent for rle bytes of area data, data lines only
+static int32_t text_size(size_t rle) {
+    size_t lines = (rle + TFT_CODEC_LINE_BYTES - 1) / TFT_CODEC_LINE_BYTES;
+
+    return (int32_t)(4 * ((rle + 2) / 3) + lines * (sizeof("[TFTMIRROR:D,]" ASCII_EOL) - 1 + 2));
+}
+
+static void mirror_write(const char *s, size_t len) {
+    mirror.write(s);
+    mirror.sent_bytes += len;
+    mirror.tokens -= (int32_t)len;
+}
+
+static void mirror_send(const lv_area_t *area, const lv_color_t *pixels) {
+    size_t len = tft_codec_write_area(mirror.write, "TFTMIRROR", area->x1, area->y1, area->x2, area->y2,
+                                       (const uint16_t *)pixels);
+
+    mirror.sent_bytes += len;
+    mirror.tokens -= (int32_t)len;
+    mirror.areas++;
+    mirror.raw_bytes += lv_area_get_size(area) * sizeof(lv_color_t);
+}
+
+static void mirror_flush_tap(const lv_area_t *area, const lv_color_t *pixels) {
+    lv_area_t rest;
+
+    if(flush_tap)
+        flush_tap(area, pixels);
+
+    if(!mirror.active)
+        return;
+
+    lv_area_copy(&rest, area);
+
+    if(link_ready()) {
+        // Whole rows that fit the budget, at least one so a small budget still moves on
+        lv_coord_t w = lv_area_get_width(area), y = area->y1;
+        int32_t budget = link_budget(), cost = 0;
+
+        while(y <= area->y2) {
+            int32_t row = text_size(tft_rle16_encode(NULL, (const uint16_t *)pixels + (y - area->y1) * w, w));
+
+            if(y > area->y1 && cost + row > budget)
+                break;
+            cost += row;
+            y++;
+        }
+
+        rest.y2 = y - 1;
+        mirror_send(&rest, pixels);
+
+        if(y > area->y2)
+            return;
+
+        rest.y1 = y;
+        rest.y2 = area->y2;
+    }
+
+    // Link is behind, remember the rows not sent and redraw them later
+    if(mirror.has_pending)
+        lv_area_join(&mirror.pending, &mirror.pending, &rest);
+    else
+        lv_area_copy(&mirror.pending, &rest);
+    mirror.has_pending = true;
+    mirror.coalesced++;
+}
+
+void tft_mirror_poll(uint32_t now_ms) {
+    if(!mirror.active)
+        return;
+
+    // Refill budget, burst limited to a quarter second of output
+    uint32_t refill = (now_ms - mirror.last_ms) * mirror.rate / 1000;
+    if(refill) {
+        mirror.last_ms = now_ms;
+        mirror.tokens += refill;
+        if(mirror.tokens > (int32_t)(mirror.rate / 4))
+            mirror.tokens = mirror.rate / 4;
+    }
+
+    // The redraw passes the pending area through the flush tap again
+    if(mirror.has_pending && link_ready()) {
+        mirror.has_pending = false;
+        lv_inv_area(lv_disp_get_default(), &mirror.pending);
+    }
+}
+
+/*
+ * UI task requests
+ */
+
+static void ui_mirror_start(uint32_t rate) {
+    char msg[40];
+
+    mirror.write = hal.stream.write;
+    mirror.get_tx_count = hal.stream.get_tx_buffer_count;
+    mirror.rate = rate;
+    mirror.tokens = 0;
+    mirror.last_ms = hal.get_elapsed_ticks();
+    mirror.areas = mirror.coalesced = mirror.raw_bytes = mirror.sent_bytes = 0;
+
+    // Let the first poll send the whole screen
+    mirror.pending.x1 = mirror.pending.y1 = 0;
+    mirror.pending.x2 = TFT_DISPLAY_WIDTH - 1;
+    mirror.pending.y2 = TFT_DISPLAY_HEIGHT - 1;
+    mirror.has_pending = true;
+
+    mirror_write(msg, snprintf(msg, sizeof(msg), "[TFTMIRROR:START,%d,%d]" ASCII_EOL, TFT_DISPLAY_WIDTH, TFT_DISPLAY_HEIGHT));
+    mirror.active = true;
+}
+
+static void ui_mirror_stop(uint32_t arg) {
+    if(mirror.active) {
+        mirror.active = false;
+        mirror.write("[TFTMIRROR:STOP]" ASCII_EOL);
+    }
+}
+
+/*
+ * $TFT=MIRROR
+ */
+
+status_code_t tft_mirror_command(char *args) {
+    char *arg = tft_command_arg(&args);
+
+    if(arg == NULL) {
+        char msg[112];
+        snprintf(msg, sizeof(msg), "[TFTMIRROR:%s,rate=%u,areas=%u,raw=%u,sent=%u,coalesced=%u]" ASCII_EOL,
+                  mirror.active ? "on" : "off", (unsigned)mirror.rate, (unsigned)mirror.areas,
+                  (unsigned)mirror.raw_bytes, (unsigned)mirror.sent_bytes, (unsigned)mirror.coalesced);
+        hal.stream.write(msg);
+        return Status_OK;
+    }
+
+    if(tft_command_is(arg, "ON")) {
+        uint32_t rate = TFT_MIRROR_RATE;
+        char *value = tft_command_arg(&args), *end;
+
+        if(value) {
+            rate = strtoul(value, &end, 10);
+            if(*end || rate < 1000 || args)
+                return Status_InvalidStatement;
+        }
+
+        return tft_ui_call(ui_mirror_start, rate) ? Status_OK : Status_InvalidStatement;
+    }
+
+    if(tft_command_is(arg, "OFF") && args == NULL)
+        return tft_ui_call(ui_mirror_stop, 0) ? Status_OK : Status_InvalidStatement;
+
+    return Status_InvalidStatement;
+}
+
+void tft_mirror_init(void) {
+    flush_tap = lvgl_set_flush_tap(mirror_flush_tap);
+}
+
+#endif // TFT_ENABLE && TFT_MIRROR_ENABLE
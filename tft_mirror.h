@@ -0,0 +1,48 @@
+/*
+ * tft_mirror.h - Remote framebuffer mirror
+ *
+ * Part of grblHAL TFT Plugin
+ *
+ * Copyright (c) 2025
+ *
+ * Sends every area flushed to the panel, RLE compressed, as text lines on
+ * the stream that issued $TFT=MIRROR,ON (serial or telnet), so a host can
+ * rebuild the screen (see tools/tft_mirror.py). Output is held to a byte
+ * rate and to the free stream TX space: a flush sends the whole rows that
+ * fit, at least one, and the rows that do not are merged into one pending
+ * rectangle that is redrawn and sent once the budget allows. The UI task
+ * waits on the link for at most one row.
+ *
+ * Protocol:
+ *
+ *   [TFTMIRROR:START,<width>,<height>]          followed by a full redraw
+ *   [TFTMIRROR:R,<x1>,<y1>,<x2>,<y2>,<bytes>]   area, inclusive coordinates
+ *   [TFTMIRROR:D,<base64>]                      RLE data (tft_codec.h) until
+ *                                               <bytes> have been received
+ *   [TFTMIRROR:STOP]
+ */
+
+#ifndef _TFT_MIRROR_H_
+#define _TFT_MIRROR_H_
+
+#include <stdint.h>
+#include "grbl/hal.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Install flush tap, call once after lvgl_init()
+void tft_mirror_init(void);
+
+// Refill rate budget and resend coalesced areas, call from UI task outside lv_task_handler()
+void tft_mirror_poll(uint32_t now_ms);
+
+// $TFT=MIRROR[,ON[,<bytes/s>]|OFF]
+status_code_t tft_mirror_command(char *args);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // _TFT_MIRROR_H_
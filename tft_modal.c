@@ -0,0 +1,245 @@
+/*
+ * tft_modal.c - G-code modal state follower
+ *
+ * Part of grblHAL TFT Plugin
+ *
+ * Copyright (c) 2025
+ *
+ */
+
+#include "tft_config.h"
+
+#if TFT_ENABLE && TFT_RESUME_ENABLE
+
+#include <string.h>
+#include <ctype.h>
+#include <math.h>
+
+#include "tft_modal.h"
+
+#define MAX_DIGITS 8    // Mantissa digits kept, as the grblHAL parser
+
+const tft_modal_t tft_modal_default = {
+    .motion = 0,
+    .plane = 17,
+    .spindle = 5
+};
+
+// Decimal number as grblHAL's read_float reads it: sign, digits and one
+// point, no exponent or hex, so the next word letter ends it
+static bool read_number(const char **s, float *v) {
+    const char *p = *s;
+    uint32_t mantissa = 0;
+    int_fast8_t exp = 0, digits = 0;
+    bool negative = false, point = false, any = false;
+
+    if(*p == '-' || *p == '+')
+        negative = *p++ == '-';
+
+    for(;; p++) {
+        if(isdigit((unsigned char)*p)) {
+            any = true;
+            if(digits < MAX_DIGITS) {
+                if(digits || *p != '0') {
+                    mantissa = mantissa * 10 + (*p - '0');
+                    digits++;
+                }
+                if(point)
+                    exp--;
+            } else if(!point)
+                exp++;
+        } else if(*p == '.' && !point)
+            point = true;
+        else
+            break;
+    }
+
+    if(!any)
+        return false;
+
+    float f = (float)mantissa;
+
+    for(; exp < 0; exp++)
+        f *= 0.1f;
+    for(; exp > 0; exp--)
+        f *= 10.0f;
+
+    *v = negative ? -f : f;
+    *s = p;
+
+    return true;
+}
+
+static void set_units(tft_modal_t *m, bool inches) {
+    if(m->inches != inches) {
+        float f = inches ? 1.0f / 25.4f : 25.4f;
+
+        for(uint_fast8_t idx = 0; idx < 3; idx++)
+            m->pos[idx] *= f;
+        m->feed *= f;
+        m->tlo *= f;
+        m->inches = inches;
+    }
+}
+
+// Follow line, comments and blanks are skipped and bad words end it
+void tft_modal_apply(tft_modal_t *m, const char *s) {
+    float axis[3], h = -1.0f;
+    uint8_t words = 0;
+    uint16_t tlo = 0;
+    bool offsets = false, machine = false, lost = false, home = false;
+
+    while(*s) {
+        char letter = (char)toupper((unsigned char)*s++);
+        float v;
+
+        if(letter == ' ' || letter == '\t')
+            continue;
+        if(letter == '(') {
+            if((s = strchr(s, ')')) == NULL)
+                break;
+            s++;
+            continue;
+        }
+        if(letter == ';' || letter == '$' || letter == '%' || !isalpha((unsigned char)letter))
+            break;
+
+        if(!read_number(&s, &v))
+            break;
+
+        switch(letter) {
+
+            case 'G':
+                {
+                    uint16_t g = (uint16_t)lroundf(v * 10.0f);
+
+                    switch(g) {
+                        case 0: case 10: case 20: case 30:
+                            m->motion = g / 10;
+                            break;
+                        case 800:
+                            m->motion = 80;
+                            break;
+                        case 170: case 180: case 190:
+                            m->plane = g / 10;
+                            break;
+                        case 200: case 210:
+                            set_units(m, g == 200);
+                            break;
+                        case 900: case 910:
+                            m->incremental = g == 910;
+                            break;
+                        case 530:
+                            machine = true;
+                            break;
+                        case 280: case 300:
+                            home = true;
+                            break;
+                        case 920: case 922: case 923:
+                            m->g92 = true;
+                            offsets = true;
+                            break;
+                        case 921:
+                            m->g92 = false;
+                            break;
+                        case 431:
+                            tlo = g;
+                            // fall through
+                        case 100: case 281: case 301:
+                            offsets = true; // Axis words set offsets or stored positions, no motion
+                            break;
+                        case 430: case 432: case 490:
+                            tlo = g;
+                            break;
+                        default:
+                            if(g >= 540 && g <= 590 && g % 10 == 0)
+                                m->wcs = (g - 540) / 10;
+                            else if(g >= 382 && g <= 385)
+                                lost = true;    // Probing stops anywhere
+                            break;
+                    }
+                }
+                break;
+
+            case 'M':
+                switch((uint16_t)v) {
+                    case 3: case 4: case 5:
+                        m->spindle = (uint8_t)v;
+                        break;
+                    case 7:
+                        m->coolant |= 1;
+                        break;
+                    case 8:
+                        m->coolant |= 2;
+                        break;
+                    case 9:
+                        m->coolant = 0;
+                        break;
+                }
+                break;
+
+            case 'F':
+                m->feed = v;
+                break;
+
+            case 'S':
+                m->rpm = v;
+                break;
+
+            case 'H':
+                h = v;
+                break;
+
+            case 'X': case 'Y': case 'Z':
+                axis[letter - 'X'] = v;
+                words |= 1 << (letter - 'X');
+                break;
+
+            default:
+                break;
+        }
+    }
+
+    switch(tlo) {
+        case 430:
+            // From the tool table, restored as long as the table is not changed
+            if(h >= 0.0f && h <= 255.0f) {
+                m->tlo_mode = TFT_TLO_TOOL;
+                m->tool = (uint8_t)h;
+            } else
+                m->tlo_mode = TFT_TLO_UNKNOWN;
+            break;
+        case 431:
+            if(words & 0x03)
+                m->tlo_mode = TFT_TLO_UNKNOWN;
+            else {
+                m->tlo_mode = TFT_TLO_DYNAMIC;
+                m->tlo = words & 0x04 ? axis[2] : 0.0f;
+            }
+            break;
+        case 432:
+            m->tlo_mode = TFT_TLO_UNKNOWN;
+            break;
+        case 490:
+            m->tlo_mode = TFT_TLO_CANCELLED;
+            break;
+    }
+
+    if(home)
+        m->known &= words ? ~words : 0;     // Through the point given, or all axes, to home
+    else if(machine || lost)
+        m->known &= ~words;
+    else if(words && !offsets && m->motion != 80) {
+        for(uint_fast8_t idx = 0; idx < 3; idx++) {
+            if(!(words & (1 << idx)))
+                continue;
+            if(!m->incremental) {
+                m->pos[idx] = axis[idx];
+                m->known |= 1 << idx;
+            } else
+                m->pos[idx] += axis[idx];
+        }
+    }
+}
+
+#endif // TFT_ENABLE && TFT_RESUME_ENABLE
@@ -0,0 +1,66 @@
+/*
+ * tft_modal.h - G-code modal state follower
+ *
+ * Part of grblHAL TFT Plugin
+ *
+ * Copyright (c) 2025
+ *
+ * Follows a G-code program line by line the way the parser would, keeping
+ * only what is needed to resume it: work position, coordinate system,
+ * units, distance mode, motion mode, plane, feed, spindle, coolant and
+ * tool length offset.
+ * Numbers are read as grblHAL reads them, decimal only, so unspaced words
+ * such as G0X10Y5 split where the parser splits them.
+ *
+ * No platform dependencies, tests/ runs it on the host.
+ */
+
+#ifndef _TFT_MODAL_H_
+#define _TFT_MODAL_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Tool length offset set by the program
+typedef enum {
+    TFT_TLO_UNCHANGED = 0,      // Not set, the machine's is kept
+    TFT_TLO_CANCELLED,          // G49
+    TFT_TLO_DYNAMIC,            // G43.1 Z, tlo
+    TFT_TLO_TOOL,               // G43 H, tool
+    TFT_TLO_UNKNOWN             // G43 without H, G43.2 or G43.1 on X/Y, can't be restored
+} tft_tlo_t;
+
+// Modal state before a line
+typedef struct {
+    float pos[3];               // Work position, file units
+    float feed;                 // File units/min
+    float rpm;
+    float tlo;                  // G43.1 Z offset, file units
+    uint8_t known;              // Bit per axis with a known position
+    uint8_t wcs;                // 0 = G54
+    uint8_t motion;             // 0 - 3 for G0 - G3, 80 for G80
+    uint8_t plane;              // 17 - 19
+    uint8_t spindle;            // M3, M4 or M5
+    uint8_t coolant;            // Bit 0 mist (M7), bit 1 flood (M8)
+    uint8_t tlo_mode;           // tft_tlo_t
+    uint8_t tool;               // G43 H word
+    bool inches;
+    bool incremental;
+    bool g92;                   // G92 offset in effect
+} tft_modal_t;
+
+// State at program start
+extern const tft_modal_t tft_modal_default;
+
+// Follow line, comments and blanks are skipped and bad words end it
+void tft_modal_apply(tft_modal_t *m, const char *line);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // _TFT_MODAL_H_
@@ -0,0 +1,110 @@
+/*
+ * tft_offsets.c - Cached work coordinate offset
+ *
+ * Part of grblHAL TFT Plugin
+ *
+ * Copyright (c) 2025
+ *
+ */
+
+#include "driver.h"
+
+#if TFT_ENABLE
+
+#include <stdio.h>
+#include <string.h>
+
+#include "grbl/hal.h"
+#include "grbl/gcode.h"
+#include "grbl/settings.h"
+
+#include "tft_commands.h"
+#include "tft_offsets.h"
+
+static struct {
+    float wco[N_AXIS];          // Coordinate system + G92 + tool length
+    volatile bool valid;
+    uint32_t updates;           // Recomputed
+    uint32_t reports;           // Served from the cache
+} cache;
+
+static on_wco_changed_ptr on_wco_changed;
+
+// Summed like grblHAL's gc_get_offset(), so positions match its reports to the bit
+static void update(void) {
+    for(uint_fast8_t idx = 0; idx < N_AXIS; idx++)
+        cache.wco[idx] = gc_state.modal.coord_system.xyz[idx] + gc_state.g92_coord_offset[idx] +
+                          gc_state.tool_length_offset[idx];
+
+    cache.valid = true;
+    cache.updates++;
+}
+
+static void tft_wco_changed(void) {
+    update();
+
+    if(on_wco_changed)
+        on_wco_changed();
+}
+
+void tft_offsets_invalidate(void) {
+    cache.valid = false;
+}
+
+void tft_offsets_wpos(const float mpos[N_AXIS], float wpos[N_AXIS]) {
+    if(!cache.valid)
+        update();
+
+    for(uint_fast8_t idx = 0; idx < N_AXIS; idx++)
+        wpos[idx] = mpos[idx] - cache.wco[idx];
+
+    cache.reports++;
+}
+
+bool tft_offsets_read(tft_offset_t offset, float xyz[N_AXIS]) {
+    switch(offset) {
+
+        case TFT_OFFSET_G92:
+            memcpy(xyz, gc_state.g92_coord_offset, sizeof(float) * N_AXIS);
+            return true;
+
+        case TFT_OFFSET_TLO:
+            memcpy(xyz, gc_state.tool_length_offset, sizeof(float) * N_AXIS);
+            return true;
+
+        default:
+            if(offset >= TFT_OFFSET_G92)
+                return false;
+
+            return settings_read_coord_data((coord_system_id_t)(CoordinateSystem_G54 + offset), (float (*)[N_AXIS])xyz);
+    }
+}
+
+uint8_t tft_offsets_active(void) {
+    return (uint8_t)(gc_state.modal.coord_system.id - CoordinateSystem_G54);
+}
+
+/*
+ * $TFT=WCO
+ */
+
+status_code_t tft_offsets_command(char *args) {
+    char msg[96];
+
+    if(args)
+        return Status_InvalidStatement;
+
+    snprintf(msg, sizeof(msg), "[TFTWCO:%.3f,%.3f,%.3f,G%u,%s,updates=%u,reports=%u]" ASCII_EOL,
+              cache.wco[0], cache.wco[1], cache.wco[2], 54 + (unsigned)tft_offsets_active(),
+              cache.valid ? "cached" : "stale", (unsigned)cache.updates, (unsigned)cache.reports);
+    hal.stream.write(msg);
+
+    return Status_OK;
+}
+
+void tft_offsets_init(void) {
+    on_wco_changed = grbl.on_wco_changed;
+    grbl.on_wco_changed = tft_wco_changed;
+}
+
+#endif // TFT_ENABLE
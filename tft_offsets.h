@@ -0,0 +1,56 @@
+/*
+ * tft_offsets.h - Cached work coordinate offset
+ *
+ * Part of grblHAL TFT Plugin
+ *
+ * Copyright (c) 2025
+ *
+ * Work position is machine position less the active coordinate system,
+ * G92 and tool length offsets, as grblHAL reports it (WCO). Their sum is
+ * kept here and only recomputed when grblHAL signals a change through
+ * on_wco_changed, or after a reset, so a realtime report costs one vector
+ * subtraction.
+ */
+
+#ifndef _TFT_OFFSETS_H_
+#define _TFT_OFFSETS_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "grbl/hal.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Rows of tft_offsets_read()
+typedef enum {
+    TFT_OFFSET_G54 = 0,         // to G59
+    TFT_OFFSET_G92 = 6,
+    TFT_OFFSET_TLO,
+    TFT_OFFSET_COUNT
+} tft_offset_t;
+
+// Hook on_wco_changed
+void tft_offsets_init(void);
+
+// Offsets changed under the cache (reset), recompute on the next report. grblHAL task.
+void tft_offsets_invalidate(void);
+
+// Work position of mpos. grblHAL task.
+void tft_offsets_wpos(const float mpos[N_AXIS], float wpos[N_AXIS]);
+
+// Offset vector of a coordinate system, G92 or the tool length, false if it can't be read
+bool tft_offsets_read(tft_offset_t offset, float xyz[N_AXIS]);
+
+// Active coordinate system, TFT_OFFSET_G54 to G59 (or beyond with G59.x)
+uint8_t tft_offsets_active(void);
+
+// $TFT=WCO
+status_code_t tft_offsets_command(char *args);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // _TFT_OFFSETS_H_
@@ -0,0 +1,273 @@
+/*
+ * tft_override.c - Feed, rapid and spindle override controller
+ *
+ * Part of grblHAL TFT Plugin
+ *
+ * Copyright (c) 2025
+ *
+ */
+
+#include "driver.h"
+
+#if TFT_ENABLE
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "esp_timer.h"
+#include "grbl/hal.h"
+#include "grbl/system.h"
+
+#include "tft_config.h"
+#include "tft_commands.h"
+#include "tft_override.h"
+
+typedef struct {
+    const char *name;
+    uint16_t min, max, normal; // Range and reset value
+    uint8_t coarse, fine;       // Increments, coarse 0 for preset levels (rapids)
+    char reset, coarse_plus, coarse_minus, fine_plus, fine_minus;
+} override_def_t;
+
+static const override_def_t defs[TFT_OVERRIDE_COUNT] = {
+    [TFT_OVERRIDE_FEED] = {
+        "FEED", MIN_FEED_RATE_OVERRIDE, MAX_FEED_RATE_OVERRIDE, DEFAULT_FEED_OVERRIDE,
+        FEED_OVERRIDE_COARSE_INCREMENT, FEED_OVERRIDE_FINE_INCREMENT,
+        CMD_OVERRIDE_FEED_RESET, CMD_OVERRIDE_FEED_COARSE_PLUS, CMD_OVERRIDE_FEED_COARSE_MINUS,
+        CMD_OVERRIDE_FEED_FINE_PLUS, CMD_OVERRIDE_FEED_FINE_MINUS
+    },
+    [TFT_OVERRIDE_RAPID] = {
+        "RAPID", RAPID_OVERRIDE_LOW, DEFAULT_RAPID_OVERRIDE, DEFAULT_RAPID_OVERRIDE, 0, 0,
+        CMD_OVERRIDE_RAPID_RESET
+    },
+    [TFT_OVERRIDE_SPINDLE] = {
+        "SPINDLE", MIN_SPINDLE_RPM_OVERRIDE, MAX_SPINDLE_RPM_OVERRIDE, DEFAULT_SPINDLE_RPM_OVERRIDE,
+        SPINDLE_OVERRIDE_COARSE_INCREMENT, SPINDLE_OVERRIDE_FINE_INCREMENT,
+        CMD_OVERRIDE_SPINDLE_RESET, CMD_OVERRIDE_SPINDLE_COARSE_PLUS, CMD_OVERRIDE_SPINDLE_COARSE_MINUS,
+        CMD_OVERRIDE_SPINDLE_FINE_PLUS, CMD_OVERRIDE_SPINDLE_FINE_MINUS
+    }
+};
+
+static struct {
+    volatile uint16_t target;   // 0 when there is none
+    uint16_t expected;          // Value the last command leads to, 0 when confirmed
+    int64_t sent_us;
+    uint8_t timeouts;           // In a row
+} ovr[TFT_OVERRIDE_COUNT];
+
+static struct {
+    uint32_t commands;
+    uint32_t timeouts;
+    uint32_t given_up;
+} stats;
+
+static esp_timer_handle_t timer = NULL;
+static portMUX_TYPE lock = portMUX_INITIALIZER_UNLOCKED;
+
+uint16_t tft_override_get(tft_override_t which) {
+    switch(which) {
+        case TFT_OVERRIDE_FEED:
+            return sys.override.feed_rate;
+        case TFT_OVERRIDE_RAPID:
+            return sys.override.rapid_rate;
+        case TFT_OVERRIDE_SPINDLE:
+            return sys.override.spindle_rpm;
+        default:
+            return 0;
+    }
+}
+
+// Steps from current to target in one direction, without reset. Steps
+// saturate at the range limits, so a limit is reached by coarse steps only.
+static uint16_t steps(const override_def_t *def, uint16_t current, uint16_t target) {
+    uint16_t d = abs((int)target - (int)current);
+
+    if(target == def->min || target == def->max)
+        return (d + def->coarse - 1) / def->coarse;
+
+    return d / def->coarse + (d % def->coarse) / def->fine;
+}
+
+// First command of the shortest sequence from current to target that never
+// passes it, 0 when there. *next is the value it leads to.
+static char plan_step(const override_def_t *def, uint16_t current, uint16_t target, uint16_t *next) {
+    if(def->coarse == 0) {
+        *next = target;
+        if(current == target)
+            return 0;
+        return target == DEFAULT_RAPID_OVERRIDE ? CMD_OVERRIDE_RAPID_RESET
+                : target == RAPID_OVERRIDE_MEDIUM ? CMD_OVERRIDE_RAPID_MEDIUM : CMD_OVERRIDE_RAPID_LOW;
+    }
+
+    bool up = target > current;
+    uint16_t d = up ? target - current : current - target;
+
+    if(d < def->fine)
+        return 0;
+
+    // Reset when 100% is on the way and jumping there saves steps
+    if((up ? current < def->normal && target >= def->normal
+           : current > def->normal && target <= def->normal) &&
+        1 + steps(def, def->normal, target) < steps(def, current, target)) {
+        *next = def->normal;
+        return def->reset;
+    }
+
+    if(d >= def->coarse || target == def->min || target == def->max) {
+        int v = up ? current + def->coarse : current - def->coarse;
+        *next = (uint16_t)(v < def->min ? def->min : (v > def->max ? def->max : v));
+        return up ? def->coarse_plus : def->coarse_minus;
+    }
+
+    *next = up ? current + def->fine : current - def->fine;
+
+    return up ? def->fine_plus : def->fine_minus;
+}
+
+// Steps left, by running the plan
+static uint16_t steps_left(tft_override_t which) {
+    uint16_t current = tft_override_get(which), target = ovr[which].target, n = 0;
+
+    if(target)
+        while(plan_step(&defs[which], current, target, &current) && ++n < 255);
+
+    return n;
+}
+
+// One command per override per tick, each waiting for its value to be reported
+static void override_timer(void *arg) {
+    bool busy = false;
+    int64_t now = esp_timer_get_time();
+
+    for(uint_fast8_t i = 0; i < TFT_OVERRIDE_COUNT; i++) {
+        uint16_t current = tft_override_get((tft_override_t)i), target = ovr[i].target, next;
+
+        if(ovr[i].expected) {
+            if(current == ovr[i].expected)
+                ovr[i].timeouts = 0;
+            else if(now - ovr[i].sent_us < TFT_OVERRIDE_SETTLE_MS * 1000LL) {
+                busy = true;
+                continue;
+            } else {
+                // Lost or overrides disabled, plan again from what is reported
+                stats.timeouts++;
+                if(++ovr[i].timeouts == TFT_OVERRIDE_RETRIES) {
+                    portENTER_CRITICAL(&lock);
+                    if(ovr[i].target == target)
+                        ovr[i].target = target = 0;
+                    portEXIT_CRITICAL(&lock);
+                    ovr[i].timeouts = 0;
+                    stats.given_up++;
+                }
+            }
+            ovr[i].expected = 0;
+        }
+
+        if(target == 0)
+            continue;
+
+        char cmd = plan_step(&defs[i], current, target, &next);
+
+        if(cmd == 0) {
+            // Reached, leave later changes from elsewhere alone. A newer target is kept.
+            portENTER_CRITICAL(&lock);
+            if(ovr[i].target == target)
+                ovr[i].target = 0;
+            else
+                busy = true;
+            portEXIT_CRITICAL(&lock);
+            continue;
+        }
+
+        hal.stream.enqueue_rt_command(cmd);
+        ovr[i].expected = next;
+        ovr[i].sent_us = now;
+        stats.commands++;
+        busy = true;
+    }
+
+    if(busy)
+        esp_timer_start_once(timer, TFT_OVERRIDE_STEP_MS * 1000ULL);
+}
+
+void tft_override_set(tft_override_t which, uint16_t percent) {
+    const override_def_t *def;
+
+    if(timer == NULL || which >= TFT_OVERRIDE_COUNT)
+        return;
+
+    def = &defs[which];
+
+    if(def->coarse == 0)
+        percent = percent >= (RAPID_OVERRIDE_MEDIUM + DEFAULT_RAPID_OVERRIDE) / 2 ? DEFAULT_RAPID_OVERRIDE
+                   : percent >= (RAPID_OVERRIDE_LOW + RAPID_OVERRIDE_MEDIUM) / 2 ? RAPID_OVERRIDE_MEDIUM : RAPID_OVERRIDE_LOW;
+    else if(percent < def->min)
+        percent = def->min;
+    else if(percent > def->max)
+        percent = def->max;
+
+    portENTER_CRITICAL(&lock);
+    ovr[which].target = percent;
+    portEXIT_CRITICAL(&lock);
+
+    // Fails harmlessly when the timer is already running, it picks the target up
+    esp_timer_start_once(timer, 0);
+}
+
+uint16_t tft_override_target(tft_override_t which) {
+    return which < TFT_OVERRIDE_COUNT ? ovr[which].target : 0;
+}
+
+/*
+ * $TFT=OVR
+ */
+
+status_code_t tft_override_command(char *args) {
+    char *arg = tft_command_arg(&args), *end;
+
+    if(arg == NULL) {
+        char msg[64];
+
+        for(uint_fast8_t i = 0; i < TFT_OVERRIDE_COUNT; i++) {
+            snprintf(msg, sizeof(msg), "[TFTOVR:%s,%u,target=%u,steps=%u]" ASCII_EOL, defs[i].name,
+                      (unsigned)tft_override_get((tft_override_t)i), (unsigned)ovr[i].target,
+                      (unsigned)steps_left((tft_override_t)i));
+            hal.stream.write(msg);
+        }
+
+        snprintf(msg, sizeof(msg), "[TFTOVR:commands=%u,timeouts=%u,given up=%u]" ASCII_EOL,
+                  (unsigned)stats.commands, (unsigned)stats.timeouts, (unsigned)stats.given_up);
+        hal.stream.write(msg);
+
+        return Status_OK;
+    }
+
+    for(uint_fast8_t i = 0; i < TFT_OVERRIDE_COUNT; i++) {
+        if(tft_command_is(arg, defs[i].name)) {
+            if((arg = tft_command_arg(&args)) == NULL || args)
+                return Status_InvalidStatement;
+
+            unsigned long percent = strtoul(arg, &end, 10);
+
+            if(*end || percent == 0 || percent > 1000)
+                return Status_InvalidStatement;
+
+            tft_override_set((tft_override_t)i, (uint16_t)percent);
+
+            return Status_OK;
+        }
+    }
+
+    return Status_InvalidStatement;
+}
+
+bool tft_override_init(void) {
+    const esp_timer_create_args_t timer_args = {
+        .callback = override_timer,
+        .name = "tft_override"
+    };
+
+    return esp_timer_create(&timer_args, &timer) == ESP_OK;
+}
+
+#endif // TFT_ENABLE
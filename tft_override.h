@@ -0,0 +1,58 @@
+/*
+ * tft_override.h - Feed, rapid and spindle override controller
+ *
+ * Part of grblHAL TFT Plugin
+ *
+ * Copyright (c) 2025
+ *
+ * grblHAL only takes override changes as realtime commands: feed and
+ * spindle step by the coarse (10%) and fine (1%) increments or reset to
+ * 100%, rapids jump between its preset levels. A slider sets a target and
+ * the controller walks the reported override to it, one command per
+ * override every TFT_OVERRIDE_STEP_MS, with the fewest steps that never
+ * pass the target. Each step waits until grblHAL reports the value it
+ * leads to, so commands not yet applied are never sent twice and a target
+ * moved meanwhile is simply planned for from where the override is.
+ *
+ * Once reached the target is dropped, so overrides changed by the host or
+ * a pendant afterwards are left alone.
+ */
+
+#ifndef _TFT_OVERRIDE_H_
+#define _TFT_OVERRIDE_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "grbl/hal.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef enum {
+    TFT_OVERRIDE_FEED = 0,
+    TFT_OVERRIDE_RAPID,
+    TFT_OVERRIDE_SPINDLE,
+    TFT_OVERRIDE_COUNT
+} tft_override_t;
+
+// Create the step timer
+bool tft_override_init(void);
+
+// Walk the override to percent, clamped to its range (rapids: nearest level). Any task.
+void tft_override_set(tft_override_t which, uint16_t percent);
+
+// Override reported by grblHAL, percent
+uint16_t tft_override_get(tft_override_t which);
+
+// Target being walked to, 0 when there is none
+uint16_t tft_override_target(tft_override_t which);
+
+// $TFT=OVR[,FEED|RAPID|SPINDLE,<percent>]
+status_code_t tft_override_command(char *args);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // _TFT_OVERRIDE_H_
@@ -16,6 +16,7 @@
 
 #if TFT_ENABLE
 
+#include <stdio.h>
 #include <string.h>
 #include <lvgl.h>
 #include "grbl/hal.h"
@@ -23,12 +24,40 @@
 #include "grbl/state_machine.h"
 #include "grbl/report.h"
 #include "grbl/gcode.h"
+#include "grbl/planner.h"
 
 #include "tft_plugin.h"
 #include "tft_config.h"
 #include "tft_driver.h"
+#include "tft_commands.h"
+#include "tft_profiler.h"
+#include "tft_events.h"
+#include "tft_interface.h"
+#include "tft_trace.h"
+#include "tft_screens.h"
+#include "tft_touch_script.h"
+#include "tft_mirror.h"
+#include "tft_remote_input.h"
+#include "tft_screenshot.h"
+#include "tft_throttle.h"
+#include "tft_alarm.h"
+#include "tft_settings.h"
+#include "tft_idle.h"
+#include "tft_beep.h"
+#include "tft_stream_tap.h"
+#include "tft_console.h"
+#include "tft_override.h"
+#include "tft_probe.h"
+#include "tft_offsets.h"
+#include "tft_macro.h"
+#include "tft_history.h"
+#include "tft_resume.h"
 #include "lvgl_init.h"
 
+#if TFT_TRACE_ENABLE
+#include "esp_timer.h"
+#endif
+
 // Plugin metadata
 static const char *plugin_id = "grblhal_tft_ui";
 static const char *plugin_info = "TFT Touchscreen UI v0.1";
@@ -40,15 +69,20 @@ static on_program_completed_ptr on_program_completed;
 static driver_reset_ptr driver_reset;
 static on_report_options_ptr on_report_options;
 
-// UI state cache
+// UI state cache (owned by the UI task, fed from the event queue)
 static struct {
     sys_state_t state;
     float mpos[N_AXIS];
     float wpos[N_AXIS];
     float feed_rate;
+    float spindle_rpm;
     uint32_t line_number;
+    uint8_t error;
 } ui_state = {0};
 
+static TaskHandle_t ui_task = NULL;
+static bool ui_started = false;
+
 // Forward declarations
 static void tft_state_changed(sys_state_t state);
 static void tft_realtime_report(stream_write_ptr stream_write, report_tracking_flags_t report);
@@ -57,30 +91,36 @@ static void tft_reset(void);
 static void tft_report_options(bool newopt);
 static void tft_ui_task(void *param);
 
+/*
+ * Post event to UI task (and trace recorder)
+ */
+static void tft_post_event(const tft_event_t *evt) {
+#if TFT_TRACE_ENABLE
+    // A replay owns the queue, live events would interleave with it
+    if(tft_trace_replaying())
+        return;
+
+    tft_trace_record(evt);
+#endif
+
+    tft_event_post(evt);
+}
+
 /*
  * Event: State changed (Idle, Run, Hold, Alarm, etc.)
  */
 static void tft_state_changed(sys_state_t state) {
-    ui_state.state = state;
-
-    // TODO: Update UI based on state
-    // switch(state) {
-    //     case STATE_IDLE:
-    //         // Show ready screen
-    //         break;
-    //     case STATE_CYCLE:
-    //         // Show job running screen
-    //         break;
-    //     case STATE_HOLD:
-    //         // Show paused status
-    //         break;
-    //     case STATE_ALARM:
-    //         // Show alarm screen
-    //         break;
-    //     case STATE_HOMING:
-    //         // Show homing status
-    //         break;
-    // }
+    TFT_PROF_BEGIN(TFT_PROF_HOOK_STATE);
+
+    // Alarm and E-stop wake the UI task directly, ahead of the queue
+    tft_alarm_state_changed(state, sys.alarm);
+
+    tft_event_t evt = { .type = TFT_EVT_STATE };
+    evt.state.state = state;
+    evt.state.alarm = sys.alarm;
+    tft_post_event(&evt);
+
+    TFT_PROF_END(TFT_PROF_HOOK_STATE);
 
     // Chain to previous handler
     if(on_state_change)
@@ -91,21 +131,27 @@ static void tft_state_changed(sys_state_t state) {
  * Event: Realtime report (position and status updates)
  */
 static void tft_realtime_report(stream_write_ptr stream_write, report_tracking_flags_t report) {
+    TFT_PROF_BEGIN(TFT_PROF_HOOK_REPORT);
+
+    tft_event_t evt = { .type = TFT_EVT_REPORT };
+
     // Get current machine position
-    system_convert_array_steps_to_mpos(ui_state.mpos, sys.position);
+    system_convert_array_steps_to_mpos(evt.report.mpos, sys.position);
 
-    // Get work position (accounting for work coordinate system)
-    // In grblHAL, coordinate offsets are in gc_state.modal
-    for(int i = 0; i < N_AXIS; i++) {
-        ui_state.wpos[i] = ui_state.mpos[i] - gc_state.modal.coord_system.xyz[i];
-    }
+    // Work position: coordinate system, G92 and tool length offsets, cached until they change
+    tft_offsets_wpos(evt.report.mpos, evt.report.wpos);
 
     // Get current feed rate
-    ui_state.feed_rate = st_get_realtime_rate();
+    evt.report.feed_rate = st_get_realtime_rate();
+    evt.report.spindle_rpm = sys.spindle_rpm;
+
+    // Line number of the block executing, 0 if none or not numbered
+    plan_block_t *block = plan_get_current_block();
+    evt.report.line_number = block ? (uint32_t)block->line_number : 0;
+
+    tft_post_event(&evt);
 
-    // TODO: Update UI with position and feed rate
-    // ui_update_position(ui_state.mpos, ui_state.wpos);
-    // ui_update_feed_rate(ui_state.feed_rate);
+    TFT_PROF_END(TFT_PROF_HOOK_REPORT);
 
     // Chain to previous handler
     if(on_realtime_report)
@@ -116,10 +162,19 @@ static void tft_realtime_report(stream_write_ptr stream_write, report_tracking_f
  * Event: Program completed
  */
 static void tft_program_completed(program_flow_t program_flow, bool check_mode) {
-    if(!check_mode) {
-        // TODO: Show job complete popup
-        // ui_show_popup("Job Complete", "Program finished successfully");
-    }
+    TFT_PROF_BEGIN(TFT_PROF_HOOK_PROGRAM);
+
+    tft_event_t evt = { .type = TFT_EVT_PROGRAM };
+    evt.program.flow = (uint8_t)program_flow;
+    evt.program.check_mode = check_mode;
+    tft_post_event(&evt);
+
+#if TFT_BEEP_ENABLE
+    if(!check_mode)
+        tft_beep_play(TFT_BEEP_CHIME);
+#endif
+
+    TFT_PROF_END(TFT_PROF_HOOK_PROGRAM);
 
     // Chain to previous handler
     if(on_program_completed)
@@ -130,11 +185,18 @@ static void tft_program_completed(program_flow_t program_flow, bool check_mode)
  * Event: System reset
  */
 static void tft_reset(void) {
-    // Reset UI state
-    memset(&ui_state, 0, sizeof(ui_state));
+    TFT_PROF_BEGIN(TFT_PROF_HOOK_RESET);
+
+    tft_event_t evt = { .type = TFT_EVT_RESET };
+    tft_post_event(&evt);
 
-    // TODO: Reset UI to ready screen
-    // ui_show_screen(SCREEN_READY);
+    // Reset may restore offsets without signalling a change
+    tft_offsets_invalidate();
+
+    // The parser drops its line, queued commands go with it
+    tft_command_flush();
+
+    TFT_PROF_END(TFT_PROF_HOOK_RESET);
 
     // Chain to previous handler
     if(driver_reset)
@@ -154,72 +216,308 @@ static void tft_report_options(bool newopt) {
         hal.stream.write("[PLUGIN:TFT UI v0.1]" ASCII_EOL);
 }
 
+/*
+ * Apply event posted by a grblHAL hook (UI task)
+ */
+static void tft_ui_handle_event(const tft_event_t *evt) {
+#if TFT_PROBE_ENABLE
+    // A running wizard steps on probe results and fails on alarms, errors and resets
+    tft_probe_event(evt);
+#endif
+
+#if TFT_MACRO_ENABLE
+    // Same for a running macro
+    tft_macro_event(evt);
+#endif
+
+#if TFT_RESUME_ENABLE
+    // A job started by a resume ends
+    tft_resume_event(evt);
+#endif
+
+    switch((tft_event_type_t)evt->type) {
+
+        case TFT_EVT_STATE:
+            ui_state.state = evt->state.state;
+            break;
+
+        case TFT_EVT_REPORT:
+            memcpy(ui_state.mpos, evt->report.mpos, sizeof(ui_state.mpos));
+            memcpy(ui_state.wpos, evt->report.wpos, sizeof(ui_state.wpos));
+            ui_state.feed_rate = evt->report.feed_rate;
+            ui_state.spindle_rpm = evt->report.spindle_rpm;
+            if(evt->report.line_number)
+                ui_state.line_number = evt->report.line_number;
+
+#if TFT_RESUME_ENABLE
+            tft_resume_set_line(evt->report.line_number);
+#endif
+
+#if TFT_CHARTS_ENABLE
+            tft_history_add(ui_state.feed_rate, ui_state.spindle_rpm);
+#endif
+            break;
+
+        case TFT_EVT_RESET:
+            // Reset UI state
+            memset(&ui_state, 0, sizeof(ui_state));
+            break;
+
+        case TFT_EVT_CALL:
+            evt->call.fn(evt->call.arg);
+            break;
+
+#if TFT_STREAM_TAP_ENABLE
+        case TFT_EVT_STREAM:
+            if(evt->stream.kind == TFT_STREAM_ERROR)
+                ui_state.error = (uint8_t)evt->stream.code;
+            break;
+#endif
+
+        default:
+            break;
+    }
+}
+
+/*
+ * Sleep until the next loop period, a critical state change wakes the task early
+ */
+static void tft_ui_wait(TickType_t *last_wake, TickType_t period) {
+    TickType_t elapsed = xTaskGetTickCount() - *last_wake;
+
+    if(elapsed < period && ulTaskNotifyTake(pdTRUE, period - elapsed) == 0)
+        *last_wake += period;
+    else
+        *last_wake = xTaskGetTickCount();   // Woken early or overran
+}
+
 /*
  * UI Task - runs on Core 0, handles LVGL updates
  */
 static void tft_ui_task(void *param) {
     TickType_t xLastWakeTime = xTaskGetTickCount();
-    const TickType_t xFrequency = pdMS_TO_TICKS(TFT_LVGL_REFRESH_MS);
-
-    // Breathing effect during startup (2 seconds)
-    uint32_t splash_count = 0;
-    const uint32_t splash_duration = TFT_SPLASH_DURATION_MS / TFT_LVGL_REFRESH_MS;  // 400 iterations
-    const uint32_t backlight_on_count = TFT_SPLASH_BACKLIGHT_DELAY_MS / TFT_LVGL_REFRESH_MS;  // 100 iterations
+    TickType_t xFrequency = pdMS_TO_TICKS(tft_settings.loop_ms);
 
-    // Create "Hello World" label
-    lv_obj_t *label = lv_label_create(lv_scr_act(), NULL);
-    lv_label_set_text(label, "grblHAL TFT Ready!\n\nPhase 2 Complete");
-    lv_obj_align(label, NULL, LV_ALIGN_CENTER, 0, 0);
+    // Breathing effect during startup (2 seconds), the fade timer runs it
+    uint32_t splash_start = hal.get_elapsed_ticks();
+    uint_fast8_t splash = 0;
 
-    // Set larger font if available
-    static lv_style_t style;
-    lv_style_copy(&style, &lv_style_plain);
-    style.text.font = &lv_font_roboto_28;
-    lv_obj_set_style(label, &style);
+    // Build the ready screen and the hidden alarm banner
+    tft_screens_init();
+    tft_alarm_init();
 
     // Main UI loop
     while(1) {
-        // Breathing effect and splash screen
-        if(splash_count < splash_duration) {
-            tft_backlight_breathing();
-            splash_count++;
-
-            // Turn on backlight after delay
-            if(splash_count == backlight_on_count) {
-                tft_backlight_on(255);  // Full brightness
+        TFT_PROF_BEGIN(TFT_PROF_LOOP);
+
+#if TFT_IDLE_ENABLE
+        // A sleeping display is woken before the alarm banner is drawn
+        if(tft_alarm_active() && tft_idle_level() != TFT_IDLE_ACTIVE)
+            tft_idle_wake();
+#endif
+
+        // Alarm banner goes to glass before anything else
+        tft_alarm_poll();
+
+        // Breathing effect and splash screen, then fade to full brightness
+        if(splash < 2) {
+            uint32_t splash_ms = hal.get_elapsed_ticks() - splash_start;
+
+            if(splash == 0 && splash_ms >= TFT_SPLASH_BACKLIGHT_DELAY_MS) {
+                tft_backlight_breathe(0, 255, TFT_SPLASH_BREATHE_MS);
+                splash = 1;
+            } else if(splash == 1 && splash_ms >= TFT_SPLASH_DURATION_MS) {
+                tft_backlight_fade(255, TFT_FADE_MS);
+                splash = 2;
             }
         }
 
+        // Apply events posted by the grblHAL hooks
+        tft_event_t evt;
+        while(tft_event_get(&evt))
+            tft_ui_handle_event(&evt);
+
+#if TFT_THROTTLE_ENABLE
+        // Slower loop, refresh and touch polling while a job runs
+        xFrequency = pdMS_TO_TICKS(tft_throttle_update(ui_state.state, hal.get_elapsed_ticks()));
+#else
+        xFrequency = pdMS_TO_TICKS(tft_settings.loop_ms);
+#endif
+
+#if TFT_IDLE_ENABLE
+        // Dim and sleep while idle, wake on any state change
+        xFrequency = pdMS_TO_TICKS(tft_idle_update(ui_state.state, hal.get_elapsed_ticks(), pdTICKS_TO_MS(xFrequency)));
+#endif
+
+#if TFT_CHARTS_ENABLE
+        // Close the chart history buckets that are due
+        tft_history_tick(hal.get_elapsed_ticks());
+#endif
+
+#if TFT_PROBE_ENABLE
+        // Rejected wizard lines and touch timeouts
+        tft_probe_poll();
+#endif
+
+#if TFT_MACRO_ENABLE
+        // Next macro line once the last one is accepted
+        tft_macro_poll();
+#endif
+
+#if TFT_RESUME_ENABLE
+        // Next chunk of a resume scan or of the resume file
+        tft_resume_poll();
+#endif
+
+#if TFT_AUTOMATION_ENABLE
+        // Scripted touch input, read by the next lvgl_touch_read()
+        tft_touch_script_poll(hal.get_elapsed_ticks());
+#endif
+
+#if TFT_MIRROR_ENABLE
+        // Rate budget for the remote mirror, may invalidate coalesced areas
+        tft_mirror_poll(hal.get_elapsed_ticks());
+#endif
+
+#if TFT_REMOTE_INPUT_ENABLE
+        // Acknowledge timestamped remote input once it has been drawn
+        tft_remote_input_poll();
+#endif
+
         // Process LVGL tasks (event handling, animations, updates)
+#if TFT_TRACE_ENABLE
+        uint32_t frame_start = (uint32_t)esp_timer_get_time();
         lvgl_task_handler();
+        tft_trace_frame((uint32_t)esp_timer_get_time() - frame_start);
+#else
+        lvgl_task_handler();
+#endif
+
+        TFT_PROF_END(TFT_PROF_LOOP);
 
         // Precise timing using relative delay
-        vTaskDelayUntil(&xLastWakeTime, xFrequency);
+        tft_ui_wait(&xLastWakeTime, xFrequency);
     }
 }
 
 /*
- * Plugin initialization
- * Called by grblHAL during startup
+ * Apply changed runtime settings (UI task)
  */
-void tft_plugin_init(void) {
+static void tft_ui_apply_settings(uint32_t arg) {
+#if TFT_THROTTLE_ENABLE
+    tft_throttle_settings_changed();
+#else
+    lvgl_set_task_periods(tft_settings.refr_ms, tft_settings.indev_ms);
+#endif
+
+    lvgl_set_dma(tft_settings.dma);
+
+    if(!lvgl_set_buffer_lines(tft_settings.buffer_lines))
+        hal.stream.write("[MSG:TFT draw buffer resize failed, size kept]" ASCII_EOL);
+}
+
+/*
+ * Report the draw buffer size actually allocated
+ */
+static void tft_report_buffers(void) {
+    char msg[80];
+    lvgl_buffer_info_t info;
+
+    lvgl_get_buffer_info(&info);
+    snprintf(msg, sizeof(msg), "[MSG:TFT draw buffers %u x %u lines, %u bytes%s]" ASCII_EOL,
+              (unsigned)info.count, (unsigned)info.lines, (unsigned)info.bytes, info.auto_size ? ", auto" : "");
+    hal.stream.write(msg);
+}
+
+/*
+ * Start display, LVGL and the UI task with the loaded settings
+ */
+static void tft_ui_start(void) {
     // Initialize TFT display hardware
     tft_driver_init();
 
+#if TFT_BEEP_ENABLE
+    if(!tft_beep_init())
+        hal.stream.write("[MSG:TFT beeper timer creation failed]" ASCII_EOL);
+#endif
+
     // Initialize LVGL graphics library
-    lvgl_init();
+    if(!lvgl_init(tft_settings.buffer_lines)) {
+        hal.stream.write("[MSG:TFT draw buffer allocation failed]" ASCII_EOL);
+        return;
+    }
+    tft_report_buffers();
+    lvgl_set_dma(tft_settings.dma);
+    lvgl_set_task_periods(tft_settings.refr_ms, tft_settings.indev_ms);
+
+    tft_screenshot_init();
 
-    // Create FreeRTOS UI task on Core 0
+#if TFT_THROTTLE_ENABLE
+    tft_throttle_init();
+#endif
+
+#if TFT_AUTOMATION_ENABLE
+    tft_touch_script_init();
+#endif
+
+#if TFT_MIRROR_ENABLE
+    tft_mirror_init();
+#endif
+
+#if TFT_REMOTE_INPUT_ENABLE
+    if(!tft_remote_input_init())
+        hal.stream.write("[MSG:TFT remote input queue allocation failed]" ASCII_EOL);
+#endif
+
+#if TFT_IDLE_ENABLE
+    // Last, so scripted and remote touches also count as activity
+    tft_idle_init();
+#endif
+
+    // Create FreeRTOS UI task, Core 0 by default
     xTaskCreatePinnedToCore(
         tft_ui_task,                // Task function
         "TFT_UI",                   // Task name
         TFT_TASK_STACK_SIZE,        // Stack size (8192 bytes)
         NULL,                       // Parameters
-        TFT_TASK_PRIORITY,          // Priority (2)
-        NULL,                       // Task handle
-        TFT_TASK_CORE               // Core 0 (UI), Core 1 is for motion
+        tft_settings.task_priority, // Priority (2)
+        &ui_task,                   // Task handle
+        tft_settings.task_core      // Core 0 (UI), Core 1 is for motion
     );
 
+#if TFT_PROFILER_ENABLE
+    tft_profiler_init(ui_task);
+#endif
+}
+
+/*
+ * Settings loaded or changed: start the UI on first load, apply what can be applied at runtime afterwards
+ */
+static void tft_settings_changed(void) {
+    if(!ui_started) {
+        ui_started = true;
+        tft_ui_start();
+        return;
+    }
+
+    if(ui_task == NULL)
+        return;
+
+    vTaskPrioritySet(ui_task, tft_settings.task_priority);
+    tft_ui_call(tft_ui_apply_settings, 0);
+}
+
+/*
+ * Plugin initialization
+ * Called by grblHAL during startup
+ */
+void tft_plugin_init(void) {
+    // Event queue between grblHAL hooks and the UI task
+    if(!tft_events_init()) {
+        hal.stream.write("[MSG:TFT event queue allocation failed]" ASCII_EOL);
+        return;
+    }
+
     // Hook into grblHAL event system
     on_state_change = grbl.on_state_change;
     grbl.on_state_change = tft_state_changed;
@@ -236,6 +534,46 @@ void tft_plugin_init(void) {
     on_report_options = grbl.on_report_options;
     grbl.on_report_options = tft_report_options;
 
+    // Register $TFT diagnostics command
+    tft_commands_init();
+
+    // Command lines from the UI, read by the parser between host lines
+    tft_interface_init();
+
+#if TFT_STREAM_TAP_ENABLE
+    // Classify output lines sent to the host, from the first one
+    tft_stream_tap_init();
+#endif
+
+#if TFT_CONSOLE_ENABLE
+    // Scrollback for the console screen
+    tft_console_init();
+#endif
+
+    // Work offset cache for the realtime report
+    tft_offsets_init();
+
+    // Slider targets to override realtime commands
+    if(!tft_override_init())
+        hal.stream.write("[MSG:TFT override timer creation failed]" ASCII_EOL);
+
+#if TFT_PROBE_ENABLE
+    // Probe results for the wizards
+    tft_probe_init();
+#endif
+
+#if TFT_MACRO_ENABLE
+    // Macro table, loaded with the $ settings
+    tft_macro_init();
+#endif
+
+#if TFT_TRACE_ENABLE
+    tft_trace_init();
+#endif
+
+    // Display and UI task are started once the $ settings have been loaded
+    tft_settings_init(tft_settings_changed);
+
     // Print initialization message
     hal.stream.write("[TFT Plugin initialized]" ASCII_EOL);
 }
@@ -0,0 +1,513 @@
+/*
+ * tft_probe.c - Probing and tool length wizards
+ *
+ * Part of grblHAL TFT Plugin
+ *
+ * Copyright (c) 2025
+ *
+ */
+
+#include "driver.h"
+#include "tft_config.h"
+
+#if TFT_ENABLE && TFT_PROBE_ENABLE
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "grbl/hal.h"
+#include "grbl/system.h"
+#include "grbl/state_machine.h"
+#include "grbl/nuts_bolts.h"
+
+#include "tft_commands.h"
+#include "tft_events.h"
+#include "tft_interface.h"
+#include "tft_heightmap.h"
+#include "tft_probe.h"
+
+static const char *wizard_names[TFT_PROBE_WIZARD_COUNT] = {
+    [TFT_PROBE_Z] = "Z",
+    [TFT_PROBE_CORNER] = "CORNER",
+    [TFT_PROBE_TOOL] = "TOOL",
+    [TFT_PROBE_GRID] = "GRID"
+};
+
+static const char *state_names[] = {
+    [TFT_PROBE_IDLE] = "idle",
+    [TFT_PROBE_FAST] = "fast",
+    [TFT_PROBE_SLOW] = "slow",
+    [TFT_PROBE_DONE] = "done",
+    [TFT_PROBE_FAILED] = "failed"
+};
+
+static tft_probe_status_t status;
+
+static struct {
+    uint8_t axis;               // Axis being touched
+    int8_t dir;
+    float plate;
+    bool tool_ref;
+    float start[N_AXIS];        // First contact, the corner and grid wizards work from it
+    uint8_t nx, ny;             // Grid points
+    float dx, dy;               // and spacing
+} touch;
+
+// Lines sent for the current touch, checked as their status comes back
+static struct {
+    uint32_t ticket[8];
+    uint8_t sent;
+    uint8_t checked;
+    uint32_t due_ms;            // The touch times out
+} lines;
+
+static on_probe_completed_ptr on_probe_completed;
+
+/*
+ * Probe result, grblHAL task
+ */
+static void tft_probe_completed(void) {
+    // Not traced, a replayed probe result would drive a wizard
+    tft_event_t evt = { .type = TFT_EVT_PROBE };
+
+    evt.probe.ok = sys.flags.probe_succeeded;
+    system_convert_array_steps_to_mpos(evt.probe.mpos, sys.probe_position);
+    tft_event_post(&evt);
+
+    if(on_probe_completed)
+        on_probe_completed();
+}
+
+static bool running(void) {
+    return status.state == TFT_PROBE_FAST || status.state == TFT_PROBE_SLOW;
+}
+
+static void fail(const char *error) {
+    status.state = TFT_PROBE_FAILED;
+    status.error = error;
+}
+
+static void send(uint32_t ticket) {
+    if(status.state == TFT_PROBE_FAILED)
+        return;
+
+    if(ticket == 0 || lines.sent == sizeof(lines.ticket) / sizeof(uint32_t)) {
+        tft_stop();
+        fail("queue full");
+    } else
+        lines.ticket[lines.sent++] = ticket;
+}
+
+// A line of the wizard was rejected, the moves after it would be wrong
+static bool check_lines(void) {
+    status_code_t code;
+
+    while(lines.checked < lines.sent && tft_command_status(lines.ticket[lines.checked], &code)) {
+        lines.checked++;
+        if(code != Status_OK) {
+            status.code = code;
+            tft_stop();
+            fail("error");
+            return false;
+        }
+    }
+
+    return true;
+}
+
+// The lines of the next touch
+static void next_touch(void) {
+    lines.sent = lines.checked = 0;
+    lines.due_ms = hal.get_elapsed_ticks() + TFT_PROBE_TIMEOUT_MS;
+}
+
+// Fast touch, relative, at most travel mm along axis in dir
+static void touch_start(uint8_t axis, int8_t dir, float travel) {
+    if(status.state == TFT_PROBE_FAILED)
+        return;
+
+    touch.axis = axis;
+    touch.dir = dir;
+    status.state = TFT_PROBE_FAST;
+
+    send(tft_send_command_fmt("G91 G38.2 %c%.3f F%.0f\n", 'X' + axis, dir * travel, (double)TFT_PROBE_FAST_FEED));
+}
+
+// Single slow touch, the grid has many points and no plate to find first
+static void touch_once(uint8_t axis, int8_t dir, float travel) {
+    if(status.state == TFT_PROBE_FAILED)
+        return;
+
+    touch.axis = axis;
+    touch.dir = dir;
+    status.state = TFT_PROBE_SLOW;
+
+    send(tft_send_command_fmt("G91 G38.2 %c%.3f F%.0f\n", 'X' + axis, dir * travel, (double)TFT_GRID_FEED));
+}
+
+// Back off and touch again slowly
+static void touch_slow(void) {
+    next_touch();
+    status.state = TFT_PROBE_SLOW;
+
+    send(tft_send_command_fmt("G91 G0 %c%.3f\n", 'X' + touch.axis, -touch.dir * TFT_PROBE_BACKOFF));
+    send(tft_send_command_fmt("G38.2 %c%.3f F%.0f\n", 'X' + touch.axis, touch.dir * TFT_PROBE_BACKOFF * 2.0f,
+                               (double)TFT_PROBE_SLOW_FEED));
+}
+
+static void done(void) {
+    send(tft_send_command("G90\n"));
+
+    if(status.state != TFT_PROBE_FAILED)
+        status.state = TFT_PROBE_DONE;
+}
+
+/*
+ * Next step of each wizard, after status.touch touches. The machine sits
+ * at the contact point of the last one.
+ */
+
+/*
+ * Zeros are set with G10 L20 from where the machine sits, so G92 and a
+ * G43.1 tool offset are allowed for by the controller. status.offset keeps
+ * the zero in machine coordinates for the report.
+ */
+
+static void wizard_z(void) {
+    status.offset[Z_AXIS] = status.contact[Z_AXIS] - touch.plate;
+
+    send(tft_send_command_fmt("G10 L20 P0 Z%.3f\n", touch.plate));
+    send(tft_send_command_fmt("G91 G0 Z%.3f\n", TFT_PROBE_CLEARANCE));
+    done();
+}
+
+static void wizard_corner(void) {
+    const float r = TFT_PROBE_TIP_DIAMETER / 2.0f, clear = TFT_PROBE_CLEARANCE, depth = TFT_PROBE_CORNER_DEPTH,
+                 inset = TFT_PROBE_CORNER_INSET;
+
+    switch(status.touch) {
+
+        case 1:
+            // Top touched, drop beside the left face
+            memcpy(touch.start, status.contact, sizeof(touch.start));
+            status.offset[Z_AXIS] = status.contact[Z_AXIS] - touch.plate;
+
+            send(tft_send_command_fmt("G91 G0 Z%.3f\n", clear));
+            send(tft_send_command_fmt("G0 X%.3f\n", -(inset + clear)));
+            send(tft_send_command_fmt("G0 Z%.3f\n", -(clear + depth)));
+            touch_start(X_AXIS, 1, inset + 2.0f * clear);
+            break;
+
+        case 2:
+            // Left face touched, the tip centre stops a radius short of it. Over to the front face.
+            status.offset[X_AXIS] = status.contact[X_AXIS] + r;
+
+            send(tft_send_command_fmt("G91 G0 X%.3f\n", -clear));
+            send(tft_send_command_fmt("G0 Z%.3f\n", clear + depth));
+            send(tft_send_command_fmt("G53 G0 X%.3f Y%.3f\n", touch.start[X_AXIS], touch.start[Y_AXIS] - inset - clear));
+            send(tft_send_command_fmt("G91 G0 Z%.3f\n", -(clear + depth)));
+            touch_start(Y_AXIS, 1, inset + 2.0f * clear);
+            break;
+
+        default:
+            // Front face touched, still at it, a depth below the top and over the first touch in X
+            status.offset[Y_AXIS] = status.contact[Y_AXIS] + r;
+
+            send(tft_send_command_fmt("G10 L20 P0 X%.3f Y%.3f Z%.3f\n",
+                                       touch.start[X_AXIS] - status.offset[X_AXIS], -r, touch.plate - depth));
+            send(tft_send_command_fmt("G91 G0 Y%.3f\n", -clear));
+            send(tft_send_command_fmt("G0 Z%.3f\n", clear + depth));
+            done();
+            break;
+    }
+}
+
+static void wizard_tool(void) {
+    if(touch.tool_ref || !status.tool_ref_set) {
+        status.tool_ref = status.contact[Z_AXIS];
+        status.tool_ref_set = true;
+        status.tlo = 0.0f;
+        send(tft_send_command("G49\n"));
+    } else {
+        status.tlo = status.contact[Z_AXIS] - status.tool_ref;
+        send(tft_send_command_fmt("G43.1 Z%.3f\n", status.tlo));
+    }
+
+    send(tft_send_command_fmt("G53 G0 Z%.3f\n", TFT_PROBE_TOOL_SAFE_Z));
+    done();
+}
+
+// Grid point p, rows back and forth
+static void grid_point(uint16_t p, uint8_t *ix, uint8_t *iy) {
+    *iy = p / touch.nx;
+    *ix = (*iy & 1) ? touch.nx - 1 - p % touch.nx : p % touch.nx;
+}
+
+static void wizard_grid(void) {
+    uint8_t ix, iy;
+
+    if(status.touch == 1) {
+        memcpy(touch.start, status.contact, sizeof(touch.start));
+        if(!tft_heightmap_begin(touch.nx, touch.ny, touch.start[X_AXIS], touch.start[Y_AXIS], touch.dx, touch.dy)) {
+            fail("grid size");
+            return;
+        }
+    }
+
+    grid_point(status.touch - 1, &ix, &iy);
+    tft_heightmap_set(ix, iy, status.contact[Z_AXIS]);
+
+    send(tft_send_command_fmt("G91 G0 Z%.3f\n", TFT_PROBE_CLEARANCE));
+
+    if(status.touch == status.touches) {
+        done();
+        return;
+    }
+
+    grid_point(status.touch, &ix, &iy);
+    send(tft_send_command_fmt("G53 G0 X%.3f Y%.3f\n", touch.start[X_AXIS] + ix * touch.dx,
+                               touch.start[Y_AXIS] + iy * touch.dy));
+    touch_once(Z_AXIS, -1, TFT_PROBE_CLEARANCE + TFT_GRID_TRAVEL);
+}
+
+static void wizard_next(void) {
+    switch(status.wizard) {
+
+        case TFT_PROBE_Z:
+            wizard_z();
+            break;
+
+        case TFT_PROBE_CORNER:
+            wizard_corner();
+            break;
+
+        case TFT_PROBE_TOOL:
+            wizard_tool();
+            break;
+
+        case TFT_PROBE_GRID:
+            wizard_grid();
+            break;
+
+        default:
+            fail("wizard");
+            break;
+    }
+}
+
+bool tft_probe_start(tft_probe_wizard_t wizard, float plate, bool tool_ref) {
+    static const uint8_t touches[TFT_PROBE_WIZARD_COUNT] = { 1, 3, 1 };
+
+    if(running() || wizard >= TFT_PROBE_GRID || state_get() != STATE_IDLE)
+        return false;
+
+    status.wizard = wizard;
+    status.touch = 0;
+    status.touches = touches[wizard];
+    status.error = NULL;
+    status.code = Status_OK;
+    memset(status.offset, 0, sizeof(status.offset));
+    next_touch();
+    touch.plate = plate;
+    touch.tool_ref = tool_ref;
+
+    if(wizard == TFT_PROBE_TOOL) {
+        send(tft_send_command_fmt("G53 G0 Z%.3f\n", TFT_PROBE_TOOL_SAFE_Z));
+        send(tft_send_command_fmt("G53 G0 X%.3f Y%.3f\n", TFT_PROBE_TOOL_X, TFT_PROBE_TOOL_Y));
+        touch_start(Z_AXIS, -1, TFT_PROBE_TOOL_TRAVEL);
+    } else
+        touch_start(Z_AXIS, -1, TFT_PROBE_TRAVEL);
+
+    return true;
+}
+
+bool tft_probe_grid_start(float width, float depth, uint8_t nx, uint8_t ny) {
+    if(running() || state_get() != STATE_IDLE || nx == 0 || ny == 0 || nx * ny > TFT_HEIGHTMAP_POINTS)
+        return false;
+
+    status.wizard = TFT_PROBE_GRID;
+    status.touch = 0;
+    status.touches = nx * ny;
+    status.error = NULL;
+    status.code = Status_OK;
+    memset(status.offset, 0, sizeof(status.offset));
+    next_touch();
+    touch.nx = nx;
+    touch.ny = ny;
+    touch.dx = nx > 1 ? width / (nx - 1) : 0.0f;
+    touch.dy = ny > 1 ? depth / (ny - 1) : 0.0f;
+
+    touch_start(Z_AXIS, -1, TFT_PROBE_TRAVEL);
+
+    return true;
+}
+
+void tft_probe_abort(void) {
+    if(!running())
+        return;
+
+    tft_stop();
+    fail("aborted");
+}
+
+void tft_probe_event(const tft_event_t *evt) {
+    if(!running())
+        return;
+
+    switch((tft_event_type_t)evt->type) {
+
+        case TFT_EVT_PROBE:
+            if(!check_lines())
+                break;
+            if(!evt->probe.ok)
+                fail("no contact");
+            else if(status.state == TFT_PROBE_FAST)
+                touch_slow();
+            else {
+                memcpy(status.contact, evt->probe.mpos, sizeof(status.contact));
+                status.touch++;
+                next_touch();
+                wizard_next();
+            }
+            break;
+
+        case TFT_EVT_STATE:
+            if(evt->state.state & (STATE_ALARM | STATE_ESTOP))
+                fail("alarm");
+            break;
+
+        case TFT_EVT_RESET:
+            fail("reset");
+            break;
+
+        default:
+            break;
+    }
+}
+
+void tft_probe_poll(void) {
+    // The lines after the last touch are checked once it is done
+    if(!(running() || status.state == TFT_PROBE_DONE) || !check_lines() || !running())
+        return;
+
+    // A lost probe result, or a move that never ends
+    if((int32_t)(hal.get_elapsed_ticks() - lines.due_ms) >= 0) {
+        tft_stop();
+        fail("timeout");
+    }
+}
+
+const tft_probe_status_t *tft_probe_get_status(void) {
+    return &status;
+}
+
+/*
+ * $TFT=PROBE
+ */
+
+static struct {
+    tft_probe_wizard_t wizard;
+    float plate;
+    bool tool_ref;
+    float size[2];              // Grid width and depth
+    uint8_t points[2];          // Grid nx and ny
+} request;
+
+static void ui_probe_start(uint32_t arg) {
+    if(request.wizard == TFT_PROBE_GRID)
+        tft_probe_grid_start(request.size[0], request.size[1], request.points[0], request.points[1]);
+    else
+        tft_probe_start(request.wizard, request.plate, request.tool_ref);
+}
+
+static void ui_probe_abort(uint32_t arg) {
+    tft_probe_abort();
+}
+
+status_code_t tft_probe_command(char *args) {
+    char *arg = tft_command_arg(&args), *end;
+
+    if(arg == NULL) {
+        char msg[128];
+
+        snprintf(msg, sizeof(msg), "[TFTPROBE:%s,%s,touch=%u/%u%s%s]" ASCII_EOL, wizard_names[status.wizard],
+                  state_names[status.state], (unsigned)status.touch, (unsigned)status.touches,
+                  status.error ? ",error=" : "", status.error ? status.error : "");
+        if(status.code)
+            sprintf(strstr(msg, "]" ASCII_EOL), ",code=%u]" ASCII_EOL, (unsigned)status.code);
+        hal.stream.write(msg);
+
+        snprintf(msg, sizeof(msg), "[TFTPROBE:contact=%.3f,%.3f,%.3f,zero=%.3f,%.3f,%.3f]" ASCII_EOL,
+                  status.contact[X_AXIS], status.contact[Y_AXIS], status.contact[Z_AXIS],
+                  status.offset[X_AXIS], status.offset[Y_AXIS], status.offset[Z_AXIS]);
+        hal.stream.write(msg);
+
+        if(status.tool_ref_set) {
+            snprintf(msg, sizeof(msg), "[TFTPROBE:tool ref=%.3f,tlo=%.3f]" ASCII_EOL, status.tool_ref, status.tlo);
+            hal.stream.write(msg);
+        }
+
+        return Status_OK;
+    }
+
+    if(tft_command_is(arg, "ABORT"))
+        return args == NULL && tft_ui_call(ui_probe_abort, 0) ? Status_OK : Status_InvalidStatement;
+
+    if(running() || state_get() != STATE_IDLE)
+        return Status_IdleError;
+
+    request.plate = 0.0f;
+    request.tool_ref = false;
+
+    if(tft_command_is(arg, "Z")) {
+        request.wizard = TFT_PROBE_Z;
+        request.plate = TFT_PROBE_PLATE;
+        if((arg = tft_command_arg(&args))) {
+            request.plate = strtof(arg, &end);
+            if(*end)
+                return Status_BadNumberFormat;
+        }
+    } else if(tft_command_is(arg, "CORNER"))
+        request.wizard = TFT_PROBE_CORNER;
+    else if(tft_command_is(arg, "TOOL")) {
+        request.wizard = TFT_PROBE_TOOL;
+        if((arg = tft_command_arg(&args))) {
+            if(!tft_command_is(arg, "REF"))
+                return Status_InvalidStatement;
+            request.tool_ref = true;
+        }
+    } else if(tft_command_is(arg, "GRID")) {
+        request.wizard = TFT_PROBE_GRID;
+        for(uint_fast8_t i = 0; i < 2; i++) {
+            if((arg = tft_command_arg(&args)) == NULL)
+                return Status_InvalidStatement;
+            request.size[i] = strtof(arg, &end);
+            if(*end || request.size[i] < 0.0f)
+                return Status_BadNumberFormat;
+        }
+        for(uint_fast8_t i = 0; i < 2; i++) {
+            if((arg = tft_command_arg(&args)) == NULL)
+                return Status_InvalidStatement;
+            unsigned long n = strtoul(arg, &end, 10);
+            if(*end || n == 0 || n > UINT8_MAX)
+                return Status_BadNumberFormat;
+            request.points[i] = (uint8_t)n;
+        }
+        if(request.points[0] * request.points[1] > TFT_HEIGHTMAP_POINTS)
+            return Status_GcodeValueOutOfRange;
+    } else
+        return Status_InvalidStatement;
+
+    if(args)
+        return Status_InvalidStatement;
+
+    return tft_ui_call(ui_probe_start, 0) ? Status_OK : Status_InvalidStatement;
+}
+
+void tft_probe_init(void) {
+    on_probe_completed = grbl.on_probe_completed;
+    grbl.on_probe_completed = tft_probe_completed;
+}
+
+#endif // TFT_ENABLE && TFT_PROBE_ENABLE
@@ -0,0 +1,100 @@
+/*
+ * tft_probe.h - Probing and tool length wizards
+ *
+ * Part of grblHAL TFT Plugin
+ *
+ * Copyright (c) 2025
+ *
+ * Each wizard is a state machine stepped by the UI event queue, it never
+ * waits. A step sends the moves leading up to a touch as G-code lines and
+ * returns; the probe result comes back as a TFT_EVT_PROBE event posted
+ * from on_probe_completed, and the next step is planned from it. A touch
+ * is a fast G38.2 to find the surface, a back off and a slow G38.2 whose
+ * contact point is kept. An alarm, a rejected line, a reset or a touch
+ * taking over TFT_PROBE_TIMEOUT_MS while a wizard runs fails it.
+ *
+ *   Z       Touch the plate below, set the work Z zero with G10 L20
+ *   CORNER  Start above the stock, inset from its front left corner: touch
+ *           the top, the left and the front face, set X, Y and Z zero
+ *   TOOL    Touch the tool setter at TFT_PROBE_TOOL_X/Y. The first tool
+ *           (or REF) is the reference, later tools get G43.1 Z offsets.
+ *   GRID    Start above the front left point of a grid: touch nx x ny points
+ *           row by row, back and forth, into the heightmap (tft_heightmap.h).
+ *           One slow touch per point.
+ *
+ * Offsets go to the active work coordinate system (P0), set with L20 from
+ * the current position so G92 and tool offsets are allowed for. Probing
+ * moves are relative (G91), G90 is restored when the wizard completes.
+ */
+
+#ifndef _TFT_PROBE_H_
+#define _TFT_PROBE_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "grbl/hal.h"
+#include "tft_events.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef enum {
+    TFT_PROBE_Z = 0,
+    TFT_PROBE_CORNER,
+    TFT_PROBE_TOOL,
+    TFT_PROBE_GRID,
+    TFT_PROBE_WIZARD_COUNT
+} tft_probe_wizard_t;
+
+typedef enum {
+    TFT_PROBE_IDLE = 0,
+    TFT_PROBE_FAST,             // Fast touch running
+    TFT_PROBE_SLOW,             // Slow touch running
+    TFT_PROBE_DONE,
+    TFT_PROBE_FAILED
+} tft_probe_state_t;
+
+typedef struct {
+    tft_probe_wizard_t wizard;
+    tft_probe_state_t state;
+    uint16_t touch;             // Touches done
+    uint16_t touches;           // of
+    float contact[N_AXIS];      // Last slow touch, machine coordinates
+    float offset[N_AXIS];       // Work zero set by the wizard, machine coordinates
+    const char *error;          // Why it failed
+    status_code_t code;         // of the line rejected
+    bool tool_ref_set;
+    float tool_ref;             // Machine Z of the reference tool on the setter
+    float tlo;                  // Last tool length offset applied
+} tft_probe_status_t;
+
+// Hook on_probe_completed
+void tft_probe_init(void);
+
+// Start a wizard, false if one is running or the machine is not idle. plate is
+// the plate thickness (Z), tool_ref makes the tool the reference (TOOL). UI task.
+bool tft_probe_start(tft_probe_wizard_t wizard, float plate, bool tool_ref);
+
+// Start the grid wizard, width x depth mm from the current position. UI task.
+bool tft_probe_grid_start(float width, float depth, uint8_t nx, uint8_t ny);
+
+// Stop a running wizard and the motion. UI task.
+void tft_probe_abort(void);
+
+// Step the running wizard, call with every event taken from the queue. UI task.
+void tft_probe_event(const tft_event_t *evt);
+
+// Check the status of the lines sent and the touch timeout, call every UI loop. UI task.
+void tft_probe_poll(void);
+
+const tft_probe_status_t *tft_probe_get_status(void);
+
+// $TFT=PROBE[,Z[,<plate>]|CORNER|TOOL[,REF]|GRID,<width>,<depth>,<nx>,<ny>|ABORT]
+status_code_t tft_probe_command(char *args);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // _TFT_PROBE_H_
@@ -0,0 +1,141 @@
+/*
+ * tft_profiler.c - UI task CPU, stack and frame phase profiler
+ *
+ * Part of grblHAL TFT Plugin
+ *
+ * Copyright (c) 2025
+ *
+ */
+
+#include "driver.h"
+
+#if TFT_ENABLE && TFT_PROFILER_ENABLE
+
+#include <stdio.h>
+#include <string.h>
+
+#include "esp_timer.h"
+#include "grbl/hal.h"
+
+#include "tft_profiler.h"
+
+static const char *const slot_name[TFT_PROF_COUNT] = {
+    "loop", "lv_task", "render", "flush", "touch",
+    "state_change", "realtime_report", "program_completed", "reset"
+};
+
+typedef struct {
+    uint32_t calls;
+    uint32_t max_us;
+    uint64_t total_us;
+} prof_stat_t;
+
+// stat and frames are shared by the UI task (core 0) and the grblHAL hooks (core 1)
+static struct {
+    prof_stat_t stat[TFT_PROF_COUNT];
+    uint32_t frames;            // lv_task_handler() calls that flushed
+    int64_t start_us;           // Start of measuring period, 64 bit so periods past 71 minutes report right
+    uint32_t frame_t0;          // Current lv_task_handler() start
+    uint32_t frame_flush_us;    // Flush time within current lv_task_handler()
+    uint32_t frame_flushes;     // Flush calls within current lv_task_handler()
+} prof;
+
+static TaskHandle_t ui_task_handle;
+static portMUX_TYPE lock = portMUX_INITIALIZER_UNLOCKED;
+
+uint32_t tft_profiler_now(void) {
+    return (uint32_t)esp_timer_get_time();
+}
+
+void tft_profiler_init(void *ui_task) {
+    ui_task_handle = (TaskHandle_t)ui_task;
+    tft_profiler_reset();
+}
+
+void tft_profiler_add(tft_prof_slot_t slot, uint32_t us) {
+    prof_stat_t *stat = &prof.stat[slot];
+
+    portENTER_CRITICAL(&lock);
+    stat->calls++;
+    stat->total_us += us;
+    if(us > stat->max_us)
+        stat->max_us = us;
+    portEXIT_CRITICAL(&lock);
+
+    // UI task only
+    if(slot == TFT_PROF_FLUSH) {
+        prof.frame_flush_us += us;
+        prof.frame_flushes++;
+    }
+}
+
+void tft_profiler_frame_begin(void) {
+    prof.frame_flush_us = prof.frame_flushes = 0;
+    prof.frame_t0 = tft_profiler_now();
+}
+
+void tft_profiler_frame_end(void) {
+    uint32_t us = tft_profiler_now() - prof.frame_t0;
+
+    tft_profiler_add(TFT_PROF_LV_TASK, us);
+
+    if(prof.frame_flushes) {
+        portENTER_CRITICAL(&lock);
+        prof.frames++;
+        portEXIT_CRITICAL(&lock);
+        tft_profiler_add(TFT_PROF_RENDER, us - prof.frame_flush_us);
+    }
+}
+
+void tft_profiler_reset(void) {
+    portENTER_CRITICAL(&lock);
+    memset(prof.stat, 0, sizeof(prof.stat));
+    prof.frames = 0;
+    prof.start_us = esp_timer_get_time();
+    portEXIT_CRITICAL(&lock);
+}
+
+void tft_profiler_report(void) {
+    char buf[96];
+    prof_stat_t stats[TFT_PROF_COUNT];
+    uint32_t frames;
+    int64_t elapsed_us;
+
+    // Consistent copy, the sections keep running while it is written out
+    portENTER_CRITICAL(&lock);
+    memcpy(stats, prof.stat, sizeof(stats));
+    frames = prof.frames;
+    elapsed_us = esp_timer_get_time() - prof.start_us;
+    portEXIT_CRITICAL(&lock);
+
+    float elapsed_s = (float)elapsed_us / 1000000.0f;
+
+    if(elapsed_us <= 0)
+        return;
+
+    for(uint_fast8_t i = 0; i < TFT_PROF_COUNT; i++) {
+        prof_stat_t *stat = &stats[i];
+        snprintf(buf, sizeof(buf), "[TFTPROF:%s,calls=%u,avg_us=%u,max_us=%u,total_ms=%u]" ASCII_EOL,
+                  slot_name[i],
+                  (unsigned)stat->calls,
+                  (unsigned)(stat->calls ? stat->total_us / stat->calls : 0),
+                  (unsigned)stat->max_us,
+                  (unsigned)(stat->total_us / 1000));
+        hal.stream.write(buf);
+    }
+
+    snprintf(buf, sizeof(buf), "[TFTPROF:fps=%.1f,cpu=%.1f%%,period_s=%.1f]" ASCII_EOL,
+              (float)frames / elapsed_s,
+              (float)stats[TFT_PROF_LOOP].total_us * 100.0f / (float)elapsed_us,
+              elapsed_s);
+    hal.stream.write(buf);
+
+    if(ui_task_handle) {
+        snprintf(buf, sizeof(buf), "[TFTPROF:stack_free=%u,stack_size=%u]" ASCII_EOL,
+                  (unsigned)uxTaskGetStackHighWaterMark(ui_task_handle),
+                  (unsigned)TFT_TASK_STACK_SIZE);
+        hal.stream.write(buf);
+    }
+}
+
+#endif // TFT_ENABLE && TFT_PROFILER_ENABLE
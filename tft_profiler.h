@@ -0,0 +1,77 @@
+/*
+ * tft_profiler.h - UI task CPU, stack and frame phase profiler
+ *
+ * Part of grblHAL TFT Plugin
+ *
+ * Copyright (c) 2025
+ *
+ * Accumulates call count, total and peak time per measured section.
+ * Reported and reset with $TFT=PROF and $TFT=PROF,RESET.
+ * With TFT_PROFILER_ENABLE 0 all TFT_PROF_* macros compile to nothing.
+ */
+
+#ifndef _TFT_PROFILER_H_
+#define _TFT_PROFILER_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "tft_config.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Measured sections
+typedef enum {
+    TFT_PROF_LOOP = 0,          // UI task loop body (busy time on core)
+    TFT_PROF_LV_TASK,           // lv_task_handler() total
+    TFT_PROF_RENDER,            // lv_task_handler() minus flush
+    TFT_PROF_FLUSH,             // lvgl_display_flush()
+    TFT_PROF_TOUCH,             // lvgl_touch_read()
+    TFT_PROF_HOOK_STATE,        // on_state_change handler
+    TFT_PROF_HOOK_REPORT,       // on_realtime_report handler
+    TFT_PROF_HOOK_PROGRAM,      // on_program_completed handler
+    TFT_PROF_HOOK_RESET,        // driver_reset handler
+    TFT_PROF_COUNT
+} tft_prof_slot_t;
+
+#if TFT_PROFILER_ENABLE
+
+// Set UI task handle (for stack high-water mark) and start the clock
+void tft_profiler_init(void *ui_task);
+
+// Microsecond timestamp
+uint32_t tft_profiler_now(void);
+
+// Add a sample to a section
+void tft_profiler_add(tft_prof_slot_t slot, uint32_t us);
+
+// Bracket lv_task_handler(), splits render and flush time and counts frames
+void tft_profiler_frame_begin(void);
+void tft_profiler_frame_end(void);
+
+// Output report to stream
+void tft_profiler_report(void);
+
+// Clear all counters
+void tft_profiler_reset(void);
+
+#define TFT_PROF_BEGIN(slot)    uint32_t prof_t0_##slot = tft_profiler_now()
+#define TFT_PROF_END(slot)      tft_profiler_add(slot, tft_profiler_now() - prof_t0_##slot)
+#define TFT_PROF_FRAME_BEGIN()  tft_profiler_frame_begin()
+#define TFT_PROF_FRAME_END()    tft_profiler_frame_end()
+
+#else
+
+#define TFT_PROF_BEGIN(slot)
+#define TFT_PROF_END(slot)
+#define TFT_PROF_FRAME_BEGIN()
+#define TFT_PROF_FRAME_END()
+
+#endif // TFT_PROFILER_ENABLE
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // _TFT_PROFILER_H_
@@ -0,0 +1,312 @@
+/*
+ * tft_remote_input.c - Remote pointer and key injection
+ *
+ * Part of grblHAL TFT Plugin
+ *
+ * Copyright (c) 2025
+ *
+ */
+
+#include "driver.h"
+
+#if TFT_ENABLE && TFT_REMOTE_INPUT_ENABLE
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "esp_timer.h"
+#include "grbl/hal.h"
+
+#include "tft_config.h"
+#include "tft_commands.h"
+#include "tft_remote_input.h"
+#include "lvgl_init.h"
+
+typedef struct {
+    uint16_t x, y;              // Pointer events
+    uint32_t key;               // Key events, LV_KEY_* or character
+    bool pressed;               // Pointer events
+    bool has_t;
+    uint32_t t;                 // Host timestamp, echoed back
+    uint32_t rx_us;             // Time the command was received
+} remote_event_t;
+
+static QueueHandle_t pointer_queue = NULL, key_queue = NULL;
+
+// UI task state
+static struct {
+    bool pressed;
+    uint16_t x, y;
+    uint32_t key;
+    bool key_down;
+    uint32_t physical_ms;       // Last time the panel was touched
+    uint32_t applied;
+    uint32_t dropped;           // Dropped or released because of physical touch
+} remote;
+
+static struct {
+    bool pending;
+    bool flushed;
+    uint32_t t;
+    uint32_t queue_us;
+    uint32_t applied_us;
+    uint32_t flush_us;
+} ack;
+
+static uint32_t queue_full = 0;
+static lv_group_t *group = NULL;
+
+static lvgl_touch_filter_ptr touch_filter;
+static lvgl_flush_tap_ptr flush_tap;
+
+static const struct {
+    const char *name;
+    uint32_t key;
+} key_names[] = {
+    { "UP", LV_KEY_UP },
+    { "DOWN", LV_KEY_DOWN },
+    { "LEFT", LV_KEY_LEFT },
+    { "RIGHT", LV_KEY_RIGHT },
+    { "ENTER", LV_KEY_ENTER },
+    { "ESC", LV_KEY_ESC },
+    { "DEL", LV_KEY_DEL },
+    { "BACKSPACE", LV_KEY_BACKSPACE },
+    { "NEXT", LV_KEY_NEXT },
+    { "PREV", LV_KEY_PREV },
+    { "HOME", LV_KEY_HOME },
+    { "END", LV_KEY_END }
+};
+
+/*
+ * Acknowledgement
+ */
+
+static void ack_send(void) {
+    char msg[80];
+
+    snprintf(msg, sizeof(msg), "[TFTIN:ACK,t=%u,queue_us=%u,flush_us=%d]" ASCII_EOL,
+              (unsigned)ack.t, (unsigned)ack.queue_us, ack.flushed ? (int)(ack.flush_us - ack.applied_us) : -1);
+    hal.stream.write(msg);
+    ack.pending = false;
+}
+
+static void ack_start(const remote_event_t *evt) {
+    if(!evt->has_t)
+        return;
+
+    if(ack.pending)
+        ack_send();
+
+    ack.pending = true;
+    ack.flushed = false;
+    ack.t = evt->t;
+    ack.applied_us = (uint32_t)esp_timer_get_time();
+    ack.queue_us = ack.applied_us - evt->rx_us;
+}
+
+static void remote_flush_tap(const lv_area_t *area, const lv_color_t *pixels) {
+    if(flush_tap)
+        flush_tap(area, pixels);
+
+    if(ack.pending && !ack.flushed) {
+        ack.flushed = true;
+        ack.flush_us = (uint32_t)esp_timer_get_time();
+    }
+}
+
+void tft_remote_input_poll(void) {
+    if(ack.pending && (ack.flushed || (uint32_t)esp_timer_get_time() - ack.applied_us > TFT_LATENCY_TIMEOUT_MS * 1000UL))
+        ack_send();
+}
+
+/*
+ * Input path
+ */
+
+static bool physical_holdoff(void) {
+    return hal.get_elapsed_ticks() - remote.physical_ms < TFT_REMOTE_HOLDOFF_MS;
+}
+
+static void drop_queued(QueueHandle_t queue) {
+    remote_event_t evt;
+
+    while(xQueueReceive(queue, &evt, 0) == pdTRUE)
+        remote.dropped++;
+}
+
+static bool remote_touch_filter(bool touched, uint16_t *x, uint16_t *y) {
+    remote_event_t evt;
+    bool physical = touched;
+
+    // Panel state is taken before chaining, scripted touches are not physical
+    if(touch_filter)
+        touched = touch_filter(touched, x, y);
+
+    // Physical touch owns the pointer
+    if(physical) {
+        remote.physical_ms = hal.get_elapsed_ticks();
+        if(remote.pressed) {
+            remote.pressed = false;
+            remote.dropped++;
+        }
+        drop_queued(pointer_queue);
+        return touched;
+    }
+
+    if(physical_holdoff()) {
+        drop_queued(pointer_queue);
+        return touched;
+    }
+
+    // One event per read so LVGL sees every press and release
+    if(xQueueReceive(pointer_queue, &evt, 0) == pdTRUE) {
+        remote.pressed = evt.pressed;
+        if(evt.pressed) {
+            remote.x = evt.x;
+            remote.y = evt.y;
+        }
+        remote.applied++;
+        ack_start(&evt);
+    }
+
+    if(remote.pressed) {
+        *x = remote.x;
+        *y = remote.y;
+        return true;
+    }
+
+    // Scripted touch, if any
+    return touched;
+}
+
+static bool remote_key_read(lv_indev_drv_t *indev, lv_indev_data_t *data) {
+    remote_event_t evt;
+
+    // Release the previous key before the next one is pressed
+    if(remote.key_down)
+        remote.key_down = false;
+    else if(xQueueReceive(key_queue, &evt, 0) == pdTRUE) {
+        if(physical_holdoff())
+            remote.dropped++;
+        else {
+            remote.key = evt.key;
+            remote.key_down = true;
+            remote.applied++;
+            ack_start(&evt);
+        }
+    }
+
+    data->key = remote.key;
+    data->state = remote.key_down ? LV_INDEV_STATE_PR : LV_INDEV_STATE_REL;
+
+    return false;
+}
+
+lv_group_t *tft_remote_input_group(void) {
+    return group;
+}
+
+/*
+ * $TFT=IN
+ */
+
+static bool parse_key(const char *arg, uint32_t *key) {
+    for(uint_fast8_t i = 0; i < sizeof(key_names) / sizeof(key_names[0]); i++) {
+        if(tft_command_is(arg, key_names[i].name)) {
+            *key = key_names[i].key;
+            return true;
+        }
+    }
+
+    // Single printable character
+    if(arg[0] > ' ' && arg[0] < 0x7F && arg[1] == '\0') {
+        *key = (uint32_t)arg[0];
+        return true;
+    }
+
+    return false;
+}
+
+status_code_t tft_remote_input_command(char *args) {
+    char *arg = tft_command_arg(&args), *end;
+    remote_event_t evt = {0};
+    QueueHandle_t queue = pointer_queue;
+
+    if(arg == NULL) {
+        char msg[80];
+        snprintf(msg, sizeof(msg), "[TFTIN:applied=%u,dropped=%u,queue_full=%u]" ASCII_EOL,
+                  (unsigned)remote.applied, (unsigned)remote.dropped, (unsigned)queue_full);
+        hal.stream.write(msg);
+        return Status_OK;
+    }
+
+    evt.rx_us = (uint32_t)esp_timer_get_time();
+
+    if(tft_command_is(arg, "P")) {
+        char *x = tft_command_arg(&args), *y = tft_command_arg(&args);
+        unsigned long vx, vy;
+
+        if(x == NULL || y == NULL)
+            return Status_InvalidStatement;
+
+        vx = strtoul(x, &end, 10);
+        if(*end || vx >= TFT_DISPLAY_WIDTH)
+            return Status_InvalidStatement;
+        vy = strtoul(y, &end, 10);
+        if(*end || vy >= TFT_DISPLAY_HEIGHT)
+            return Status_InvalidStatement;
+
+        evt.pressed = true;
+        evt.x = (uint16_t)vx;
+        evt.y = (uint16_t)vy;
+    } else if(tft_command_is(arg, "K")) {
+        char *key = tft_command_arg(&args);
+
+        if(key == NULL || !parse_key(key, &evt.key))
+            return Status_InvalidStatement;
+
+        queue = key_queue;
+    } else if(!tft_command_is(arg, "R"))
+        return Status_InvalidStatement;
+
+    // Optional host timestamp
+    if((arg = tft_command_arg(&args))) {
+        evt.t = strtoul(arg, &end, 10);
+        if(*end || args)
+            return Status_InvalidStatement;
+        evt.has_t = true;
+    }
+
+    if(xQueueSend(queue, &evt, 0) != pdTRUE) {
+        queue_full++;
+        return Status_InvalidStatement;
+    }
+
+    return Status_OK;
+}
+
+bool tft_remote_input_init(void) {
+    pointer_queue = xQueueCreate(TFT_REMOTE_QUEUE_SIZE, sizeof(remote_event_t));
+    key_queue = xQueueCreate(TFT_REMOTE_QUEUE_SIZE, sizeof(remote_event_t));
+
+    if(pointer_queue == NULL || key_queue == NULL)
+        return false;
+
+    touch_filter = lvgl_set_touch_filter(remote_touch_filter);
+    flush_tap = lvgl_set_flush_tap(remote_flush_tap);
+
+    lv_indev_drv_t indev_drv;
+    lv_indev_drv_init(&indev_drv);
+    indev_drv.type = LV_INDEV_TYPE_KEYPAD;
+    indev_drv.read_cb = remote_key_read;
+    lv_indev_t *keypad = lv_indev_drv_register(&indev_drv);
+
+    // Focusable objects are added by the screens (tft_screen_focus()), the lists draw their own cursor
+    group = lv_group_create();
+    lv_group_set_style_mod_cb(group, NULL);
+    lv_indev_set_group(keypad, group);
+
+    return true;
+}
+
+#endif // TFT_ENABLE && TFT_REMOTE_INPUT_ENABLE
@@ -0,0 +1,50 @@
+/*
+ * tft_remote_input.h - Remote pointer and key injection
+ *
+ * Part of grblHAL TFT Plugin
+ *
+ * Copyright (c) 2025
+ *
+ * Pointer and key events sent with $TFT=IN (serial or telnet) are queued
+ * for the UI task and merged with the panel in the lvgl_touch_read() filter
+ * chain, keys go to a keypad input device. Physical touch always wins:
+ * while the panel is touched, and for TFT_REMOTE_HOLDOFF_MS after release,
+ * remote events are dropped and a remote press is released. Scripted
+ * touches ($TFT=TOUCH) are not physical, the panel is read before them.
+ *
+ * An event may carry a host timestamp. The plugin echoes it back once the
+ * event has been applied and the first area after it has been flushed:
+ *
+ *   [TFTIN:ACK,t=<host t>,queue_us=<received to applied>,flush_us=<applied to flush or -1>]
+ *
+ * so tools/tft_input.py can measure host to panel latency end to end.
+ */
+
+#ifndef _TFT_REMOTE_INPUT_H_
+#define _TFT_REMOTE_INPUT_H_
+
+#include <stdint.h>
+#include <lvgl.h>
+#include "grbl/hal.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Create queues, install touch filter and flush tap, register keypad, call once after lvgl_init()
+bool tft_remote_input_init(void);
+
+// Send pending acknowledgement, call from UI task outside lv_task_handler()
+void tft_remote_input_poll(void);
+
+// Group fed by the remote keypad, screens add focusable objects with tft_screen_focus()
+lv_group_t *tft_remote_input_group(void);
+
+// $TFT=IN[,P,x,y[,t]|R[,t]|K,<key>[,t]]
+status_code_t tft_remote_input_command(char *args);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // _TFT_REMOTE_INPUT_H_
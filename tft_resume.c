@@ -0,0 +1,480 @@
+/*
+ * tft_resume.c - Resume a job from a line
+ *
+ * Part of grblHAL TFT Plugin
+ *
+ * Copyright (c) 2025
+ *
+ */
+
+#include "driver.h"
+#include "tft_config.h"
+
+#if TFT_ENABLE && TFT_RESUME_ENABLE
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdarg.h>
+#include <ctype.h>
+
+#include "grbl/hal.h"
+#include "grbl/vfs.h"
+#include "grbl/state_machine.h"
+
+#include "tft_commands.h"
+#include "tft_events.h"
+#include "tft_interface.h"
+#include "tft_modal.h"
+#include "tft_resume.h"
+
+typedef struct {
+    uint32_t line;
+    uint32_t offset;            // File offset of the line
+    tft_modal_t modal;
+} checkpoint_t;
+
+static const char *const state_names[] = {
+    "idle", "scanning", "scanned", "replaying", "writing", "ready", "started", "failed"
+};
+
+static checkpoint_t checkpoint[TFT_RESUME_CHECKPOINTS];
+static tft_resume_status_t status;
+static char path[64];
+static bool scanned = false;    // Checkpoints are for path
+static uint32_t last_line;      // Last line reported executing by a job started here
+static uint32_t start_ticket;   // of the $F= line
+static bool job;                // A job started here is running
+
+static struct {
+    vfs_file_t *in, *out;
+    char buf[256];              // Read ahead
+    uint16_t pos, len;
+    uint32_t offset;            // File offset of buf[pos]
+    char line[TFT_RESUME_LINE_MAX + 1];
+    bool too_long;              // line is cut short
+    uint32_t line_start;        // File offset of line
+    uint32_t line_no;           // Number of the next line
+    bool run;
+    tft_modal_t modal;
+} io;
+
+static void close_files(void) {
+    if(io.in)
+        vfs_close(io.in);
+    if(io.out)
+        vfs_close(io.out);
+    io.in = io.out = NULL;
+}
+
+static void fail(const char *error) {
+    close_files();
+    status.state = TFT_RESUME_FAILED;
+    status.error = error;
+}
+
+static bool busy(void) {
+    return status.state == TFT_RESUME_SCANNING || status.state == TFT_RESUME_REPLAYING ||
+            status.state == TFT_RESUME_WRITING;
+}
+
+// Next line of io.in into io.line, false at the end of the file
+static bool read_line(void) {
+    uint16_t len = 0;
+
+    io.line_start = io.offset;
+    io.too_long = false;
+
+    for(;;) {
+        if(io.pos == io.len) {
+            io.pos = 0;
+            if((io.len = (uint16_t)vfs_read(io.buf, 1, sizeof(io.buf), io.in)) == 0)
+                break;
+        }
+
+        char c = io.buf[io.pos++];
+        io.offset++;
+
+        if(c == '\n')
+            break;
+        if(c == '\r')
+            continue;
+        if(len < TFT_RESUME_LINE_MAX)
+            io.line[len++] = c;
+        else
+            io.too_long = true;
+    }
+
+    io.line[len] = '\0';
+
+    return io.offset > io.line_start;
+}
+
+/*
+ * Scanning
+ */
+
+static void add_checkpoint(void) {
+    // Full, keep every other one
+    if(status.checkpoints == TFT_RESUME_CHECKPOINTS) {
+        for(uint_fast16_t i = 0; i < TFT_RESUME_CHECKPOINTS / 2; i++)
+            checkpoint[i] = checkpoint[i * 2];
+        status.checkpoints = TFT_RESUME_CHECKPOINTS / 2;
+        status.interval *= 2;
+
+        if((status.lines - 1) % status.interval)
+            return;
+    }
+
+    checkpoint[status.checkpoints].line = status.lines;
+    checkpoint[status.checkpoints].offset = io.line_start;
+    checkpoint[status.checkpoints].modal = io.modal;
+    status.checkpoints++;
+}
+
+bool tft_resume_scan(const char *file) {
+    if(busy() || strlen(file) >= sizeof(path))
+        return false;
+
+    close_files();
+    memset(&io, 0, sizeof(io));
+    memset(&status, 0, sizeof(tft_resume_status_t));
+    strcpy(path, file);
+    scanned = false;
+    last_line = 0;
+
+    if((io.in = vfs_open(path, "r")) == NULL) {
+        fail("can't open");
+        return false;
+    }
+
+    io.modal = tft_modal_default;
+    status.interval = TFT_RESUME_INTERVAL;
+    status.state = TFT_RESUME_SCANNING;
+
+    return true;
+}
+
+/*
+ * Resuming
+ */
+
+static bool out(const char *fmt, ...) {
+    char buf[96];
+    va_list args;
+
+    va_start(args, fmt);
+    int n = vsnprintf(buf, sizeof(buf), fmt, args);
+    va_end(args);
+
+    return n > 0 && vfs_write(buf, 1, n, io.out) == (size_t)n;
+}
+
+// Restore the state before the resume line, safely
+static bool write_prefix(void) {
+    const tft_modal_t *m = &io.modal;
+    float mm = m->inches ? 25.4f : 1.0f, plunge = TFT_RESUME_PLUNGE_FEED / mm;
+
+    if(m->feed > 0.0f && m->feed < plunge)
+        plunge = m->feed;
+
+    bool ok = out("(Resume %s at line %u)\n", path, (unsigned)status.line) &&
+               out("G21 G90 G%u G%u\n", (unsigned)m->plane, 54 + (unsigned)m->wcs) &&
+               out("G53 G0 Z%.3f\n", TFT_RESUME_SAFE_Z);
+
+    if(ok && m->spindle != 5)
+        ok = out("M%u S%.0f\n", (unsigned)m->spindle, m->rpm) && out("G4 P%.1f\n", TFT_RESUME_SPINUP_S);
+    else if(ok)
+        ok = out("M5\n");
+
+    if(ok)
+        ok = m->coolant ? (!(m->coolant & 1) || out("M7\n")) && (!(m->coolant & 2) || out("M8\n")) : out("M9\n");
+
+    if(ok)
+        ok = out("G%u\n", m->inches ? 20 : 21);
+
+    // Before the moves, the work position of Z depends on it
+    if(ok && m->tlo_mode == TFT_TLO_DYNAMIC)
+        ok = out("G43.1 Z%.4f\n", m->tlo);
+    else if(ok && m->tlo_mode == TFT_TLO_TOOL)
+        ok = out("G43 H%u\n", (unsigned)m->tool);
+    else if(ok && m->tlo_mode == TFT_TLO_CANCELLED)
+        ok = out("G49\n");
+
+    return ok &&
+            out("G0 X%.4f Y%.4f\n", m->pos[0], m->pos[1]) &&
+            out("G0 Z%.4f\n", m->pos[2] + TFT_RESUME_CLEARANCE / mm) &&
+            out("G1 Z%.4f F%.1f\n", m->pos[2], plunge) &&
+            out("G%u G%u", m->motion == 0 ? 0 : 1, m->incremental ? 91 : 90) &&
+            (m->feed > 0.0f ? out(" F%.1f\n", m->feed) : out("\n"));
+}
+
+// Copy io.line numbered with its line in the scanned file, an N word of its own is replaced
+static bool write_line(void) {
+    const char *s = io.line;
+
+    while(*s == ' ' || *s == '\t')
+        s++;
+
+    if(!isalpha((unsigned char)*s))
+        return vfs_write(io.line, 1, strlen(io.line), io.out) == strlen(io.line) && out("\n");
+
+    if(toupper((unsigned char)*s) == 'N') {
+        s++;
+        while(isdigit((unsigned char)*s) || *s == ' ' || *s == '\t')
+            s++;
+    }
+
+    return out("N%u ", (unsigned)io.line_no) && vfs_write(s, 1, strlen(s), io.out) == strlen(s) && out("\n");
+}
+
+// From line 1 the file is run as it is, renumbered, without a prefix
+static void start_writing(void) {
+    bool from_start = status.line == 1;
+
+    if(!from_start && io.modal.g92)
+        fail("G92 offset");
+    else if(!from_start && io.modal.known != 0x07)
+        fail("position unknown");
+    else if(!from_start && io.modal.tlo_mode == TFT_TLO_UNKNOWN)
+        fail("tool offset");
+    else if((io.out = vfs_open(TFT_RESUME_FILE, "w")) == NULL)
+        fail("can't create");
+    else if(!from_start && !write_prefix())
+        fail("write");
+    else {
+        status.state = TFT_RESUME_WRITING;
+        status.bytes = 0;
+    }
+}
+
+static void started(void) {
+    if(!io.run)
+        return;
+
+    if(state_get() != STATE_IDLE) {
+        status.error = "not idle";
+        return;
+    }
+
+    if((start_ticket = tft_send_command("$F=" TFT_RESUME_FILE "\n")) == 0) {
+        status.error = "queue full";
+        return;
+    }
+
+    status.state = TFT_RESUME_STARTED;
+}
+
+bool tft_resume_prepare(uint32_t line, bool run) {
+    uint_fast16_t lo = 0, hi;
+
+    if(busy() || !scanned || line == 0 || line > status.lines)
+        return false;
+
+    // Last checkpoint at or before line
+    hi = status.checkpoints;
+    while(hi - lo > 1) {
+        uint_fast16_t mid = (lo + hi) / 2;
+        if(checkpoint[mid].line <= line)
+            lo = mid;
+        else
+            hi = mid;
+    }
+
+    close_files();
+    status.line = line;
+    status.from = checkpoint[lo].line;
+    status.error = NULL;
+    status.bytes = 0;
+
+    if((io.in = vfs_open(path, "r")) == NULL || vfs_seek(io.in, checkpoint[lo].offset) != 0) {
+        fail("can't open");
+        return false;
+    }
+
+    io.pos = io.len = 0;
+    io.offset = checkpoint[lo].offset;
+    io.line_no = checkpoint[lo].line;
+    io.modal = checkpoint[lo].modal;
+    io.run = run;
+    status.state = TFT_RESUME_REPLAYING;
+
+    return true;
+}
+
+void tft_resume_abort(void) {
+    if(!busy())
+        return;
+
+    if(status.state == TFT_RESUME_SCANNING)
+        scanned = false;
+
+    fail("aborted");
+}
+
+void tft_resume_poll(void) {
+    status_code_t code;
+    uint32_t end;
+
+    // The job runs once $F= is accepted
+    if(start_ticket && tft_command_status(start_ticket, &code)) {
+        start_ticket = 0;
+        if(code == Status_OK)
+            job = true;
+        else
+            fail("start rejected");
+    }
+
+    if(!busy())
+        return;
+
+    end = io.offset + TFT_RESUME_CHUNK;
+
+    while(busy() && (int32_t)(io.offset - end) < 0) {
+        switch(status.state) {
+
+            case TFT_RESUME_SCANNING:
+                if(!read_line()) {
+                    close_files();
+                    scanned = true;
+                    status.state = TFT_RESUME_SCANNED;
+                    break;
+                }
+                status.lines++;
+                if((status.lines - 1) % status.interval == 0)
+                    add_checkpoint();
+                tft_modal_apply(&io.modal, io.line);
+                break;
+
+            case TFT_RESUME_REPLAYING:
+                if(io.line_no == status.line)
+                    start_writing();
+                else if(!read_line())
+                    fail("file changed");
+                else {
+                    tft_modal_apply(&io.modal, io.line);
+                    io.line_no++;
+                }
+                break;
+
+            case TFT_RESUME_WRITING:
+                if(!read_line()) {
+                    close_files();
+                    status.state = TFT_RESUME_READY;
+                    started();
+                } else if(io.too_long)
+                    fail("line too long");
+                else if(!write_line())
+                    fail("write");
+                else
+                    io.line_no++;
+                break;
+
+            default:
+                break;
+        }
+    }
+
+    status.bytes += io.offset - (end - TFT_RESUME_CHUNK);
+}
+
+void tft_resume_set_line(uint32_t line) {
+    if(job && line)
+        last_line = line;
+}
+
+void tft_resume_event(const tft_event_t *evt) {
+    // Ended or stopped, the last line is kept for LAST
+    if(evt->type == TFT_EVT_PROGRAM || evt->type == TFT_EVT_RESET)
+        job = false;
+}
+
+const tft_resume_status_t *tft_resume_get_status(void) {
+    return &status;
+}
+
+/*
+ * $TFT=RESUME
+ */
+
+static struct {
+    char file[sizeof(path)];
+    uint32_t line;
+    bool run;
+} request;
+
+static void ui_resume_scan(uint32_t arg) {
+    tft_resume_scan(request.file);
+}
+
+static void ui_resume_prepare(uint32_t arg) {
+    tft_resume_prepare(request.line, request.run);
+}
+
+static void ui_resume_abort(uint32_t arg) {
+    tft_resume_abort();
+}
+
+status_code_t tft_resume_command(char *args) {
+    char *arg = tft_command_arg(&args), *end, msg[128];
+
+    if(arg == NULL) {
+        snprintf(msg, sizeof(msg), "[TFTRESUME:%s,file=%s,lines=%u,checkpoints=%u,interval=%u,last=%u]" ASCII_EOL,
+                  state_names[status.state], path, (unsigned)status.lines, (unsigned)status.checkpoints,
+                  (unsigned)status.interval, (unsigned)last_line);
+        hal.stream.write(msg);
+
+        if(status.line) {
+            snprintf(msg, sizeof(msg), "[TFTRESUME:line=%u,from=%u,bytes=%u%s%s]" ASCII_EOL, (unsigned)status.line,
+                      (unsigned)status.from, (unsigned)status.bytes, status.error ? ",error=" : "",
+                      status.error ? status.error : "");
+            hal.stream.write(msg);
+        } else if(status.error) {
+            snprintf(msg, sizeof(msg), "[TFTRESUME:error=%s]" ASCII_EOL, status.error);
+            hal.stream.write(msg);
+        }
+
+        return Status_OK;
+    }
+
+    if(tft_command_is(arg, "ABORT"))
+        return args == NULL && tft_ui_call(ui_resume_abort, 0) ? Status_OK : Status_InvalidStatement;
+
+    if(busy())
+        return Status_IdleError;
+
+    if(tft_command_is(arg, "SCAN")) {
+        if((arg = tft_command_arg(&args)) == NULL || args || strlen(arg) >= sizeof(request.file))
+            return Status_InvalidStatement;
+
+        strcpy(request.file, arg);
+
+        return tft_ui_call(ui_resume_scan, 0) ? Status_OK : Status_InvalidStatement;
+    }
+
+    // Line number, or the last one reported executing
+    if(tft_command_is(arg, "LAST"))
+        request.line = last_line;
+    else {
+        request.line = strtoul(arg, &end, 10);
+        if(*end || end == arg)
+            return Status_BadNumberFormat;
+    }
+
+    request.run = false;
+    if((arg = tft_command_arg(&args))) {
+        if(args || !tft_command_is(arg, "RUN"))
+            return Status_InvalidStatement;
+        request.run = true;
+    }
+
+    if(!scanned || request.line == 0 || request.line > status.lines)
+        return Status_GcodeValueOutOfRange;
+
+    if(request.run && state_get() != STATE_IDLE)
+        return Status_IdleError;
+
+    return tft_ui_call(ui_resume_prepare, 0) ? Status_OK : Status_InvalidStatement;
+}
+
+#endif // TFT_ENABLE && TFT_RESUME_ENABLE
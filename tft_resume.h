@@ -0,0 +1,105 @@
+/*
+ * tft_resume.h - Resume a job from a line
+ *
+ * Part of grblHAL TFT Plugin
+ *
+ * Copyright (c) 2025
+ *
+ * A pre-scan reads a G-code file once and follows its modal state: work
+ * position, coordinate system, units, distance mode, motion mode, plane,
+ * feed, spindle, coolant and tool length offset. Every TFT_RESUME_INTERVAL
+ * lines it records a checkpoint of that state and the file offset of the
+ * line. The checkpoint
+ * table is fixed: when it is full every other one is dropped and the
+ * interval doubles.
+ *
+ * Resuming at line L seeks to the last checkpoint at or before L, follows
+ * the lines from there up to L, fewer than an interval of them, and writes
+ * TFT_RESUME_FILE: a prefix that restores the state safely, then the file
+ * from line L on. The prefix lifts Z to TFT_RESUME_SAFE_Z (machine) in mm,
+ * restores the spindle, waits for it, restores the coolant and the tool
+ * length offset the program set (G43.1 Z, G43 H or G49), moves over
+ * the resume point, rapids to TFT_RESUME_CLEARANCE above it and feeds
+ * down. Then it sets the distance and motion mode and the feed. Copied
+ * lines are numbered with their line in the scanned file as an N word,
+ * replacing any N word of their own, so the realtime report line number
+ * of a job started here is that line. Resuming at line 1 copies the whole
+ * file without a prefix: the way to start a job that can be resumed at
+ * the last line reported, LAST, after it stops.
+ *
+ * Not followed: G92 offsets and tool offsets from G43 without H, G43.2 or
+ * G43.1 on X/Y, a resume while one is in effect fails. An offset the
+ * program never sets, such as one from the TOOL probe wizard, is kept. G53,
+ * G28/G30 and probing moves leave the axes they move unknown until the
+ * next absolute move, a resume before that fails. Arc modes are not
+ * restored, a line continuing an arc without G2/G3 is rejected by grblHAL
+ * rather than run as a line.
+ *
+ * Scanning, replaying and copying are stepped by the UI loop,
+ * TFT_RESUME_CHUNK bytes at a time. UI task only.
+ */
+
+#ifndef _TFT_RESUME_H_
+#define _TFT_RESUME_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "grbl/hal.h"
+#include "tft_events.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef enum {
+    TFT_RESUME_IDLE = 0,
+    TFT_RESUME_SCANNING,
+    TFT_RESUME_SCANNED,         // Checkpoints ready
+    TFT_RESUME_REPLAYING,       // Following the lines from the checkpoint to the resume line
+    TFT_RESUME_WRITING,         // Writing TFT_RESUME_FILE
+    TFT_RESUME_READY,           // TFT_RESUME_FILE written
+    TFT_RESUME_STARTED,         // and sent to run
+    TFT_RESUME_FAILED
+} tft_resume_state_t;
+
+typedef struct {
+    tft_resume_state_t state;
+    uint32_t lines;             // Lines scanned
+    uint32_t bytes;             // Bytes read in this state
+    uint16_t checkpoints;
+    uint32_t interval;          // Lines between checkpoints
+    uint32_t line;              // Resume line
+    uint32_t from;              // Line of the checkpoint used
+    const char *error;          // Why it failed
+} tft_resume_status_t;
+
+// Start the pre-scan of file. UI task.
+bool tft_resume_scan(const char *file);
+
+// Write TFT_RESUME_FILE to resume the scanned file at line, and run it if run is set.
+// False if there is no scan or the line is out of range. UI task.
+bool tft_resume_prepare(uint32_t line, bool run);
+
+// Stop a scan or a resume being prepared. UI task.
+void tft_resume_abort(void);
+
+// Step the scan or the resume, call every UI loop. UI task.
+void tft_resume_poll(void);
+
+// Line number of the block executing, from the realtime report, 0 is ignored. Kept
+// for LAST while a job started here runs, other jobs number their lines their own way. UI task.
+void tft_resume_set_line(uint32_t line);
+
+// A job started here ends on program completion or reset, call with every event. UI task.
+void tft_resume_event(const tft_event_t *evt);
+
+const tft_resume_status_t *tft_resume_get_status(void);
+
+// $TFT=RESUME[,SCAN,<file>|<line>[,RUN]|LAST[,RUN]|ABORT]
+status_code_t tft_resume_command(char *args);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // _TFT_RESUME_H_
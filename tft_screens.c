@@ -0,0 +1,96 @@
+/*
+ * tft_screens.c - Screen registry and navigation
+ *
+ * Part of grblHAL TFT Plugin
+ *
+ * Copyright (c) 2025
+ *
+ */
+
+#include "driver.h"
+
+#if TFT_ENABLE
+
+#include <ctype.h>
+
+#include "tft_screens.h"
+#if TFT_REMOTE_INPUT_ENABLE
+#include "tft_remote_input.h"
+#endif
+
+static const tft_screen_t *const screens[TFT_SCREEN_COUNT] = {
+    [TFT_SCREEN_READY] = &screen_ready,
+    [TFT_SCREEN_SETTINGS] = &screen_settings,
+    [TFT_SCREEN_WCS] = &screen_wcs,
+#if SDCARD_ENABLE
+    [TFT_SCREEN_FILES] = &screen_files,
+#endif
+#if TFT_CONSOLE_ENABLE
+    [TFT_SCREEN_CONSOLE] = &screen_console,
+#endif
+#if TFT_PROBE_ENABLE
+    [TFT_SCREEN_HEIGHTMAP] = &screen_heightmap,
+#endif
+#if TFT_MACRO_ENABLE
+    [TFT_SCREEN_MACROS] = &screen_macros,
+#endif
+#if TFT_CHARTS_ENABLE
+    [TFT_SCREEN_CHARTS] = &screen_charts,
+#endif
+};
+
+static tft_screen_id_t active = TFT_SCREEN_READY;
+
+void tft_screens_init(void) {
+    active = TFT_SCREEN_READY;
+    screens[active]->create(lv_scr_act());
+}
+
+void tft_screen_show(tft_screen_id_t id) {
+    if(id >= TFT_SCREEN_COUNT)
+        return;
+
+    lv_obj_t *old = lv_scr_act();
+    lv_obj_t *scr = lv_obj_create(NULL, NULL);
+
+    if(screens[active]->destroy)
+        screens[active]->destroy();
+
+    active = id;
+    screens[id]->create(scr);
+    lv_scr_load(scr);
+    lv_obj_del(old);
+}
+
+tft_screen_id_t tft_screen_active(void) {
+    return active;
+}
+
+const char *tft_screen_name(tft_screen_id_t id) {
+    return id < TFT_SCREEN_COUNT ? screens[id]->name : "";
+}
+
+bool tft_screen_find(const char *name, tft_screen_id_t *id) {
+    for(uint_fast8_t i = 0; i < TFT_SCREEN_COUNT; i++) {
+        const char *a = name, *b = screens[i]->name;
+        while(*a && tolower((unsigned char)*a) == *b) {
+            a++;
+            b++;
+        }
+        if(*a == '\0' && *b == '\0') {
+            *id = (tft_screen_id_t)i;
+            return true;
+        }
+    }
+
+    return false;
+}
+
+void tft_screen_focus(lv_obj_t *obj) {
+#if TFT_REMOTE_INPUT_ENABLE
+    if(obj && tft_remote_input_group())
+        lv_group_add_obj(tft_remote_input_group(), obj);
+#endif
+}
+
+#endif // TFT_ENABLE
@@ -0,0 +1,83 @@
+/*
+ * tft_screens.h - Screen registry and navigation
+ *
+ * Part of grblHAL TFT Plugin
+ *
+ * Copyright (c) 2025
+ *
+ * Each screen lives in screens/screen_<name>.c and exports a tft_screen_t.
+ * Showing a screen builds it on a fresh LVGL screen object and deletes the
+ * previous one, so only the active screen holds LVGL memory. UI task only.
+ */
+
+#ifndef _TFT_SCREENS_H_
+#define _TFT_SCREENS_H_
+
+#include <stdbool.h>
+#include <lvgl.h>
+#include "tft_config.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef enum {
+    TFT_SCREEN_READY = 0,
+    TFT_SCREEN_SETTINGS,
+    TFT_SCREEN_WCS,
+#if SDCARD_ENABLE
+    TFT_SCREEN_FILES,
+#endif
+#if TFT_CONSOLE_ENABLE
+    TFT_SCREEN_CONSOLE,
+#endif
+#if TFT_PROBE_ENABLE
+    TFT_SCREEN_HEIGHTMAP,
+#endif
+#if TFT_MACRO_ENABLE
+    TFT_SCREEN_MACROS,
+#endif
+#if TFT_CHARTS_ENABLE
+    TFT_SCREEN_CHARTS,
+#endif
+    TFT_SCREEN_COUNT
+} tft_screen_id_t;
+
+typedef struct {
+    const char *name;               // Short lower case name, used by $TFT commands
+    void (*create)(lv_obj_t *scr);  // Build widgets on scr
+    void (*destroy)(void);          // Optional, called before the widgets are deleted
+} tft_screen_t;
+
+// Screens (screens/screen_*.c)
+extern const tft_screen_t screen_ready;
+extern const tft_screen_t screen_settings;
+extern const tft_screen_t screen_wcs;
+extern const tft_screen_t screen_files;
+extern const tft_screen_t screen_console;
+extern const tft_screen_t screen_heightmap;
+extern const tft_screen_t screen_macros;
+extern const tft_screen_t screen_charts;
+
+// Show initial screen
+void tft_screens_init(void);
+
+// Replace active screen
+void tft_screen_show(tft_screen_id_t id);
+
+tft_screen_id_t tft_screen_active(void);
+
+const char *tft_screen_name(tft_screen_id_t id);
+
+// Look up screen by name (case insensitive), returns false if unknown
+bool tft_screen_find(const char *name, tft_screen_id_t *id);
+
+// Let the remote keypad focus obj, called by screen create functions. Objects
+// leave the group when they are deleted with their screen. NULL is ignored.
+void tft_screen_focus(lv_obj_t *obj);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // _TFT_SCREENS_H_
@@ -0,0 +1,61 @@
+/*
+ * tft_screenshot.c - RLE compressed screenshot dump
+ *
+ * Part of grblHAL TFT Plugin
+ *
+ * Copyright (c) 2025
+ *
+ */
+
+#include "driver.h"
+
+#if TFT_ENABLE
+
+#include <stdio.h>
+
+#include "grbl/hal.h"
+
+#include "tft_config.h"
+#include "tft_codec.h"
+#include "tft_events.h"
+#include "tft_screenshot.h"
+#include "lvgl_init.h"
+
+static bool capturing = false;      // UI task only
+static lvgl_flush_tap_ptr flush_tap;
+
+static void screenshot_flush_tap(const lv_area_t *area, const lv_color_t *pixels) {
+    if(flush_tap)
+        flush_tap(area, pixels);
+
+    if(capturing)
+        tft_codec_write_area(hal.stream.write, "TFTSHOT", area->x1, area->y1, area->x2, area->y2, (const uint16_t *)pixels);
+}
+
+static void ui_screenshot(uint32_t arg) {
+    char msg[40];
+    lvgl_refresh_stats_t stats;
+
+    snprintf(msg, sizeof(msg), "[TFTSHOT:START,%d,%d]" ASCII_EOL, TFT_DISPLAY_WIDTH, TFT_DISPLAY_HEIGHT);
+    hal.stream.write(msg);
+
+    capturing = true;
+    lvgl_refresh_screen(&stats);
+    capturing = false;
+
+    snprintf(msg, sizeof(msg), "[TFTSHOT:END,%08X]" ASCII_EOL, (unsigned)stats.crc);
+    hal.stream.write(msg);
+}
+
+status_code_t tft_screenshot_command(char *args) {
+    if(args)
+        return Status_InvalidStatement;
+
+    return tft_ui_call(ui_screenshot, 0) ? Status_OK : Status_InvalidStatement;
+}
+
+void tft_screenshot_init(void) {
+    flush_tap = lvgl_set_flush_tap(screenshot_flush_tap);
+}
+
+#endif // TFT_ENABLE
@@ -0,0 +1,38 @@
+/*
+ * tft_screenshot.h - RLE compressed screenshot dump
+ *
+ * Part of grblHAL TFT Plugin
+ *
+ * Copyright (c) 2025
+ *
+ * $TFT=SHOT redraws the active screen band by band through the LVGL draw
+ * buffer and streams each band RLE compressed as it is flushed, so no
+ * frame copy is needed. Output (see tft_codec.h for the area lines):
+ *
+ *   [TFTSHOT:START,<width>,<height>]
+ *   [TFTSHOT:R,...] [TFTSHOT:D,...]     one area per band
+ *   [TFTSHOT:END,<crc32>]               CRC as in lvgl_refresh_stats_t
+ *
+ * tools/tft_shot.py turns the lines into a PNG.
+ */
+
+#ifndef _TFT_SCREENSHOT_H_
+#define _TFT_SCREENSHOT_H_
+
+#include "grbl/hal.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Install flush tap, call once after lvgl_init()
+void tft_screenshot_init(void);
+
+// $TFT=SHOT
+status_code_t tft_screenshot_command(char *args);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // _TFT_SCREENSHOT_H_
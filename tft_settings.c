@@ -0,0 +1,154 @@
+/*
+ * tft_settings.c - Runtime tunable UI settings
+ *
+ * Part of grblHAL TFT Plugin
+ *
+ * Copyright (c) 2025
+ *
+ */
+
+#include "driver.h"
+
+#if TFT_ENABLE
+
+#include <lvgl.h>
+
+#include "grbl/hal.h"
+#include "grbl/settings.h"
+#include "grbl/nvs_buffer.h"
+
+#include "tft_config.h"
+#include "tft_settings.h"
+
+#define TFT_SETTING(n) ((setting_id_t)(TFT_SETTING_BASE + (n)))
+
+tft_settings_t tft_settings;
+
+static nvs_address_t nvs_address;
+static tft_settings_changed_ptr on_changed;
+
+// Values the UI was started with, for settings that need a restart
+static bool started = false;
+static tft_settings_t started_with;
+
+static bool dma_available(const setting_detail_t *setting) {
+    return TFT_USE_DMA;
+}
+
+static bool idle_available(const setting_detail_t *setting) {
+    return TFT_IDLE_ENABLE;
+}
+
+static const setting_group_detail_t tft_groups[] = {
+    { Group_Root, Group_UserSettings, "TFT UI" }
+};
+
+static const setting_detail_t tft_setting_detail[] = {
+    { TFT_SETTING(0), Group_UserSettings, "TFT UI loop period", "ms", Format_Int16, "##0", "1", "100", Setting_NonCore, &tft_settings.loop_ms, NULL, NULL },
+    { TFT_SETTING(1), Group_UserSettings, "TFT display refresh period", "ms", Format_Int16, "###0", "5", "1000", Setting_NonCore, &tft_settings.refr_ms, NULL, NULL },
+    { TFT_SETTING(2), Group_UserSettings, "TFT touch read period", "ms", Format_Int16, "###0", "5", "1000", Setting_NonCore, &tft_settings.indev_ms, NULL, NULL },
+    { TFT_SETTING(3), Group_UserSettings, "TFT draw buffer lines", "lines", Format_Int16, "##0", "0", "320", Setting_NonCore, &tft_settings.buffer_lines, NULL, NULL },
+    { TFT_SETTING(4), Group_UserSettings, "TFT UI task priority", NULL, Format_Int8, "#0", "1", "20", Setting_NonCore, &tft_settings.task_priority, NULL, NULL },
+    { TFT_SETTING(5), Group_UserSettings, "TFT UI task core", NULL, Format_Int8, "0", "0", "1", Setting_NonCore, &tft_settings.task_core, NULL, NULL },
+    { TFT_SETTING(6), Group_UserSettings, "TFT display DMA", NULL, Format_Bool, NULL, NULL, NULL, Setting_NonCore, &tft_settings.dma, NULL, dma_available },
+    { TFT_SETTING(7), Group_UserSettings, "TFT idle dim time", "s", Format_Int16, "####0", "0", "36000", Setting_NonCore, &tft_settings.idle_dim_s, NULL, idle_available },
+    { TFT_SETTING(8), Group_UserSettings, "TFT idle sleep time", "s", Format_Int16, "####0", "0", "36000", Setting_NonCore, &tft_settings.idle_sleep_s, NULL, idle_available },
+    { TFT_SETTING(9), Group_UserSettings, "TFT dimmed brightness", "%", Format_Int8, "##0", "0", "100", Setting_NonCore, &tft_settings.idle_dim_pct, NULL, idle_available }
+};
+
+#ifndef NO_SETTINGS_DESCRIPTIONS
+
+static const setting_descr_t tft_setting_descr[] = {
+    { TFT_SETTING(0), "UI task loop period while no job is running." },
+    { TFT_SETTING(1), "LVGL display refresh period while no job is running." },
+    { TFT_SETTING(2), "Touch panel read period while no job is running." },
+    { TFT_SETTING(3), "Height of each LVGL draw buffer in display lines, 0 to size them from free memory." },
+    { TFT_SETTING(4), "FreeRTOS priority of the UI task." },
+    { TFT_SETTING(5), "CPU core the UI task runs on, core 1 also runs the motion code.\\n\\n"
+                      "NOTE: A restart is required after changing this setting." },
+    { TFT_SETTING(6), "Send display data with DMA, otherwise with blocking SPI writes." },
+    { TFT_SETTING(7), "Time without touch or state change before the backlight is dimmed while idle, 0 to never dim." },
+    { TFT_SETTING(8), "Time without touch or state change before the display sleeps while idle, 0 to never sleep." },
+    { TFT_SETTING(9), "Dimmed backlight brightness in percent of the normal brightness." }
+};
+
+#endif
+
+static void tft_settings_defaults(void) {
+    tft_settings.loop_ms = TFT_LVGL_REFRESH_MS;
+    tft_settings.refr_ms = LV_DISP_DEF_REFR_PERIOD;
+    tft_settings.indev_ms = LV_INDEV_DEF_READ_PERIOD;
+    tft_settings.buffer_lines = TFT_LVGL_BUFFER_LINES;
+    tft_settings.task_priority = TFT_TASK_PRIORITY;
+    tft_settings.task_core = TFT_TASK_CORE;
+    tft_settings.dma = TFT_USE_DMA;
+    tft_settings.idle_dim_s = TFT_IDLE_DIM_S;
+    tft_settings.idle_sleep_s = TFT_IDLE_SLEEP_S;
+    tft_settings.idle_dim_pct = TFT_IDLE_DIM_PCT;
+}
+
+static void tft_settings_notify(void) {
+    if(!started) {
+        started = true;
+        started_with = tft_settings;
+    } else if(tft_settings.task_core != started_with.task_core)
+        hal.stream.write("[MSG:TFT restart required to apply settings]" ASCII_EOL);
+
+    on_changed();
+}
+
+static void tft_settings_save(void) {
+    hal.nvs.memcpy_to_nvs(nvs_address, (uint8_t *)&tft_settings, sizeof(tft_settings_t), true);
+
+    tft_settings_notify();
+}
+
+static void tft_settings_write_defaults(void) {
+    tft_settings_defaults();
+
+    hal.nvs.memcpy_to_nvs(nvs_address, (uint8_t *)&tft_settings, sizeof(tft_settings_t), true);
+}
+
+static void tft_settings_restore(void) {
+    tft_settings_write_defaults();
+
+    // Before the first load the UI is not running yet, load starts it
+    if(started)
+        tft_settings_notify();
+}
+
+static void tft_settings_load(void) {
+    if(hal.nvs.memcpy_from_nvs((uint8_t *)&tft_settings, nvs_address, sizeof(tft_settings_t), true) != NVS_TransferResult_OK)
+        tft_settings_write_defaults();
+
+    tft_settings_notify();
+}
+
+static setting_details_t setting_details = {
+    .groups = tft_groups,
+    .n_groups = sizeof(tft_groups) / sizeof(setting_group_detail_t),
+    .settings = tft_setting_detail,
+    .n_settings = sizeof(tft_setting_detail) / sizeof(setting_detail_t),
+#ifndef NO_SETTINGS_DESCRIPTIONS
+    .descriptions = tft_setting_descr,
+    .n_descriptions = sizeof(tft_setting_descr) / sizeof(setting_descr_t),
+#endif
+    .save = tft_settings_save,
+    .load = tft_settings_load,
+    .restore = tft_settings_restore
+};
+
+void tft_settings_init(tft_settings_changed_ptr changed) {
+    on_changed = changed;
+
+    tft_settings_defaults();
+
+    if((nvs_address = nvs_alloc(sizeof(tft_settings_t))))
+        settings_register(&setting_details);
+    else {
+        hal.stream.write("[MSG:TFT settings not available, no NVS space]" ASCII_EOL);
+        tft_settings_notify();
+    }
+}
+
+#endif // TFT_ENABLE
@@ -0,0 +1,63 @@
+/*
+ * tft_settings.h - Runtime tunable UI settings
+ *
+ * Part of grblHAL TFT Plugin
+ *
+ * Copyright (c) 2025
+ *
+ * UI performance values registered as grblHAL $ settings and stored in
+ * NVS, so each machine can be tuned with $<id>=<value> instead of a rebuild.
+ * The values in tft_config.h are the defaults ($RST=$ restores them).
+ *
+ *   $450  UI loop period, ms
+ *   $451  Display refresh period, ms
+ *   $452  Touch read period, ms
+ *   $453  Draw buffer height, display lines, 0 = from free memory
+ *   $454  UI task priority
+ *   $455  UI task core                           (restart)
+ *   $456  Use DMA for display transfers          (TFT_USE_DMA builds only)
+ *   $457  Idle time before dimming, s, 0 = never (TFT_IDLE_ENABLE builds only)
+ *   $458  Idle time before display sleep, s, 0 = never
+ *   $459  Dimmed brightness, percent
+ *
+ * The ids start at TFT_SETTING_BASE. grblHAL loads plugin settings after
+ * plugin init, so the UI is started from the load callback.
+ */
+
+#ifndef _TFT_SETTINGS_H_
+#define _TFT_SETTINGS_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct {
+    uint16_t loop_ms;           // UI task loop period (normal throttle mode)
+    uint16_t refr_ms;           // LVGL display refresh task period
+    uint16_t indev_ms;          // LVGL input device read period
+    uint16_t buffer_lines;      // Draw buffer height
+    uint8_t task_priority;
+    uint8_t task_core;
+    bool dma;
+    uint16_t idle_dim_s;        // Idle time before dimming
+    uint16_t idle_sleep_s;      // Idle time before display sleep
+    uint8_t idle_dim_pct;       // Dimmed brightness
+} tft_settings_t;
+
+extern tft_settings_t tft_settings;
+
+// Called once settings have been loaded or restored, and after every change
+typedef void (*tft_settings_changed_ptr)(void);
+
+// Register the settings. Without NVS space the defaults are used and
+// on_changed is called at once.
+void tft_settings_init(tft_settings_changed_ptr on_changed);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // _TFT_SETTINGS_H_
@@ -0,0 +1,348 @@
+/*
+ * tft_stream_tap.c - grblHAL output stream tap
+ *
+ * Part of grblHAL TFT Plugin
+ *
+ * Copyright (c) 2025
+ *
+ */
+
+#include "driver.h"
+#include "tft_config.h"
+
+#if TFT_ENABLE && TFT_STREAM_TAP_ENABLE
+
+#include <stdio.h>
+#include <string.h>
+
+#include "esp_timer.h"
+#include "grbl/hal.h"
+
+#include "tft_commands.h"
+#include "tft_events.h"
+#include "tft_stream_tap.h"
+
+#define TEXT_MASK (TFT_STREAM_TEXT_SIZE - 1)
+#define ALL_KEYWORDS ((1 << TFT_STREAM_COUNT) - 1)
+
+#if TFT_STREAM_TEXT_SIZE & TEXT_MASK
+#error "TFT_STREAM_TEXT_SIZE must be a power of 2"
+#endif
+
+// Line prefixes, none is a prefix of another
+static const char *const keywords[TFT_STREAM_COUNT] = {
+    [TFT_STREAM_OK] = "ok",
+    [TFT_STREAM_ERROR] = "error:",
+    [TFT_STREAM_ALARM] = "ALARM:",
+    [TFT_STREAM_MSG] = "[MSG:",
+    [TFT_STREAM_GC] = "[GC:",
+};
+
+static const char *const kind_names[TFT_STREAM_COUNT] = { "ok", "error", "alarm", "msg", "gc" };
+
+typedef enum {
+    Tok_Match = 0,              // Line start, matching keywords
+    Tok_Code,                   // error/ALARM number
+    Tok_Text,                   // MSG/GC text
+    Tok_End,                    // ok, nothing else may follow
+    Tok_Skip                    // Nothing of interest until end of line
+} tok_state_t;
+
+// Writer side, grblHAL task only
+static struct {
+    tok_state_t state;
+    uint8_t mask;               // Keywords still matching
+    uint8_t pos;                // Characters matched
+    int8_t kind;                // Matched keyword, -1 if none
+    uint16_t code;
+    uint32_t text;              // Ring position of the text
+    uint8_t len;
+    bool nested;                // write_all calling write
+} tok = {
+    .mask = ALL_KEYWORDS,
+    .kind = -1
+};
+
+static struct {
+    uint32_t bytes;
+    uint32_t lines;
+    uint32_t kinds[TFT_STREAM_COUNT];
+    uint32_t truncated;
+    uint32_t other;             // Writes from other tasks, not scanned
+    uint64_t us;                // Time spent scanning
+} stats;
+
+static char text[TFT_STREAM_TEXT_SIZE];
+static volatile uint32_t text_head = 0;
+static volatile uint8_t last_error = 0;
+
+static TaskHandle_t writer_task = NULL;
+static tft_stream_line_ptr line_sink = NULL;
+static stream_write_ptr write_orig, write_all_orig;
+static on_stream_changed_ptr on_stream_changed;
+
+static void line_begin(tft_stream_kind_t kind) {
+    tok.kind = (int8_t)kind;
+
+    switch(kind) {
+
+        case TFT_STREAM_ERROR:
+        case TFT_STREAM_ALARM:
+            tok.state = Tok_Code;
+            tok.code = 0;
+            break;
+
+        case TFT_STREAM_MSG:
+        case TFT_STREAM_GC:
+            tok.state = Tok_Text;
+            tok.text = text_head;
+            tok.len = 0;
+            break;
+
+        default:
+            tok.state = Tok_End;
+            break;
+    }
+}
+
+static void line_end(void) {
+    stats.lines++;
+
+    if(tok.kind >= 0) {
+        tft_event_t evt = { .type = TFT_EVT_STREAM };
+
+        stats.kinds[tok.kind]++;
+
+        switch((tft_stream_kind_t)tok.kind) {
+
+            case TFT_STREAM_OK:
+                last_error = 0;
+                break;
+
+            case TFT_STREAM_ERROR:
+                last_error = (uint8_t)tok.code;
+                // Fall through
+            case TFT_STREAM_ALARM:
+                evt.stream.kind = (uint8_t)tok.kind;
+                evt.stream.code = tok.code;
+                tft_event_post(&evt);
+                break;
+
+            default:
+                // Drop the closing bracket
+                if(tok.len && text[(tok.text + tok.len - 1) & TEXT_MASK] == ']')
+                    tok.len--;
+                text_head = tok.text + tok.len;
+                evt.stream.kind = (uint8_t)tok.kind;
+                evt.stream.text = tok.text;
+                evt.stream.len = tok.len;
+                tft_event_post(&evt);
+                break;
+        }
+    }
+
+    tok.state = Tok_Match;
+    tok.mask = ALL_KEYWORDS;
+    tok.pos = 0;
+    tok.kind = -1;
+}
+
+static void tap_scan(const char *s) {
+    const char *start = s, *line = s;
+    char c;
+
+    while((c = *s)) {
+
+        if(c == '\n') {
+            if(line_sink)
+                line_sink(line, s - line, tok.kind, true);
+            line_end();
+            line = ++s;
+            continue;
+        }
+
+        switch(tok.state) {
+
+            case Tok_Match:
+                {
+                    uint8_t mask = 0;
+
+                    for(uint_fast8_t i = 0; i < TFT_STREAM_COUNT; i++) {
+                        if((tok.mask & (1 << i)) && keywords[i][tok.pos] == c)
+                            mask |= 1 << i;
+                    }
+
+                    tok.mask = mask;
+                    tok.pos++;
+
+                    if(mask == 0)
+                        tok.state = Tok_Skip;
+                    else for(uint_fast8_t i = 0; i < TFT_STREAM_COUNT; i++) {
+                        if((mask & (1 << i)) && keywords[i][tok.pos] == '\0')
+                            line_begin((tft_stream_kind_t)i);
+                    }
+                }
+                break;
+
+            case Tok_Code:
+                if(c >= '0' && c <= '9' && tok.code < 6553)
+                    tok.code = tok.code * 10 + (c - '0');
+                else
+                    tok.state = Tok_Skip;
+                break;
+
+            case Tok_Text:
+                if(c == '\r')
+                    tok.state = Tok_Skip;
+                else if(tok.len < TFT_STREAM_TEXT_MAX)
+                    text[(tok.text + tok.len++) & TEXT_MASK] = c;
+                else {
+                    stats.truncated++;
+                    tok.state = Tok_Skip;
+                }
+                break;
+
+            case Tok_End:
+                if(c != '\r')
+                    tok.kind = -1;
+                tok.state = Tok_Skip;
+                break;
+
+            case Tok_Skip:
+                {
+                    const char *eol = strchr(s, '\n');
+
+                    s = eol ? eol : s + strlen(s);
+                }
+                continue;
+        }
+
+        s++;
+    }
+
+    if(line_sink && s > line)
+        line_sink(line, s - line, -1, false);
+
+    stats.bytes += s - start;
+}
+
+// The tokenizer state is not shared: only the grblHAL task's output is
+// scanned, anything written by another task (the UI, network stacks) is
+// passed on unparsed so its lines can not interleave with a scanned one
+static void tap(const char *s, stream_write_ptr write) {
+    if(xTaskGetCurrentTaskHandle() != writer_task) {
+        stats.other++;
+        write(s);
+        return;
+    }
+
+    if(!tok.nested) {
+        uint32_t t = (uint32_t)esp_timer_get_time();
+
+        tap_scan(s);
+        stats.us += (uint32_t)esp_timer_get_time() - t;
+    }
+
+    tok.nested = true;
+    write(s);
+    tok.nested = false;
+}
+
+static void tap_write(const char *s) {
+    tap(s, write_orig);
+}
+
+static void tap_write_all(const char *s) {
+    tap(s, write_all_orig);
+}
+
+// grblHAL replaces hal.stream on a stream change, attach again
+static void tap_attach(void) {
+    if(hal.stream.write && hal.stream.write != tap_write) {
+        write_orig = hal.stream.write;
+        hal.stream.write = tap_write;
+    }
+
+    if(hal.stream.write_all && hal.stream.write_all != tap_write_all) {
+        write_all_orig = hal.stream.write_all;
+        hal.stream.write_all = tap_write_all;
+    }
+}
+
+static void tap_stream_changed(stream_type_t type) {
+    if(on_stream_changed)
+        on_stream_changed(type);
+
+    tap_attach();
+}
+
+bool tft_stream_tap_text(const tft_event_t *evt, char *buf, size_t size) {
+    uint32_t len = evt->stream.len < size ? evt->stream.len : size - 1;
+
+    for(uint32_t i = 0; i < len; i++)
+        buf[i] = text[(evt->stream.text + i) & TEXT_MASK];
+    buf[len] = '\0';
+
+    // A line being scanned may already be writing up to TFT_STREAM_TEXT_MAX past the head
+    return text_head + TFT_STREAM_TEXT_MAX - evt->stream.text <= TFT_STREAM_TEXT_SIZE;
+}
+
+uint32_t tft_stream_tap_count(tft_stream_kind_t kind) {
+    return kind < TFT_STREAM_COUNT ? stats.kinds[kind] : 0;
+}
+
+uint8_t tft_stream_tap_last_error(void) {
+    return last_error;
+}
+
+tft_stream_line_ptr tft_stream_tap_set_line_sink(tft_stream_line_ptr sink) {
+    tft_stream_line_ptr prev = line_sink;
+
+    line_sink = sink;
+
+    return prev;
+}
+
+/*
+ * $TFT=STREAM
+ */
+
+status_code_t tft_stream_tap_command(char *args) {
+    char *arg = tft_command_arg(&args);
+
+    if(arg == NULL) {
+        char msg[160];
+        int n = snprintf(msg, sizeof(msg), "[TFTSTREAM:bytes=%u,lines=%u", (unsigned)stats.bytes, (unsigned)stats.lines);
+
+        for(uint_fast8_t i = 0; i < TFT_STREAM_COUNT; i++)
+            n += snprintf(msg + n, sizeof(msg) - n, ",%s=%u", kind_names[i], (unsigned)stats.kinds[i]);
+
+        snprintf(msg + n, sizeof(msg) - n, ",truncated=%u,other=%u,last_error=%u,ns_per_byte=%u]" ASCII_EOL,
+                  (unsigned)stats.truncated, (unsigned)stats.other, (unsigned)last_error,
+                  stats.bytes ? (unsigned)(stats.us * 1000 / stats.bytes) : 0);
+
+        hal.stream.write(msg);
+
+        return Status_OK;
+    }
+
+    if(args)
+        return Status_InvalidStatement;
+
+    if(tft_command_is(arg, "RESET")) {
+        memset(&stats, 0, sizeof(stats));
+        return Status_OK;
+    }
+
+    return Status_InvalidStatement;
+}
+
+void tft_stream_tap_init(void) {
+    writer_task = xTaskGetCurrentTaskHandle();
+    tap_attach();
+
+    on_stream_changed = grbl.on_stream_changed;
+    grbl.on_stream_changed = tap_stream_changed;
+}
+
+#endif // TFT_ENABLE && TFT_STREAM_TAP_ENABLE
@@ -0,0 +1,71 @@
+/*
+ * tft_stream_tap.h - grblHAL output stream tap
+ *
+ * Part of grblHAL TFT Plugin
+ *
+ * Copyright (c) 2025
+ *
+ * Chains onto hal.stream.write and write_all and classifies the response
+ * lines grblHAL sends to the host. Strings are scanned in place by a small
+ * state machine: once the first characters of a line rule out every
+ * keyword the rest of it is skipped with strchr(), so streamed G-code echo
+ * and reports cost next to nothing. Only [MSG:] and [GC:] text is copied,
+ * into a small ring the UI reads it from.
+ *
+ * ok is counted, not posted, a streaming host would flood the event queue.
+ * The scanner keeps one line's state, so it only reads the output of the
+ * grblHAL task; writes from other tasks are passed on unparsed.
+ */
+
+#ifndef _TFT_STREAM_TAP_H_
+#define _TFT_STREAM_TAP_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include "grbl/hal.h"
+
+#include "tft_events.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef enum {
+    TFT_STREAM_OK = 0,
+    TFT_STREAM_ERROR,           // error:N
+    TFT_STREAM_ALARM,           // ALARM:N
+    TFT_STREAM_MSG,             // [MSG:text]
+    TFT_STREAM_GC,              // [GC:text]
+    TFT_STREAM_COUNT
+} tft_stream_kind_t;
+
+// Output line fragment, pointing into the string being written. kind is
+// the tft_stream_kind_t of the line, or -1, and only set on the last
+// fragment (eol true). The line end itself is not included.
+typedef void (*tft_stream_line_ptr)(const char *s, size_t len, int8_t kind, bool eol);
+
+// Attach to the current stream and follow stream changes. Call from the grblHAL task,
+// only output written by the calling task is scanned
+void tft_stream_tap_init(void);
+
+// Set the line sink, called from the writing task, returns the previous one to chain to
+tft_stream_line_ptr tft_stream_tap_set_line_sink(tft_stream_line_ptr sink);
+
+// Copy the text of a TFT_EVT_STREAM event, false if it has been overwritten since
+bool tft_stream_tap_text(const tft_event_t *evt, char *buf, size_t size);
+
+// Lines of a kind seen since boot or $TFT=STREAM,RESET
+uint32_t tft_stream_tap_count(tft_stream_kind_t kind);
+
+// Code of the last response, 0 once a later ok has been sent
+uint8_t tft_stream_tap_last_error(void);
+
+// $TFT=STREAM[,RESET]
+status_code_t tft_stream_tap_command(char *args);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // _TFT_STREAM_TAP_H_
@@ -0,0 +1,87 @@
+/*
+ * tft_strings.c - Localized UI string tables
+ *
+ * Part of grblHAL TFT Plugin
+ *
+ * Copyright (c) 2025
+ *
+ */
+
+#include "driver.h"
+
+#if TFT_ENABLE
+
+#include <ctype.h>
+
+#include "tft_strings.h"
+
+const tft_lang_table_t *tft_lang = &tft_lang_tables[TFT_LANGUAGE_DEFAULT];
+
+// Labels showing a table string (the visible ones)
+static struct {
+    lv_obj_t *label;
+    tft_str_id_t id;
+} bindings[TFT_STR_MAX_BINDINGS];
+
+void tft_set_language(tft_lang_id_t lang) {
+    if(lang >= TFT_LANG_COUNT || tft_lang == &tft_lang_tables[lang])
+        return;
+
+    tft_lang = &tft_lang_tables[lang];
+
+    // Repoint bound labels, LVGL invalidates just those areas
+    for(uint_fast8_t i = 0; i < TFT_STR_MAX_BINDINGS; i++) {
+        if(bindings[i].label)
+            lv_label_set_static_text(bindings[i].label, tft_str(bindings[i].id));
+    }
+}
+
+tft_lang_id_t tft_get_language(void) {
+    return (tft_lang_id_t)(tft_lang - tft_lang_tables);
+}
+
+bool tft_find_language(const char *code, tft_lang_id_t *lang) {
+    for(uint_fast8_t i = 0; i < TFT_LANG_COUNT; i++) {
+        const char *a = code, *b = tft_lang_tables[i].code;
+        while(*a && tolower((unsigned char)*a) == *b) {
+            a++;
+            b++;
+        }
+        if(*a == '\0' && *b == '\0') {
+            *lang = (tft_lang_id_t)i;
+            return true;
+        }
+    }
+
+    return false;
+}
+
+void tft_str_bind(lv_obj_t *label, tft_str_id_t id) {
+    int_fast8_t slot = -1;
+
+    for(uint_fast8_t i = 0; i < TFT_STR_MAX_BINDINGS; i++) {
+        if(bindings[i].label == label) {
+            slot = i;
+            break;
+        }
+        if(slot < 0 && bindings[i].label == NULL)
+            slot = i;
+    }
+
+    // Table full: label still gets its text, it just won't follow language switches
+    if(slot >= 0) {
+        bindings[slot].label = label;
+        bindings[slot].id = id;
+    }
+
+    lv_label_set_static_text(label, tft_str(id));
+}
+
+void tft_str_unbind(lv_obj_t *label) {
+    for(uint_fast8_t i = 0; i < TFT_STR_MAX_BINDINGS; i++) {
+        if(bindings[i].label == label)
+            bindings[i].label = NULL;
+    }
+}
+
+#endif // TFT_ENABLE
@@ -0,0 +1,68 @@
+/*
+ * tft_strings.h - Localized UI string tables
+ *
+ * Part of grblHAL TFT Plugin
+ *
+ * Copyright (c) 2025
+ *
+ * Strings are compiled from lang/<code>.txt by tools/gen_strings.py into one
+ * packed const blob per language (flash resident). A lookup is a single
+ * offset read, and switching language swaps one table pointer.
+ */
+
+#ifndef _TFT_STRINGS_H_
+#define _TFT_STRINGS_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <lvgl.h>
+#include "tft_config.h"
+#include "tft_strings_gen.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Compiled string table for one language
+typedef struct {
+    const char *code;           // lang/<code>.txt
+    const char *name;           // Native language name (UTF-8)
+    const uint16_t *offset;     // Offset of each string in blob, indexed by tft_str_id_t
+    const char *blob;           // Packed NUL terminated strings
+} tft_lang_table_t;
+
+extern const tft_lang_table_t tft_lang_tables[TFT_LANG_COUNT];
+extern const tft_lang_table_t *tft_lang;
+
+// Get string for the active language (points into flash, never NULL)
+static inline const char *tft_str(tft_str_id_t id) {
+    return tft_lang->blob + tft_lang->offset[id];
+}
+
+// Select the active language, relabels bound labels (UI task only)
+void tft_set_language(tft_lang_id_t lang);
+
+// Get the active language
+tft_lang_id_t tft_get_language(void);
+
+// Look up language by code (case insensitive), returns false if unknown
+bool tft_find_language(const char *code, tft_lang_id_t *lang);
+
+/*
+ * Label binding
+ * Bound labels reference the table text directly (lv_label_set_static_text)
+ * and are the only objects invalidated on a language switch.
+ * Unbind before deleting the label.
+ */
+
+// Set label text to string id and keep it updated on language switch
+void tft_str_bind(lv_obj_t *label, tft_str_id_t id);
+
+// Stop tracking label
+void tft_str_unbind(lv_obj_t *label);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // _TFT_STRINGS_H_
@@ -0,0 +1,82 @@
+/*
+ * tft_strings_gen.c - Generated UI string tables
+ *
+ * Part of grblHAL TFT Plugin
+ *
+ * Generated by tools/gen_strings.py from lang/<code>.txt - do not edit.
+ */
+
+#include "tft_strings.h"
+
+#if TFT_ENABLE
+
+static const char str_blob_zh[156] =
+    "grblHAL TFT \345\260\261\347\273\252!\012\012\347\254\254\344\272\214\351\230\266\346\256\265\345\256\214\346\210\220\0"  // READY_BANNER
+    "\346\212\245\350\255\246\0"  // ALARM
+    "\347\264\247\346\200\245\345\201\234\346\255\242\0"  // ESTOP
+    "\350\277\233\347\273\231 mm/min\0"  // CHART_FEED
+    "\344\270\273\350\275\264 RPM\0"  // CHART_SPINDLE
+    "\346\273\241\351\207\217\347\250\213\0"  // CHART_FULL
+    "\346\227\240\351\253\230\345\272\246\345\233\276\0"  // MAP_EMPTY
+    "\345\267\262\346\216\242\346\265\213\0"  // MAP_PROBED
+    "\350\277\220\350\241\214\344\270\255\0"  // MACRO_RUNNING
+    "\346\224\266\345\260\276\344\270\255\0"  // MACRO_FINISHING
+    "\345\256\214\346\210\220\0"  // MACRO_DONE
+    "\345\244\261\350\264\245\0"  // MACRO_FAILED
+    "\350\241\214\0"  // MACRO_LINES
+;
+
+static const uint16_t str_offs_zh[STR_COUNT] = {
+        0,    40,    47,    60,    74,    85,    95,   108,
+      118,   128,   138,   145,   152,
+};
+
+static const char str_blob_en[143] =
+    "grblHAL TFT Ready!\012\012Phase 2 Complete\0"  // READY_BANNER
+    "ALARM\0"  // ALARM
+    "EMERGENCY STOP\0"  // ESTOP
+    "Feed mm/min\0"  // CHART_FEED
+    "Spindle RPM\0"  // CHART_SPINDLE
+    "full\0"  // CHART_FULL
+    "No heightmap\0"  // MAP_EMPTY
+    "probed\0"  // MAP_PROBED
+    "running\0"  // MACRO_RUNNING
+    "finishing\0"  // MACRO_FINISHING
+    "done\0"  // MACRO_DONE
+    "failed\0"  // MACRO_FAILED
+    "lines\0"  // MACRO_LINES
+;
+
+static const uint16_t str_offs_en[STR_COUNT] = {
+        0,    37,    43,    58,    70,    82,    87,   100,
+      107,   115,   125,   130,   137,
+};
+
+static const char str_blob_de[167] =
+    "grblHAL TFT bereit!\012\012Phase 2 abgeschlossen\0"  // READY_BANNER
+    "ALARM\0"  // ALARM
+    "NOT-HALT\0"  // ESTOP
+    "Vorschub mm/min\0"  // CHART_FEED
+    "Spindel U/min\0"  // CHART_SPINDLE
+    "Endwert\0"  // CHART_FULL
+    "Keine H\303\266henkarte\0"  // MAP_EMPTY
+    "angetastet\0"  // MAP_PROBED
+    "l\303\244uft\0"  // MACRO_RUNNING
+    "endet\0"  // MACRO_FINISHING
+    "fertig\0"  // MACRO_DONE
+    "fehlgeschlagen\0"  // MACRO_FAILED
+    "Zeilen\0"  // MACRO_LINES
+;
+
+static const uint16_t str_offs_de[STR_COUNT] = {
+        0,    43,    49,    58,    74,    88,    96,   114,
+      125,   132,   138,   145,   160,
+};
+
+const tft_lang_table_t tft_lang_tables[TFT_LANG_COUNT] = {
+    { "zh", "\344\270\255\346\226\207", str_offs_zh, str_blob_zh },
+    { "en", "English", str_offs_en, str_blob_en },
+    { "de", "Deutsch", str_offs_de, str_blob_de },
+};
+
+#endif // TFT_ENABLE
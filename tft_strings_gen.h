@@ -0,0 +1,36 @@
+/*
+ * tft_strings_gen.h - Generated UI string IDs
+ *
+ * Part of grblHAL TFT Plugin
+ *
+ * Generated by tools/gen_strings.py from lang/<code>.txt - do not edit.
+ */
+
+#ifndef _TFT_STRINGS_GEN_H_
+#define _TFT_STRINGS_GEN_H_
+
+typedef enum {
+    TFT_LANG_ZH,
+    TFT_LANG_EN,
+    TFT_LANG_DE,
+    TFT_LANG_COUNT
+} tft_lang_id_t;
+
+typedef enum {
+    STR_READY_BANNER,
+    STR_ALARM,
+    STR_ESTOP,
+    STR_CHART_FEED,
+    STR_CHART_SPINDLE,
+    STR_CHART_FULL,
+    STR_MAP_EMPTY,
+    STR_MAP_PROBED,
+    STR_MACRO_RUNNING,
+    STR_MACRO_FINISHING,
+    STR_MACRO_DONE,
+    STR_MACRO_FAILED,
+    STR_MACRO_LINES,
+    STR_COUNT
+} tft_str_id_t;
+
+#endif // _TFT_STRINGS_GEN_H_
@@ -0,0 +1,154 @@
+/*
+ * tft_throttle.c - Motion aware UI throttling
+ *
+ * Part of grblHAL TFT Plugin
+ *
+ * Copyright (c) 2025
+ *
+ */
+
+#include "driver.h"
+#include "tft_config.h"
+
+#if TFT_ENABLE && TFT_THROTTLE_ENABLE
+
+#include <stdio.h>
+
+#include "grbl/hal.h"
+#include "grbl/planner.h"
+#include "grbl/state_machine.h"
+
+#include "tft_commands.h"
+#include "tft_settings.h"
+#include "tft_throttle.h"
+#include "lvgl_init.h"
+
+static struct {
+    const char *name;
+    uint16_t loop_ms;           // UI task loop period
+    uint16_t refr_ms;           // LVGL display refresh task period
+    uint16_t indev_ms;          // LVGL input device read period
+} modes[TFT_THROTTLE_COUNT] = {
+    [TFT_THROTTLE_NORMAL]    = { "normal" },     // From tft_settings
+    [TFT_THROTTLE_CYCLE]     = { "cycle", TFT_THROTTLE_CYCLE_LOOP_MS, TFT_THROTTLE_CYCLE_REFR_MS, TFT_THROTTLE_CYCLE_INDEV_MS },
+    [TFT_THROTTLE_STREAMING] = { "streaming", TFT_THROTTLE_STREAM_LOOP_MS, TFT_THROTTLE_STREAM_REFR_MS, TFT_THROTTLE_STREAM_INDEV_MS },
+};
+
+static struct {
+    tft_throttle_mode_t mode;
+    uint32_t mode_ms;           // Time the current mode was entered
+    bool busy;                  // Streaming condition seen
+    uint32_t busy_ms;           // Time it was first seen
+    uint32_t touch_ms;          // Last physical touch
+    uint32_t time_ms[TFT_THROTTLE_COUNT];
+    uint32_t switches;
+} throttle;
+
+static lvgl_touch_filter_ptr touch_filter;
+
+static bool throttle_touch_filter(bool touched, uint16_t *x, uint16_t *y) {
+    if(touch_filter)
+        touched = touch_filter(touched, x, y);
+
+    if(touched)
+        throttle.touch_ms = hal.get_elapsed_ticks();
+
+    return touched;
+}
+
+static bool stream_busy(void) {
+    if(plan_get_block_buffer_available() <= TFT_THROTTLE_PLANNER_LOW)
+        return true;
+
+    return hal.stream.get_rx_buffer_free &&
+            hal.stream.get_rx_buffer_free() < hal.rx_buffer_size * (100 - TFT_THROTTLE_RX_BUSY_PCT) / 100;
+}
+
+static void set_mode(tft_throttle_mode_t mode, uint32_t now_ms) {
+    throttle.time_ms[throttle.mode] += now_ms - throttle.mode_ms;
+    throttle.mode_ms = now_ms;
+    throttle.mode = mode;
+    throttle.switches++;
+
+    lvgl_set_task_periods(modes[mode].refr_ms, modes[mode].indev_ms);
+}
+
+uint32_t tft_throttle_update(sys_state_t state, uint32_t now_ms) {
+    tft_throttle_mode_t mode = TFT_THROTTLE_NORMAL;
+
+    if(state == STATE_CYCLE && now_ms - throttle.touch_ms >= TFT_THROTTLE_TOUCH_MS) {
+        mode = TFT_THROTTLE_CYCLE;
+
+        // Slow down further only when the stream stays busy, leave at once when it does not
+        if(!stream_busy())
+            throttle.busy = false;
+        else if(!throttle.busy) {
+            throttle.busy = true;
+            throttle.busy_ms = now_ms;
+        } else if(now_ms - throttle.busy_ms >= TFT_THROTTLE_SETTLE_MS)
+            mode = TFT_THROTTLE_STREAMING;
+    } else
+        throttle.busy = false;
+
+    if(mode != throttle.mode)
+        set_mode(mode, now_ms);
+
+    return modes[throttle.mode].loop_ms;
+}
+
+void tft_throttle_settings_changed(void) {
+    modes[TFT_THROTTLE_NORMAL].loop_ms = tft_settings.loop_ms;
+    modes[TFT_THROTTLE_NORMAL].refr_ms = tft_settings.refr_ms;
+    modes[TFT_THROTTLE_NORMAL].indev_ms = tft_settings.indev_ms;
+
+    if(throttle.mode == TFT_THROTTLE_NORMAL)
+        lvgl_set_task_periods(tft_settings.refr_ms, tft_settings.indev_ms);
+}
+
+tft_throttle_mode_t tft_throttle_mode(void) {
+    return throttle.mode;
+}
+
+status_code_t tft_throttle_command(char *args) {
+    char *arg = tft_command_arg(&args);
+    uint32_t now_ms = hal.get_elapsed_ticks();
+
+    if(arg) {
+        if(!tft_command_is(arg, "RESET") || args)
+            return Status_InvalidStatement;
+
+        for(uint_fast8_t i = 0; i < TFT_THROTTLE_COUNT; i++)
+            throttle.time_ms[i] = 0;
+        throttle.mode_ms = now_ms;
+        throttle.switches = 0;
+
+        return Status_OK;
+    }
+
+    char msg[112];
+    uint32_t time_ms[TFT_THROTTLE_COUNT];
+    tft_throttle_mode_t mode = throttle.mode;
+
+    for(uint_fast8_t i = 0; i < TFT_THROTTLE_COUNT; i++)
+        time_ms[i] = throttle.time_ms[i];
+    time_ms[mode] += now_ms - throttle.mode_ms;
+
+    snprintf(msg, sizeof(msg), "[TFTTHROTTLE:mode=%s,loop_ms=%u,normal_s=%u,cycle_s=%u,streaming_s=%u,switches=%u]" ASCII_EOL,
+              modes[mode].name, modes[mode].loop_ms,
+              (unsigned)(time_ms[TFT_THROTTLE_NORMAL] / 1000),
+              (unsigned)(time_ms[TFT_THROTTLE_CYCLE] / 1000),
+              (unsigned)(time_ms[TFT_THROTTLE_STREAMING] / 1000),
+              (unsigned)throttle.switches);
+    hal.stream.write(msg);
+
+    return Status_OK;
+}
+
+void tft_throttle_init(void) {
+    throttle.mode = TFT_THROTTLE_NORMAL;
+    throttle.mode_ms = hal.get_elapsed_ticks();
+    tft_throttle_settings_changed();
+    touch_filter = lvgl_set_touch_filter(throttle_touch_filter);
+}
+
+#endif // TFT_ENABLE && TFT_THROTTLE_ENABLE
@@ -0,0 +1,51 @@
+/*
+ * tft_throttle.h - Motion aware UI throttling
+ *
+ * Part of grblHAL TFT Plugin
+ *
+ * Copyright (c) 2025
+ *
+ * Core 0 also runs WiFi and stream I/O. While a job runs the UI loop,
+ * LVGL refresh and touch polling are slowed down, more so while the
+ * planner is nearly full or the receive buffer is busy (dense G-code being
+ * streamed). Any other state and any touch restore full rate at once.
+ * $TFT=THROTTLE reports the current mode and the time spent in each.
+ */
+
+#ifndef _TFT_THROTTLE_H_
+#define _TFT_THROTTLE_H_
+
+#include <stdint.h>
+#include "grbl/hal.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef enum {
+    TFT_THROTTLE_NORMAL = 0,    // Full rate
+    TFT_THROTTLE_CYCLE,         // Job running
+    TFT_THROTTLE_STREAMING,     // Job running, planner or receive buffer busy
+    TFT_THROTTLE_COUNT
+} tft_throttle_mode_t;
+
+// Install touch filter, call once after lvgl_init()
+void tft_throttle_init(void);
+
+// Pick mode for the machine state and buffer levels, apply LVGL task periods on change.
+// Returns the UI loop period in ms. UI task, outside lv_task_handler().
+uint32_t tft_throttle_update(sys_state_t state, uint32_t now_ms);
+
+// Take normal mode periods from tft_settings, UI task
+void tft_throttle_settings_changed(void);
+
+tft_throttle_mode_t tft_throttle_mode(void);
+
+// $TFT=THROTTLE[,RESET]
+status_code_t tft_throttle_command(char *args);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // _TFT_THROTTLE_H_
@@ -0,0 +1,331 @@
+/*
+ * tft_touch_script.c - Scripted touch automation and screen benchmark
+ *
+ * Part of grblHAL TFT Plugin
+ *
+ * Copyright (c) 2025
+ *
+ */
+
+#include "driver.h"
+
+#if TFT_ENABLE && TFT_AUTOMATION_ENABLE
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "esp_timer.h"
+#include "grbl/hal.h"
+
+#include "tft_commands.h"
+#include "tft_events.h"
+#include "tft_screens.h"
+#include "tft_touch_script.h"
+#include "lvgl_init.h"
+
+typedef enum {
+    Step_Tap = 0,
+    Step_Long,
+    Step_Drag,
+    Step_Wait,
+    Step_ExpectScreen,
+    Step_ExpectCrc
+} step_type_t;
+
+typedef struct {
+    uint8_t type;               // step_type_t
+    uint8_t screen;             // tft_screen_id_t for Step_ExpectScreen
+    uint16_t ms;                // Press, drag or wait duration
+    uint16_t x1, y1, x2, y2;
+    uint32_t crc;               // Step_ExpectCrc
+} script_step_t;
+
+static script_step_t steps[TFT_TOUCH_SCRIPT_STEPS];
+
+static struct {
+    volatile bool running;      // Set by the UI task only
+    uint8_t count;
+    uint8_t current;
+    uint32_t now_ms;            // Time of last poll
+    uint32_t start_ms;          // Script start
+    uint32_t step_ms;           // Current step start
+    bool pressed;
+    uint16_t x, y;
+} script;
+
+static lvgl_touch_filter_ptr touch_filter;
+
+/*
+ * Input path
+ */
+
+static bool script_touch_filter(bool touched, uint16_t *x, uint16_t *y) {
+    if(touch_filter)
+        touched = touch_filter(touched, x, y);
+
+    // The script replaces the panel while running
+    if(script.running) {
+        touched = script.pressed;
+        *x = script.x;
+        *y = script.y;
+    }
+
+    return touched;
+}
+
+static void script_end(bool pass, const char *detail) {
+    char msg[96];
+
+    script.running = false;
+    script.pressed = false;
+
+    if(pass)
+        snprintf(msg, sizeof(msg), "[TFTTOUCH:PASS,steps=%u,ms=%u]" ASCII_EOL,
+                  script.count, (unsigned)(script.step_ms - script.start_ms));
+    else
+        snprintf(msg, sizeof(msg), "[TFTTOUCH:FAIL,step=%u,%s]" ASCII_EOL, script.current + 1, detail);
+
+    hal.stream.write(msg);
+}
+
+void tft_touch_script_poll(uint32_t now_ms) {
+    char detail[48];
+
+    script.now_ms = now_ms;
+
+    while(script.running) {
+        script_step_t *step = &steps[script.current];
+        uint32_t elapsed = now_ms - script.step_ms;
+        uint32_t hold_ms = step->type == Step_Tap ? TFT_TOUCH_TAP_MS : step->ms;
+
+        switch((step_type_t)step->type) {
+
+            case Step_Tap:
+            case Step_Long:
+            case Step_Drag:
+                if(elapsed < hold_ms) {
+                    script.pressed = true;
+                    if(step->type == Step_Drag) {
+                        script.x = step->x1 + (int32_t)(step->x2 - step->x1) * (int32_t)elapsed / (int32_t)hold_ms;
+                        script.y = step->y1 + (int32_t)(step->y2 - step->y1) * (int32_t)elapsed / (int32_t)hold_ms;
+                    } else {
+                        script.x = step->x1;
+                        script.y = step->y1;
+                    }
+                    return;
+                }
+                if(step->type == Step_Drag) {
+                    script.x = step->x2;
+                    script.y = step->y2;
+                }
+                // Stay released long enough for LVGL to read the release
+                script.pressed = false;
+                if(elapsed < hold_ms + TFT_TOUCH_RELEASE_MS)
+                    return;
+                break;
+
+            case Step_Wait:
+                script.pressed = false;
+                if(elapsed < step->ms)
+                    return;
+                break;
+
+            case Step_ExpectScreen:
+                if(tft_screen_active() != step->screen) {
+                    snprintf(detail, sizeof(detail), "expected=%s,actual=%s",
+                              tft_screen_name((tft_screen_id_t)step->screen), tft_screen_name(tft_screen_active()));
+                    script_end(false, detail);
+                    return;
+                }
+                break;
+
+            case Step_ExpectCrc:
+                {
+                    lvgl_refresh_stats_t stats;
+
+                    lvgl_refresh_screen(&stats);
+                    if(stats.crc != step->crc) {
+                        snprintf(detail, sizeof(detail), "expected=%08X,actual=%08X", (unsigned)step->crc, (unsigned)stats.crc);
+                        script_end(false, detail);
+                        return;
+                    }
+                }
+                break;
+        }
+
+        script.step_ms = now_ms;
+        if(++script.current == script.count)
+            script_end(true, NULL);
+    }
+}
+
+/*
+ * UI task requests
+ */
+
+static void ui_run_script(uint32_t arg) {
+    if(script.count == 0 || script.running)
+        return;
+
+    script.current = 0;
+    script.start_ms = script.step_ms = script.now_ms;
+    script.pressed = false;
+    script.running = true;
+}
+
+static void ui_report_crc(uint32_t arg) {
+    char msg[48];
+    lvgl_refresh_stats_t stats;
+
+    lvgl_refresh_screen(&stats);
+    snprintf(msg, sizeof(msg), "[TFTTOUCH:CRC,%s,%08X]" ASCII_EOL, tft_screen_name(tft_screen_active()), (unsigned)stats.crc);
+    hal.stream.write(msg);
+}
+
+static void ui_run_bench(uint32_t arg) {
+    char msg[160];
+    tft_screen_id_t prev = tft_screen_active();
+
+    for(uint_fast8_t id = 0; id < TFT_SCREEN_COUNT; id++) {
+        lvgl_refresh_stats_t stats;
+        lv_mem_monitor_t mem;
+        uint32_t render_us = 0, flush_us = 0;
+        uint32_t t0 = (uint32_t)esp_timer_get_time();
+
+        tft_screen_show((tft_screen_id_t)id);
+
+        uint32_t create_us = (uint32_t)esp_timer_get_time() - t0;
+
+        for(uint_fast8_t pass = 0; pass < TFT_BENCH_PASSES; pass++) {
+            lvgl_refresh_screen(&stats);
+            render_us += stats.render_us;
+            flush_us += stats.flush_us;
+        }
+
+        lv_mem_monitor(&mem);
+
+        snprintf(msg, sizeof(msg), "[TFTBENCH:screen=%s,create_us=%u,render_us=%u,flush_us=%u,pixels=%u,mem_used=%u,mem_max=%u,frag_pct=%u,crc=%08X]" ASCII_EOL,
+                  tft_screen_name((tft_screen_id_t)id),
+                  (unsigned)create_us,
+                  (unsigned)(render_us / TFT_BENCH_PASSES),
+                  (unsigned)(flush_us / TFT_BENCH_PASSES),
+                  (unsigned)stats.pixels,
+                  (unsigned)(mem.total_size - mem.free_size),
+                  (unsigned)mem.max_used,
+                  (unsigned)mem.frag_pct,
+                  (unsigned)stats.crc);
+        hal.stream.write(msg);
+    }
+
+    hal.stream.write("[TFTBENCH:END]" ASCII_EOL);
+
+    tft_screen_show(prev);
+}
+
+/*
+ * $TFT=TOUCH
+ */
+
+// Parse count unsigned integer arguments, missing optional ones keep their value
+static bool parse_uints(char **args, uint16_t *out[], uint_fast8_t count, uint_fast8_t required) {
+    for(uint_fast8_t i = 0; i < count; i++) {
+        char *arg = tft_command_arg(args), *end;
+
+        if(arg == NULL)
+            return i >= required;
+
+        unsigned long v = strtoul(arg, &end, 10);
+        if(*end || v > UINT16_MAX)
+            return false;
+        *out[i] = (uint16_t)v;
+    }
+
+    return *args == NULL;
+}
+
+status_code_t tft_touch_script_command(char *args) {
+    char *arg = tft_command_arg(&args);
+
+    if(arg == NULL) {
+        char msg[64];
+        snprintf(msg, sizeof(msg), "[TFTTOUCH:%s,steps=%u,capacity=%u]" ASCII_EOL,
+                  script.running ? "running" : "idle", script.count, TFT_TOUCH_SCRIPT_STEPS);
+        hal.stream.write(msg);
+        return Status_OK;
+    }
+
+    // The queue belongs to the UI task while running
+    if(script.running)
+        return Status_InvalidStatement;
+
+    if(tft_command_is(arg, "CLEAR")) {
+        script.count = 0;
+        return Status_OK;
+    }
+
+    if(tft_command_is(arg, "RUN"))
+        return tft_ui_call(ui_run_script, 0) ? Status_OK : Status_InvalidStatement;
+
+    if(tft_command_is(arg, "CRC"))
+        return tft_ui_call(ui_report_crc, 0) ? Status_OK : Status_InvalidStatement;
+
+    if(script.count >= TFT_TOUCH_SCRIPT_STEPS)
+        return Status_InvalidStatement;
+
+    script_step_t step = {0};
+    bool ok;
+
+    if(tft_command_is(arg, "TAP")) {
+        step.type = Step_Tap;
+        ok = parse_uints(&args, (uint16_t *[]){ &step.x1, &step.y1 }, 2, 2);
+    } else if(tft_command_is(arg, "LONG")) {
+        step.type = Step_Long;
+        step.ms = TFT_TOUCH_LONG_MS;
+        ok = parse_uints(&args, (uint16_t *[]){ &step.x1, &step.y1, &step.ms }, 3, 2);
+    } else if(tft_command_is(arg, "DRAG")) {
+        step.type = Step_Drag;
+        step.ms = TFT_TOUCH_DRAG_MS;
+        ok = parse_uints(&args, (uint16_t *[]){ &step.x1, &step.y1, &step.x2, &step.y2, &step.ms }, 5, 4) && step.ms;
+    } else if(tft_command_is(arg, "WAIT")) {
+        step.type = Step_Wait;
+        ok = parse_uints(&args, (uint16_t *[]){ &step.ms }, 1, 1);
+    } else if(tft_command_is(arg, "EXPECT")) {
+        char *what = tft_command_arg(&args), *value = tft_command_arg(&args), *end;
+        tft_screen_id_t id;
+
+        if(what == NULL || value == NULL || args)
+            ok = false;
+        else if(tft_command_is(what, "SCREEN")) {
+            step.type = Step_ExpectScreen;
+            if((ok = tft_screen_find(value, &id)))
+                step.screen = (uint8_t)id;
+        } else if(tft_command_is(what, "CRC")) {
+            step.type = Step_ExpectCrc;
+            step.crc = strtoul(value, &end, 16);
+            ok = *end == '\0';
+        } else
+            ok = false;
+    } else
+        ok = false;
+
+    if(!ok)
+        return Status_InvalidStatement;
+
+    steps[script.count++] = step;
+
+    return Status_OK;
+}
+
+status_code_t tft_bench_command(char *args) {
+    if(args || script.running)
+        return Status_InvalidStatement;
+
+    return tft_ui_call(ui_run_bench, 0) ? Status_OK : Status_InvalidStatement;
+}
+
+void tft_touch_script_init(void) {
+    touch_filter = lvgl_set_touch_filter(script_touch_filter);
+}
+
+#endif // TFT_ENABLE && TFT_AUTOMATION_ENABLE
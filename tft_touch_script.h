@@ -0,0 +1,46 @@
+/*
+ * tft_touch_script.h - Scripted touch automation and screen benchmark
+ *
+ * Part of grblHAL TFT Plugin
+ *
+ * Copyright (c) 2025
+ *
+ * Touch steps are queued with $TFT=TOUCH,<step> and played back through
+ * the lvgl_touch_read() filter chain in place of the panel, so they exercise the same input
+ * path (and latency measurement) as a finger. Expect steps check the active
+ * screen or a framebuffer CRC. $TFT=BENCH renders every screen and reports
+ * render time, flushed pixels and LVGL memory use.
+ * tools/tft_touch.py runs script files and collects benchmark results.
+ */
+
+#ifndef _TFT_TOUCH_SCRIPT_H_
+#define _TFT_TOUCH_SCRIPT_H_
+
+#include "grbl/hal.h"
+#include "tft_config.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#if TFT_AUTOMATION_ENABLE
+
+// Install touch filter, call once after lvgl_init()
+void tft_touch_script_init(void);
+
+// Advance script, call from UI task outside lv_task_handler()
+void tft_touch_script_poll(uint32_t now_ms);
+
+// $TFT=TOUCH[,TAP,x,y|LONG,x,y[,ms]|DRAG,x1,y1,x2,y2[,ms]|WAIT,ms|EXPECT,SCREEN,name|EXPECT,CRC,hex|CRC|RUN|CLEAR]
+status_code_t tft_touch_script_command(char *args);
+
+// $TFT=BENCH
+status_code_t tft_bench_command(char *args);
+
+#endif // TFT_AUTOMATION_ENABLE
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // _TFT_TOUCH_SCRIPT_H_
@@ -0,0 +1,451 @@
+/*
+ * tft_trace.c - grblHAL event trace recorder and replayer
+ *
+ * Part of grblHAL TFT Plugin
+ *
+ * Copyright (c) 2025
+ *
+ */
+
+#include "driver.h"
+
+#if TFT_ENABLE && TFT_TRACE_ENABLE
+
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+
+#include "grbl/hal.h"
+
+#include "tft_config.h"
+#include "tft_commands.h"
+#include "tft_trace.h"
+
+typedef enum {
+    Trace_Idle = 0,
+    Trace_Recording,
+    Trace_Replaying
+} trace_mode_t;
+
+// Delta coding state, shared layout for encoder and decoder
+typedef struct {
+    int32_t mpos[N_AXIS];
+    int32_t wco[N_AXIS];
+    int32_t feed;
+} trace_ref_t;
+
+static struct {
+    trace_mode_t mode;
+    uint32_t len;               // Bytes used in buf
+    uint32_t records;
+    bool truncated;             // Recording stopped because buf is full
+    uint32_t last_ms;
+    trace_ref_t ref;
+} trace;
+
+static struct {
+    bool fast;
+    uint32_t pos;               // Read position in buf
+    uint32_t start_ms;
+    uint32_t due_ms;            // Trace time of next record, relative to start
+    uint32_t events;
+    bool have_next;
+    tft_event_t next;
+    uint32_t dropped0;          // Queue stats when replay started
+    uint32_t frames;
+    uint32_t frame_max_us;
+    uint64_t frame_total_us;
+    trace_ref_t ref;
+} replay;
+
+static uint8_t buf[TFT_TRACE_BUFFER_SIZE];
+
+static on_execute_realtime_ptr on_execute_realtime;
+
+/*
+ * Encoding
+ */
+
+static uint8_t *put_varint(uint8_t *p, uint32_t v) {
+    while(v >= 0x80) {
+        *p++ = (uint8_t)(v | 0x80);
+        v >>= 7;
+    }
+    *p++ = (uint8_t)v;
+
+    return p;
+}
+
+static uint8_t *put_zigzag(uint8_t *p, int32_t v) {
+    return put_varint(p, ((uint32_t)v << 1) ^ (uint32_t)(v >> 31));
+}
+
+static bool get_varint(uint32_t *pos, uint32_t *v) {
+    uint32_t result = 0;
+    uint_fast8_t shift = 0;
+
+    do {
+        if(*pos >= trace.len || shift > 28)
+            return false;
+        result |= (uint32_t)(buf[*pos] & 0x7F) << shift;
+        shift += 7;
+    } while(buf[(*pos)++] & 0x80);
+
+    *v = result;
+
+    return true;
+}
+
+static bool get_zigzag(uint32_t *pos, int32_t *v) {
+    uint32_t u;
+
+    if(!get_varint(pos, &u))
+        return false;
+
+    *v = (int32_t)(u >> 1) ^ -(int32_t)(u & 1);
+
+    return true;
+}
+
+static inline int32_t to_um(float mm) {
+    return (int32_t)lroundf(mm * 1000.0f);
+}
+
+static void trace_clear(void) {
+    memcpy(buf, TFT_TRACE_MAGIC, 4);
+    buf[4] = TFT_TRACE_VERSION;
+    buf[5] = N_AXIS;
+    buf[6] = buf[7] = 0;
+
+    trace.len = TFT_TRACE_HDR_SIZE;
+    trace.records = 0;
+    trace.truncated = false;
+    memset(&trace.ref, 0, sizeof(trace_ref_t));
+}
+
+void tft_trace_record(const tft_event_t *evt) {
+    uint8_t rec[16 + N_AXIS * 10], *p = rec;
+
+    if(trace.mode != Trace_Recording)
+        return;
+
+    uint32_t now = hal.get_elapsed_ticks();
+
+    p = put_varint(p, now - trace.last_ms);
+    *p++ = evt->type;
+
+    switch((tft_event_type_t)evt->type) {
+
+        case TFT_EVT_STATE:
+            p = put_varint(p, evt->state.state);
+            p = put_varint(p, evt->state.alarm);
+            break;
+
+        case TFT_EVT_REPORT:
+            {
+                trace_ref_t cur;
+
+                for(uint_fast8_t i = 0; i < N_AXIS; i++) {
+                    cur.mpos[i] = to_um(evt->report.mpos[i]);
+                    cur.wco[i] = to_um(evt->report.mpos[i] - evt->report.wpos[i]);
+                    p = put_zigzag(p, cur.mpos[i] - trace.ref.mpos[i]);
+                }
+                for(uint_fast8_t i = 0; i < N_AXIS; i++)
+                    p = put_zigzag(p, cur.wco[i] - trace.ref.wco[i]);
+                cur.feed = (int32_t)lroundf(evt->report.feed_rate * 10.0f);
+                p = put_zigzag(p, cur.feed - trace.ref.feed);
+
+                // Only commit the reference once the record is known to fit
+                if(trace.len + (p - rec) <= sizeof(buf))
+                    trace.ref = cur;
+            }
+            break;
+
+        case TFT_EVT_PROGRAM:
+            *p++ = evt->program.flow;
+            *p++ = evt->program.check_mode;
+            break;
+
+        default:
+            break;
+    }
+
+    if(trace.len + (p - rec) > sizeof(buf)) {
+        trace.truncated = true;
+        trace.mode = Trace_Idle;
+        return;
+    }
+
+    memcpy(&buf[trace.len], rec, p - rec);
+    trace.len += p - rec;
+    trace.records++;
+    trace.last_ms = now;
+}
+
+/*
+ * Replay
+ */
+
+// Decode record at replay.pos into replay.next, false at end of trace or on corrupt data
+static bool read_next(void) {
+    uint32_t dt, v;
+    tft_event_t *evt = &replay.next;
+
+    if(replay.pos >= trace.len || !get_varint(&replay.pos, &dt) || replay.pos >= trace.len)
+        return false;
+
+    memset(evt, 0, sizeof(tft_event_t));
+    evt->type = buf[replay.pos++];
+
+    switch((tft_event_type_t)evt->type) {
+
+        case TFT_EVT_STATE:
+            if(!get_varint(&replay.pos, &v))
+                return false;
+            evt->state.state = (sys_state_t)v;
+            if(!get_varint(&replay.pos, &v))
+                return false;
+            evt->state.alarm = (alarm_code_t)v;
+            break;
+
+        case TFT_EVT_REPORT:
+            {
+                int32_t d;
+
+                for(uint_fast8_t i = 0; i < N_AXIS; i++) {
+                    if(!get_zigzag(&replay.pos, &d))
+                        return false;
+                    replay.ref.mpos[i] += d;
+                }
+                for(uint_fast8_t i = 0; i < N_AXIS; i++) {
+                    if(!get_zigzag(&replay.pos, &d))
+                        return false;
+                    replay.ref.wco[i] += d;
+                }
+                if(!get_zigzag(&replay.pos, &d))
+                    return false;
+                replay.ref.feed += d;
+
+                for(uint_fast8_t i = 0; i < N_AXIS; i++) {
+                    evt->report.mpos[i] = (float)replay.ref.mpos[i] / 1000.0f;
+                    evt->report.wpos[i] = (float)(replay.ref.mpos[i] - replay.ref.wco[i]) / 1000.0f;
+                }
+                evt->report.feed_rate = (float)replay.ref.feed / 10.0f;
+            }
+            break;
+
+        case TFT_EVT_PROGRAM:
+            if(replay.pos + 2 > trace.len)
+                return false;
+            evt->program.flow = buf[replay.pos++];
+            evt->program.check_mode = buf[replay.pos++] != 0;
+            break;
+
+        case TFT_EVT_RESET:
+            break;
+
+        default:
+            return false;
+    }
+
+    replay.due_ms += dt;
+
+    return true;
+}
+
+static void replay_report(void) {
+    char msg[128];
+    const tft_event_stats_t *stats = tft_events_get_stats();
+
+    snprintf(msg, sizeof(msg), "[TFTREPLAY:events=%u,duration_ms=%u,frames=%u,frame_avg_us=%u,frame_max_us=%u,dropped=%u,max_queue=%u]" ASCII_EOL,
+              (unsigned)replay.events,
+              (unsigned)(hal.get_elapsed_ticks() - replay.start_ms),
+              (unsigned)replay.frames,
+              (unsigned)(replay.frames ? replay.frame_total_us / replay.frames : 0),
+              (unsigned)replay.frame_max_us,
+              (unsigned)(stats->dropped - replay.dropped0),
+              (unsigned)stats->max_depth);
+    hal.stream.write(msg);
+}
+
+static void replay_poll(sys_state_t state) {
+    if(on_execute_realtime)
+        on_execute_realtime(state);
+
+    if(trace.mode != Trace_Replaying)
+        return;
+
+    uint32_t elapsed = hal.get_elapsed_ticks() - replay.start_ms;
+
+    while(replay.have_next && (replay.fast || replay.due_ms <= elapsed)) {
+        if(replay.fast) {
+            // Back pressure: wait for the UI task instead of dropping
+            if(!tft_event_try_post(&replay.next))
+                break;
+        } else
+            tft_event_post(&replay.next);
+
+        replay.events++;
+        replay.have_next = read_next();
+    }
+
+    if(!replay.have_next && tft_events_pending() == 0) {
+        trace.mode = Trace_Idle;
+        replay_report();
+    }
+}
+
+bool tft_trace_replaying(void) {
+    return trace.mode == Trace_Replaying;
+}
+
+void tft_trace_frame(uint32_t us) {
+    if(trace.mode == Trace_Replaying) {
+        replay.frames++;
+        replay.frame_total_us += us;
+        if(us > replay.frame_max_us)
+            replay.frame_max_us = us;
+    }
+}
+
+/*
+ * $TFT=TRACE
+ */
+
+static void trace_status(void) {
+    char msg[96];
+    static const char *const mode_name[] = { "idle", "recording", "replaying" };
+
+    snprintf(msg, sizeof(msg), "[TFTTRACE:%s,bytes=%u,records=%u,capacity=%u%s]" ASCII_EOL,
+              mode_name[trace.mode],
+              (unsigned)trace.len,
+              (unsigned)trace.records,
+              (unsigned)sizeof(buf),
+              trace.truncated ? ",truncated" : "");
+    hal.stream.write(msg);
+}
+
+static void trace_dump(void) {
+    static const char hex[] = "0123456789ABCDEF";
+    char line[10 + TFT_TRACE_DUMP_BYTES * 2 + 4];
+    uint32_t pos = 0;
+
+    while(pos < trace.len) {
+        char *p = line + 10;
+        uint32_t n = trace.len - pos > TFT_TRACE_DUMP_BYTES ? TFT_TRACE_DUMP_BYTES : trace.len - pos;
+
+        memcpy(line, "[TFTTRACE:", 10);
+        while(n--) {
+            *p++ = hex[buf[pos] >> 4];
+            *p++ = hex[buf[pos] & 0x0F];
+            pos++;
+        }
+        strcpy(p, "]" ASCII_EOL);
+        hal.stream.write(line);
+    }
+
+    snprintf(line, sizeof(line), "[TFTTRACE:END,%u]" ASCII_EOL, (unsigned)trace.len);
+    hal.stream.write(line);
+}
+
+static int hex_nibble(char c) {
+    if(c >= '0' && c <= '9')
+        return c - '0';
+    c |= 0x20;
+    if(c >= 'a' && c <= 'f')
+        return c - 'a' + 10;
+
+    return -1;
+}
+
+// Append hex data, the first chunk must start with the header
+static status_code_t trace_load(const char *data) {
+    uint32_t len = trace.len;
+
+    if(data == NULL)
+        return Status_InvalidStatement;
+
+    while(data[0] && data[1]) {
+        int hi = hex_nibble(data[0]), lo = hex_nibble(data[1]);
+        if(hi < 0 || lo < 0 || len >= sizeof(buf))
+            return Status_InvalidStatement;
+        buf[len++] = (uint8_t)((hi << 4) | lo);
+        data += 2;
+    }
+
+    if(*data)
+        return Status_InvalidStatement;
+
+    if(len >= TFT_TRACE_HDR_SIZE &&
+        (memcmp(buf, TFT_TRACE_MAGIC, 4) || buf[4] != TFT_TRACE_VERSION || buf[5] != N_AXIS))
+        return Status_InvalidStatement;
+
+    trace.len = len;
+
+    return Status_OK;
+}
+
+static status_code_t trace_play(bool fast) {
+    if(trace.len <= TFT_TRACE_HDR_SIZE)
+        return Status_InvalidStatement;
+
+    memset(&replay, 0, sizeof(replay));
+    replay.fast = fast;
+    replay.pos = TFT_TRACE_HDR_SIZE;
+    replay.dropped0 = tft_events_get_stats()->dropped;
+    replay.start_ms = hal.get_elapsed_ticks();
+    replay.have_next = read_next();
+    trace.mode = Trace_Replaying;
+
+    return Status_OK;
+}
+
+status_code_t tft_trace_command(char *args) {
+    char *arg = tft_command_arg(&args);
+
+    if(arg == NULL) {
+        trace_status();
+        return Status_OK;
+    }
+
+    // Anything but status and stop is refused while replaying
+    if(trace.mode == Trace_Replaying && !tft_command_is(arg, "STOP"))
+        return Status_InvalidStatement;
+
+    if(tft_command_is(arg, "REC")) {
+        trace_clear();
+        trace.last_ms = hal.get_elapsed_ticks();
+        trace.mode = Trace_Recording;
+    } else if(tft_command_is(arg, "STOP")) {
+        trace.mode = Trace_Idle;
+        trace_status();
+    } else if(tft_command_is(arg, "CLEAR")) {
+        trace.mode = Trace_Idle;
+        trace.len = 0;
+        trace.records = 0;
+        trace.truncated = false;
+    } else if(tft_command_is(arg, "DUMP")) {
+        trace.mode = Trace_Idle;
+        trace_dump();
+    } else if(tft_command_is(arg, "LOAD")) {
+        trace.mode = Trace_Idle;
+        return trace_load(tft_command_arg(&args));
+    } else if(tft_command_is(arg, "PLAY")) {
+        char *opt = tft_command_arg(&args);
+        if(opt && !tft_command_is(opt, "FAST"))
+            return Status_InvalidStatement;
+        return trace_play(opt != NULL);
+    } else
+        return Status_InvalidStatement;
+
+    return Status_OK;
+}
+
+void tft_trace_init(void) {
+    trace_clear();
+
+    on_execute_realtime = grbl.on_execute_realtime;
+    grbl.on_execute_realtime = replay_poll;
+}
+
+#endif // TFT_ENABLE && TFT_TRACE_ENABLE
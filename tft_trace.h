@@ -0,0 +1,59 @@
+/*
+ * tft_trace.h - grblHAL event trace recorder and replayer
+ *
+ * Part of grblHAL TFT Plugin
+ *
+ * Copyright (c) 2025
+ *
+ * Records the events posted by the grblHAL hooks into a RAM buffer and
+ * replays them into the UI event queue, either in real time or as fast as
+ * the UI task drains the queue. Traces are moved to and from a host as hex
+ * lines with $TFT=TRACE,DUMP and $TFT=TRACE,LOAD (see tools/tft_trace.py).
+ *
+ * Trace format (little endian, varints are LEB128, zz = zigzag varint):
+ *
+ *   header:  'T' 'F' 'T' 'R'  version:u8  n_axis:u8  reserved:u16
+ *   record:  dt_ms:varint  type:u8  payload
+ *
+ *   TFT_EVT_STATE    state:varint  alarm:varint
+ *   TFT_EVT_REPORT   mpos_um[n_axis]:zz  wco_um[n_axis]:zz  feed_x10:zz
+ *                    (each a delta to the previous report, wco = mpos - wpos)
+ *   TFT_EVT_PROGRAM  flow:u8  check_mode:u8
+ *   TFT_EVT_RESET    -
+ */
+
+#ifndef _TFT_TRACE_H_
+#define _TFT_TRACE_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "tft_events.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define TFT_TRACE_MAGIC     "TFTR"
+#define TFT_TRACE_VERSION   1
+#define TFT_TRACE_HDR_SIZE  8
+
+// Attach replay driver to the grblHAL foreground loop
+void tft_trace_init(void);
+
+// Append event to trace if recording (grblHAL task)
+void tft_trace_record(const tft_event_t *evt);
+
+// True while a replay owns the event queue, live events must not be posted
+bool tft_trace_replaying(void);
+
+// UI task frame time, collected while replaying
+void tft_trace_frame(uint32_t us);
+
+// $TFT=TRACE[,REC|STOP|CLEAR|DUMP|LOAD,<hex>|PLAY[,FAST]]
+status_code_t tft_trace_command(char *args);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // _TFT_TRACE_H_
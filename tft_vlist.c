@@ -0,0 +1,351 @@
+/*
+ * tft_vlist.c - Recycling virtualized list
+ *
+ * Part of grblHAL TFT Plugin
+ *
+ * Copyright (c) 2025
+ *
+ */
+
+#include "driver.h"
+
+#if TFT_ENABLE
+
+#include <stdlib.h>
+
+#include "tft_config.h"
+#include "tft_vlist.h"
+
+#define NO_ITEM UINT32_MAX
+
+typedef struct {
+    lv_obj_t *obj;
+    uint32_t item;              // Item bound, NO_ITEM to rebind
+    bool in_range;              // Item was in the source range when bound
+    const lv_style_t *style;
+} row_t;
+
+static struct {
+    const tft_vlist_source_t *source;
+    const lv_style_t *style;
+    lv_obj_t *cont;
+    row_t *row;
+    char *text;                 // rows x (text_max + 1)
+    uint16_t rows;
+    uint16_t page;              // Rows that fit entirely
+    lv_coord_t row_height;
+    uint8_t text_max;
+    uint32_t first, end;        // Source range at the last update
+    uint32_t top;               // First visible item
+    lv_coord_t offset;          // Pixels of the top item scrolled out, 0 - row height
+    bool can_follow;
+    bool follow;                // Keep the last item in view
+    uint16_t moved;             // Drag distance of the current press
+    uint32_t cursor;            // Keypad cursor item
+    bool keyed;                 // Cursor shown, a key has moved it
+    lv_style_t style_cursor;
+} list;
+
+static tft_vlist_stats_t stats;
+
+static void bind(row_t *row, uint32_t n) {
+    char *text = list.text + (row - list.row) * (list.text_max + 1);
+    const lv_style_t *style = list.style;
+
+    row->in_range = n - list.first < list.end - list.first;
+
+    if(!(row->in_range && list.source->item(n, text, list.text_max + 1, &style))) {
+        *text = '\0';
+        style = list.style;
+    }
+
+    if(list.keyed && n == list.cursor)
+        style = &list.style_cursor;
+
+    if(style != row->style) {
+        row->style = style;
+        lv_obj_set_style(row->obj, style);
+    }
+
+    row->item = n;
+    lv_label_set_static_text(row->obj, text);
+    stats.binds++;
+}
+
+// Bind and place the visible rows and the overscan around them
+static void layout(void) {
+    uint32_t start = list.top - list.first > TFT_VLIST_OVERSCAN ? list.top - TFT_VLIST_OVERSCAN : list.first;
+
+    for(uint_fast16_t i = 0; i < list.rows; i++) {
+        uint32_t n = start + i;
+        row_t *row = &list.row[n % list.rows];
+
+        if(row->item != n)
+            bind(row, n);
+
+        lv_obj_set_y(row->obj, (lv_coord_t)((int32_t)(n - list.top) * list.row_height - list.offset));
+    }
+}
+
+// Last allowed top item, the last item at the bottom
+static uint32_t top_max(void) {
+    return list.end - list.first > list.page ? list.end - list.page : list.first;
+}
+
+static void clamp(void) {
+    uint32_t max = top_max();
+
+    if((int32_t)(list.top - list.first) < 0) {
+        list.top = list.first;
+        list.offset = 0;
+    }
+
+    if((int32_t)(list.top - max) >= 0) {
+        list.top = max;
+        list.offset = 0;
+    }
+
+    list.follow = list.can_follow && list.top == max;
+}
+
+static void scroll_by(lv_coord_t dy) {
+    int32_t offset = list.offset + dy;
+
+    while(offset >= list.row_height) {
+        offset -= list.row_height;
+        list.top++;
+    }
+
+    while(offset < 0) {
+        offset += list.row_height;
+        list.top--;
+    }
+
+    list.offset = (lv_coord_t)offset;
+    stats.scrolls++;
+
+    clamp();
+    layout();
+}
+
+// Move the keypad cursor to item n, or the nearest in range, and keep it in view
+static void set_cursor(uint32_t n) {
+    if(list.end == list.first)
+        return;
+
+    if((int32_t)(n - list.first) < 0)
+        n = list.first;
+    if((int32_t)(n - (list.end - 1)) > 0)
+        n = list.end - 1;
+
+    list.row[list.cursor % list.rows].item = NO_ITEM;
+    list.row[n % list.rows].item = NO_ITEM;
+    list.cursor = n;
+    list.keyed = true;
+
+    if((int32_t)(n - list.top) < 0 || (n == list.top && list.offset)) {
+        list.top = n;
+        list.offset = 0;
+    } else if(n - list.top >= list.page) {
+        list.top = n - (list.page ? list.page - 1 : 0);
+        list.offset = 0;
+    }
+
+    clamp();
+    layout();
+}
+
+static void list_key(uint32_t key) {
+    switch(key) {
+
+        case LV_KEY_UP:
+            set_cursor(list.cursor - 1);
+            break;
+
+        case LV_KEY_DOWN:
+            set_cursor(list.cursor + 1);
+            break;
+
+        case LV_KEY_LEFT:
+            set_cursor(list.cursor - list.page);
+            break;
+
+        case LV_KEY_RIGHT:
+            set_cursor(list.cursor + list.page);
+            break;
+
+        case LV_KEY_HOME:
+            set_cursor(list.first);
+            break;
+
+        case LV_KEY_END:
+            set_cursor(list.end - 1);
+            break;
+
+        default:
+            break;
+    }
+}
+
+static void list_event(lv_obj_t *obj, lv_event_t event) {
+    lv_indev_t *indev = lv_indev_get_act();
+
+    switch(event) {
+
+        case LV_EVENT_PRESSED:
+            list.moved = 0;
+            break;
+
+        case LV_EVENT_PRESSING:
+            {
+                lv_point_t vect;
+
+                lv_indev_get_vect(indev, &vect);
+                list.moved += abs(vect.x) + abs(vect.y);
+                if(vect.y)
+                    scroll_by(-vect.y);
+            }
+            break;
+
+        case LV_EVENT_KEY:
+            list_key(*(const uint32_t *)lv_event_get_data());
+            break;
+
+        case LV_EVENT_RELEASED:
+            // ENTER on the keypad clicks the cursor item
+            if(lv_indev_get_type(indev) == LV_INDEV_TYPE_KEYPAD) {
+                if(list.source->clicked && list.keyed && list.cursor - list.first < list.end - list.first)
+                    list.source->clicked(list.cursor);
+            } else if(list.source->clicked && list.moved < LV_INDEV_DEF_DRAG_LIMIT) {
+                lv_point_t point;
+                lv_area_t area;
+
+                lv_indev_get_point(indev, &point);
+                lv_obj_get_coords(obj, &area);
+
+                uint32_t n = list.top + (point.y - area.y1 + list.offset) / list.row_height;
+
+                if(n - list.first < list.end - list.first)
+                    list.source->clicked(n);
+            }
+            break;
+
+        default:
+            break;
+    }
+}
+
+bool tft_vlist_create(lv_obj_t *parent, lv_coord_t width, lv_coord_t height, lv_coord_t row_height,
+                      uint8_t text_max, const lv_style_t *style, const tft_vlist_source_t *source, bool follow) {
+
+    uint16_t page = height / row_height, rows = page + 1 + 2 * TFT_VLIST_OVERSCAN;
+
+    if((list.row = malloc(rows * (sizeof(row_t) + text_max + 1))) == NULL)
+        return false;
+
+    list.text = (char *)&list.row[rows];
+    list.rows = rows;
+    list.page = page;
+    list.row_height = row_height;
+    list.text_max = text_max;
+    list.style = style;
+    list.source = source;
+    list.can_follow = follow;
+    list.top = list.offset = 0;
+    list.keyed = false;
+
+    lv_style_copy(&list.style_cursor, style);
+    list.style_cursor.body.main_color = list.style_cursor.body.grad_color = LV_COLOR_BLUE;
+    list.style_cursor.body.opa = LV_OPA_COVER;
+    list.style_cursor.text.color = LV_COLOR_WHITE;
+
+    // Rows outside the container are clipped, so the overscan costs no drawing
+    list.cont = lv_cont_create(parent, NULL);
+    lv_obj_set_style(list.cont, style);
+    lv_obj_set_size(list.cont, width, height);
+    lv_obj_set_event_cb(list.cont, list_event);
+
+    for(uint_fast16_t i = 0; i < rows; i++) {
+        row_t *row = &list.row[i];
+
+        row->obj = lv_label_create(list.cont, NULL);
+        lv_label_set_long_mode(row->obj, LV_LABEL_LONG_CROP);
+        lv_obj_set_size(row->obj, width, row_height);
+        lv_obj_set_style(row->obj, style);
+        row->style = style;
+        row->item = NO_ITEM;
+    }
+
+    stats.rows = rows;
+    stats.binds = stats.scrolls = 0;
+
+    source->range(&list.first, &list.end);
+    list.top = follow ? top_max() : list.first;
+    list.cursor = list.top;
+    clamp();
+    layout();
+
+    return true;
+}
+
+void tft_vlist_delete(void) {
+    free(list.row);
+    list.row = NULL;
+    list.rows = 0;
+    list.cont = NULL;
+}
+
+void tft_vlist_update(void) {
+    if(list.row == NULL)
+        return;
+
+    list.source->range(&list.first, &list.end);
+
+    // Rows whose item came or went since binding
+    for(uint_fast16_t i = 0; i < list.rows; i++) {
+        row_t *row = &list.row[i];
+
+        if(row->item != NO_ITEM && (row->item - list.first < list.end - list.first) != row->in_range)
+            row->item = NO_ITEM;
+    }
+
+    if(list.follow)
+        list.top = top_max();
+
+    clamp();
+    layout();
+}
+
+void tft_vlist_refresh(void) {
+    if(list.row == NULL)
+        return;
+
+    for(uint_fast16_t i = 0; i < list.rows; i++)
+        list.row[i].item = NO_ITEM;
+
+    tft_vlist_update();
+}
+
+void tft_vlist_scroll_to(uint32_t n) {
+    if(list.row == NULL)
+        return;
+
+    list.top = n;
+    list.offset = 0;
+    clamp();
+    layout();
+}
+
+uint32_t tft_vlist_top(void) {
+    return list.top;
+}
+
+lv_obj_t *tft_vlist_obj(void) {
+    return list.row ? list.cont : NULL;
+}
+
+const tft_vlist_stats_t *tft_vlist_get_stats(void) {
+    return &stats;
+}
+
+#endif // TFT_ENABLE
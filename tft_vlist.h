@@ -0,0 +1,82 @@
+/*
+ * tft_vlist.h - Recycling virtualized list
+ *
+ * Part of grblHAL TFT Plugin
+ *
+ * Copyright (c) 2025
+ *
+ * Lists far longer than the LVGL pool could hold labels for (settings,
+ * files, console scrollback) are drawn by one label per visible row plus
+ * TFT_VLIST_OVERSCAN rows above and below. Item n is always drawn by row
+ * n % rows: scrolling moves the rows and rebinds only the ones that wrap
+ * around to a new item, off screen thanks to the overscan. Row text lives
+ * in a buffer owned by the list (static label text), not in the LVGL pool.
+ *
+ * Items are numbered first to end - 1, given by the data source. Numbers
+ * need not start at 0, so a scrollback can drop old items without the
+ * visible ones moving. An item's text is read once when its row is bound.
+ *
+ * Keys sent to the list when it has the keypad focus move a cursor, shown
+ * from the first key on: UP and DOWN by an item, LEFT and RIGHT by a page,
+ * HOME and END to the ends. ENTER clicks the cursor item.
+ *
+ * There is one list at a time, owned by the active screen. UI task only.
+ */
+
+#ifndef _TFT_VLIST_H_
+#define _TFT_VLIST_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <lvgl.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct {
+    // Items available, first to end - 1
+    void (*range)(uint32_t *first, uint32_t *end);
+    // Text of item n, false if it is gone. style may be set, it defaults to the list style.
+    bool (*item)(uint32_t n, char *buf, size_t size, const lv_style_t **style);
+    // Optional, item tapped without scrolling
+    void (*clicked)(uint32_t n);
+} tft_vlist_source_t;
+
+// Create the list on parent, text_max is the longest row text kept.
+// follow keeps the last item in view until scrolled away from it.
+bool tft_vlist_create(lv_obj_t *parent, lv_coord_t width, lv_coord_t height, lv_coord_t row_height,
+                      uint8_t text_max, const lv_style_t *style, const tft_vlist_source_t *source, bool follow);
+
+// Free the list, call from the screen destroy callback (the objects go with the screen)
+void tft_vlist_delete(void);
+
+// Pick up items added or dropped since the last call
+void tft_vlist_update(void);
+
+// Read the text of every bound row again, after the items changed in place
+void tft_vlist_refresh(void);
+
+// Scroll so that item n is at the top, or as close as the range allows
+void tft_vlist_scroll_to(uint32_t n);
+
+// First visible item
+uint32_t tft_vlist_top(void);
+
+// Container taking the touch and keypad events, NULL without a list
+lv_obj_t *tft_vlist_obj(void);
+
+typedef struct {
+    uint16_t rows;              // Label objects
+    uint32_t binds;             // Row text reads
+    uint32_t scrolls;           // Scroll steps
+} tft_vlist_stats_t;
+
+const tft_vlist_stats_t *tft_vlist_get_stats(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // _TFT_VLIST_H_
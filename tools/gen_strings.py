@@ -0,0 +1,151 @@
+#!/usr/bin/env python3
+"""
+gen_strings.py - Compile UI string tables for the grblHAL TFT plugin
+
+Part of grblHAL TFT Plugin
+
+Reads the per-language sources lang/<code>.txt and generates:
+
+  tft_strings_gen.h   - tft_str_id_t enum (one ID per key in the base language)
+                        and tft_lang_id_t enum (one ID per language, in the
+                        order given on the command line)
+  tft_strings_gen.c   - one packed, NUL separated blob plus a uint16_t offset
+                        table per language, all const so they stay in flash
+  lang/<code>.glyphs  - the exact set of characters used by each language,
+                        for use as lv_font_conv --symbols input
+
+Keys missing from a translation fall back to the base language text.
+
+Usage:
+  gen_strings.py --base lang/en.txt --out . lang/zh.txt lang/en.txt lang/de.txt
+"""
+
+import argparse
+import os
+import re
+import sys
+
+KEY_RE = re.compile(r'^([A-Z][A-Z0-9_]*)\s*=\s*(.*?)\s*$')
+
+
+def parse(path):
+    name = None
+    strings = {}
+    order = []
+    with open(path, encoding='utf-8') as f:
+        for lineno, line in enumerate(f, 1):
+            line = line.rstrip('\n')
+            if not line.strip() or line.lstrip().startswith('#'):
+                continue
+            if line.startswith('@name'):
+                name = line[5:].strip()
+                continue
+            m = KEY_RE.match(line)
+            if not m:
+                sys.exit('%s:%d: expected KEY = text' % (path, lineno))
+            key, text = m.group(1), m.group(2).replace('\\n', '\n')
+            if key in strings:
+                sys.exit('%s:%d: duplicate key %s' % (path, lineno, key))
+            strings[key] = text
+            order.append(key)
+    code = os.path.splitext(os.path.basename(path))[0]
+    return code, name or code, strings, order
+
+
+def c_bytes(data):
+    # Escape raw UTF-8 bytes for use inside a C string literal
+    out = []
+    for b in data:
+        if b == 0x5C or b == 0x22:
+            out.append('\\' + chr(b))
+        elif 0x20 <= b < 0x7F:
+            out.append(chr(b))
+        else:
+            out.append('\\%03o' % b)
+    return ''.join(out)
+
+
+def write_if_changed(path, text):
+    try:
+        with open(path, encoding='utf-8') as f:
+            if f.read() == text:
+                return
+    except FileNotFoundError:
+        pass
+    with open(path, 'w', encoding='utf-8', newline='\n') as f:
+        f.write(text)
+
+
+def main():
+    ap = argparse.ArgumentParser()
+    ap.add_argument('--base', required=True, help='language file defining the string IDs')
+    ap.add_argument('--out', default='.', help='output directory for tft_strings_gen.[ch]')
+    ap.add_argument('--glyphs', default=None, help='output directory for <code>.glyphs files')
+    ap.add_argument('langs', nargs='+', help='language files, in tft_lang_id_t order')
+    args = ap.parse_args()
+
+    base_code, _, base, keys = parse(args.base)
+    langs = [parse(p) for p in args.langs]
+    glyph_dir = args.glyphs or os.path.dirname(args.base)
+
+    hdr = []
+    hdr.append('/*\n * tft_strings_gen.h - Generated UI string IDs\n *\n'
+               ' * Part of grblHAL TFT Plugin\n *\n'
+               ' * Generated by tools/gen_strings.py from lang/<code>.txt - do not edit.\n */\n\n'
+               '#ifndef _TFT_STRINGS_GEN_H_\n#define _TFT_STRINGS_GEN_H_\n\n')
+    hdr.append('typedef enum {\n')
+    for code, name, _, _ in langs:
+        hdr.append('    TFT_LANG_%s,\n' % code.upper())
+    hdr.append('    TFT_LANG_COUNT\n} tft_lang_id_t;\n\n')
+    hdr.append('typedef enum {\n')
+    for key in keys:
+        hdr.append('    STR_%s,\n' % key)
+    hdr.append('    STR_COUNT\n} tft_str_id_t;\n\n#endif // _TFT_STRINGS_GEN_H_\n')
+
+    src = []
+    src.append('/*\n * tft_strings_gen.c - Generated UI string tables\n *\n'
+               ' * Part of grblHAL TFT Plugin\n *\n'
+               ' * Generated by tools/gen_strings.py from lang/<code>.txt - do not edit.\n */\n\n'
+               '#include "tft_strings.h"\n\n#if TFT_ENABLE\n')
+
+    for code, name, strings, _ in langs:
+        extra = set(strings) - set(base)
+        if extra:
+            sys.exit('%s: keys not in %s: %s' % (code, base_code, ', '.join(sorted(extra))))
+        blob = bytearray()
+        offsets = []
+        for key in keys:
+            text = strings.get(key)
+            if text is None:
+                print('warning: %s: %s missing, using %s text' % (code, key, base_code), file=sys.stderr)
+                text = base[key]
+            offsets.append(len(blob))
+            blob += text.encode('utf-8') + b'\0'
+        if len(blob) > 0xFFFF:
+            sys.exit('%s: string blob exceeds 64 KB' % code)
+
+        src.append('\nstatic const char str_blob_%s[%d] =\n' % (code, len(blob)))
+        pos = 0
+        for key in keys:
+            end = blob.index(0, pos)
+            src.append('    "%s\\0"  // %s\n' % (c_bytes(blob[pos:end]), key))
+            pos = end + 1
+        src.append(';\n\nstatic const uint16_t str_offs_%s[STR_COUNT] = {\n' % code)
+        for i in range(0, len(offsets), 8):
+            src.append('    ' + ', '.join('%5d' % o for o in offsets[i:i + 8]) + ',\n')
+        src.append('};\n')
+
+        chars = sorted(set(''.join(strings.get(k, base[k]) for k in keys)) - {'\n'})
+        write_if_changed(os.path.join(glyph_dir, code + '.glyphs'), ''.join(chars) + '\n')
+
+    src.append('\nconst tft_lang_table_t tft_lang_tables[TFT_LANG_COUNT] = {\n')
+    for code, name, _, _ in langs:
+        src.append('    { "%s", "%s", str_offs_%s, str_blob_%s },\n' % (code, c_bytes(name.encode('utf-8')), code, code))
+    src.append('};\n\n#endif // TFT_ENABLE\n')
+
+    write_if_changed(os.path.join(args.out, 'tft_strings_gen.h'), ''.join(hdr))
+    write_if_changed(os.path.join(args.out, 'tft_strings_gen.c'), ''.join(src))
+
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,155 @@
+#!/usr/bin/env python3
+"""
+tft_input.py - Drive the grblHAL TFT plugin panel remotely
+
+Part of grblHAL TFT Plugin
+
+Sends pointer and key events with $TFT=IN (build with
+TFT_REMOTE_INPUT_ENABLE 1). Physical touches on the panel take priority,
+remote events sent while the panel is in use are dropped.
+
+Usage:
+  tft_input.py tap /dev/ttyUSB0 X Y
+  tft_input.py drag /dev/ttyUSB0 X1 Y1 X2 Y2 [--steps N]
+  tft_input.py key /dev/ttyUSB0 ENTER|ESC|UP|DOWN|LEFT|RIGHT|NEXT|PREV|...|<char>
+  tft_input.py latency /dev/ttyUSB0 X Y [-n 20]
+
+latency taps X Y repeatedly with timestamped events and reports host round
+trip, time queued on the controller and time from applied to first flush.
+
+Needs pyserial. A telnet connection can be used instead of a serial port by
+passing socket://host:23 as the port.
+"""
+
+import argparse
+import statistics
+import sys
+import time
+
+
+def open_port(port):
+    try:
+        import serial
+    except ImportError:
+        sys.exit('pyserial is required: pip install pyserial')
+    return serial.serial_for_url(port, baudrate=115200, timeout=5)
+
+
+def command(ser, line):
+    """Send a $ command and wait for ok/error."""
+    ser.write((line + '\n').encode())
+    while True:
+        resp = ser.readline().decode(errors='replace').strip()
+        if not resp:
+            sys.exit('timeout waiting for response to %s' % line)
+        if resp == 'ok':
+            return
+        if resp.startswith('error'):
+            sys.exit('%s: %s (panel in use or queue full?)' % (line, resp))
+
+
+def timed_press(ser, x, y, t):
+    """Send a timestamped press, return the fields of its acknowledgement."""
+    ser.write(('$TFT=IN,P,%d,%d,%d\n' % (x, y, t)).encode())
+    ok = ack = None
+    while ok is None or ack is None:
+        resp = ser.readline().decode(errors='replace').strip()
+        if not resp:
+            return None
+        if resp == 'ok':
+            ok = True
+        elif resp.startswith('error'):
+            return None
+        elif resp.startswith('[TFTIN:ACK,'):
+            fields = dict(f.split('=') for f in resp[11:-1].split(','))
+            if int(fields['t']) == t:
+                ack = fields
+    return ack
+
+
+def cmd_tap(args):
+    ser = open_port(args.port)
+    command(ser, '$TFT=IN,P,%d,%d' % (args.x, args.y))
+    command(ser, '$TFT=IN,R')
+
+
+def cmd_drag(args):
+    ser = open_port(args.port)
+    for i in range(args.steps + 1):
+        x = args.x1 + (args.x2 - args.x1) * i // args.steps
+        y = args.y1 + (args.y2 - args.y1) * i // args.steps
+        command(ser, '$TFT=IN,P,%d,%d' % (x, y))
+        time.sleep(0.03)
+    command(ser, '$TFT=IN,R')
+
+
+def cmd_key(args):
+    ser = open_port(args.port)
+    command(ser, '$TFT=IN,K,' + args.key)
+
+
+def cmd_latency(args):
+    ser = open_port(args.port)
+    rtt, queued, flushed, no_redraw = [], [], [], 0
+    for i in range(args.count):
+        t = int(time.monotonic() * 1000) & 0xFFFFFFFF
+        start = time.monotonic()
+        ack = timed_press(ser, args.x, args.y, t)
+        if ack is None:
+            sys.exit('no acknowledgement, is the panel being touched?')
+        rtt.append((time.monotonic() - start) * 1000)
+        queued.append(int(ack['queue_us']) / 1000)
+        if int(ack['flush_us']) < 0:
+            no_redraw += 1
+        else:
+            flushed.append(int(ack['flush_us']) / 1000)
+        command(ser, '$TFT=IN,R')
+        time.sleep(0.2)
+
+    def summary(name, values):
+        if values:
+            print('%-12s min %6.1f  median %6.1f  max %6.1f ms' %
+                  (name, min(values), statistics.median(values), max(values)))
+
+    summary('round trip', rtt)
+    summary('queued', queued)
+    summary('to flush', flushed)
+    if no_redraw:
+        print('%d of %d taps caused no redraw' % (no_redraw, args.count))
+
+
+def main():
+    ap = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    sub = ap.add_subparsers(dest='cmd', required=True)
+
+    p = sub.add_parser('tap')
+    p.add_argument('port')
+    p.add_argument('x', type=int)
+    p.add_argument('y', type=int)
+    p.set_defaults(func=cmd_tap)
+
+    p = sub.add_parser('drag')
+    p.add_argument('port')
+    for name in ('x1', 'y1', 'x2', 'y2'):
+        p.add_argument(name, type=int)
+    p.add_argument('--steps', type=int, default=10)
+    p.set_defaults(func=cmd_drag)
+
+    p = sub.add_parser('key')
+    p.add_argument('port')
+    p.add_argument('key')
+    p.set_defaults(func=cmd_key)
+
+    p = sub.add_parser('latency')
+    p.add_argument('port')
+    p.add_argument('x', type=int)
+    p.add_argument('y', type=int)
+    p.add_argument('-n', '--count', type=int, default=20)
+    p.set_defaults(func=cmd_latency)
+
+    args = ap.parse_args()
+    args.func(args)
+
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,201 @@
+#!/usr/bin/env python3
+"""
+tft_mirror.py - Remote viewer for the grblHAL TFT plugin framebuffer mirror
+
+Part of grblHAL TFT Plugin
+
+Enables the mirror with $TFT=MIRROR,ON (build with TFT_MIRROR_ENABLE 1)
+and rebuilds the screen from the [TFTMIRROR:...] lines, see tft_mirror.h
+for the protocol. The mirror is switched off again on exit.
+
+Usage:
+  tft_mirror.py /dev/ttyUSB0                     live view in a window (tkinter)
+  tft_mirror.py socket://cnc.local:23 --rate 50000
+  tft_mirror.py /dev/ttyUSB0 --png screen.png    no window, rewrite PNG on change
+
+Needs pyserial. A telnet connection can be used instead of a serial port by
+passing socket://host:23 as the port.
+"""
+
+import argparse
+import base64
+import struct
+import sys
+import threading
+import time
+import zlib
+
+
+def rle16_decode(data, count):
+    """Decode tft_rle16_encode() output to a list of RGB565 values."""
+    out = []
+    pos = 0
+    while pos < len(data):
+        n = data[pos]
+        pos += 1
+        if n < 0x80:
+            out.extend(struct.unpack_from('<%dH' % (n + 1), data, pos))
+            pos += 2 * (n + 1)
+        else:
+            out.extend(struct.unpack_from('<H', data, pos) * (n - 0x7E))
+            pos += 2
+    if len(out) != count:
+        raise ValueError('RLE data holds %d pixels, expected %d' % (len(out), count))
+    return out
+
+
+def rgb565(v):
+    r, g, b = v >> 11, (v >> 5) & 0x3F, v & 0x1F
+    return (r << 3 | r >> 2, g << 2 | g >> 4, b << 3 | b >> 2)
+
+
+def write_png(path, width, height, rgb):
+    """Write a bytes-like of width * height * 3 RGB values as PNG."""
+    def chunk(kind, body):
+        return struct.pack('>I', len(body)) + kind + body + struct.pack('>I', zlib.crc32(kind + body))
+
+    stride = width * 3
+    raw = b''.join(b'\0' + bytes(rgb[y * stride:(y + 1) * stride]) for y in range(height))
+    with open(path, 'wb') as f:
+        f.write(b'\x89PNG\r\n\x1a\n')
+        f.write(chunk(b'IHDR', struct.pack('>IIBBBBB', width, height, 8, 2, 0, 0, 0)))
+        f.write(chunk(b'IDAT', zlib.compress(raw, 6)))
+        f.write(chunk(b'IEND', b''))
+
+
+class Framebuffer:
+    def __init__(self):
+        self.width = self.height = 0
+        self.rgb = bytearray()
+        self.area = None
+        self.data = bytearray()
+        self.expected = 0
+        self.on_area = None
+
+    def line(self, line):
+        """Feed one [<tag>:...] line, returns False on STOP or END."""
+        fields = line[line.index(':') + 1:-1].split(',')
+        if fields[0] == 'START':
+            self.width, self.height = int(fields[1]), int(fields[2])
+            self.rgb = bytearray(self.width * self.height * 3)
+            self.area = None
+        elif fields[0] == 'R':
+            x1, y1, x2, y2, self.expected = map(int, fields[1:])
+            self.area = (x1, y1, x2, y2)
+            self.data = bytearray()
+        elif fields[0] == 'D' and self.area:
+            self.data += base64.b64decode(fields[1])
+            if len(self.data) >= self.expected:
+                self.blit()
+        elif fields[0] in ('STOP', 'END'):
+            return False
+        return True
+
+    def blit(self):
+        x1, y1, x2, y2 = self.area
+        w = x2 - x1 + 1
+        pixels = rle16_decode(self.data, w * (y2 - y1 + 1))
+        for row, y in enumerate(range(y1, y2 + 1)):
+            if not 0 <= y < self.height:
+                continue
+            pos = (y * self.width + x1) * 3
+            for v in pixels[row * w:(row + 1) * w]:
+                self.rgb[pos:pos + 3] = bytes(rgb565(v))
+                pos += 3
+        if self.on_area:
+            self.on_area(self.area, pixels)
+        self.area = None
+
+
+def open_port(port):
+    try:
+        import serial
+    except ImportError:
+        sys.exit('pyserial is required: pip install pyserial')
+    return serial.serial_for_url(port, baudrate=115200, timeout=1)
+
+
+def reader(ser, fb, stop):
+    while not stop.is_set():
+        line = ser.readline().decode(errors='replace').strip()
+        if line.startswith('[TFTMIRROR:') and line.endswith(']'):
+            try:
+                if not fb.line(line):
+                    stop.set()
+            except (ValueError, struct.error) as e:
+                print('bad area: %s' % e, file=sys.stderr)
+                fb.area = None
+
+
+def run_png(fb, path, stop):
+    changed = threading.Event()
+    fb.on_area = lambda area, pixels: changed.set()
+    while not stop.is_set():
+        if changed.wait(1):
+            changed.clear()
+            write_png(path, fb.width, fb.height, fb.rgb)
+
+
+def run_window(fb, stop):
+    import queue
+    import tkinter as tk
+
+    areas = queue.Queue()
+    fb.on_area = lambda area, pixels: areas.put((area, pixels))
+
+    root = tk.Tk()
+    root.title('TFT mirror')
+    photo = tk.PhotoImage(width=480, height=320)
+    tk.Label(root, image=photo).pack()
+
+    def update():
+        while not areas.empty():
+            (x1, y1, x2, y2), pixels = areas.get()
+            if photo.width() != fb.width or photo.height() != fb.height:
+                photo.configure(width=fb.width, height=fb.height)
+            w = x2 - x1 + 1
+            rows = []
+            for i in range(0, len(pixels), w):
+                rows.append('{' + ' '.join('#%02x%02x%02x' % rgb565(v) for v in pixels[i:i + w]) + '}')
+            photo.put(' '.join(rows), to=(x1, y1))
+        if stop.is_set():
+            root.destroy()
+        else:
+            root.after(20, update)
+
+    root.protocol('WM_DELETE_WINDOW', stop.set)
+    root.after(20, update)
+    root.mainloop()
+
+
+def main():
+    ap = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    ap.add_argument('port')
+    ap.add_argument('--rate', type=int, help='mirror output limit in bytes per second')
+    ap.add_argument('--png', help='write screen to this PNG file instead of opening a window')
+    args = ap.parse_args()
+
+    ser = open_port(args.port)
+    fb = Framebuffer()
+    stop = threading.Event()
+
+    ser.write(('$TFT=MIRROR,ON' + (',%d' % args.rate if args.rate else '') + '\n').encode())
+    thread = threading.Thread(target=reader, args=(ser, fb, stop), daemon=True)
+    thread.start()
+
+    try:
+        if args.png:
+            run_png(fb, args.png, stop)
+        else:
+            run_window(fb, stop)
+    except KeyboardInterrupt:
+        pass
+    finally:
+        stop.set()
+        thread.join(2)
+        ser.write(b'$TFT=MIRROR,OFF\n')
+        time.sleep(0.1)
+
+
+if __name__ == '__main__':
+    main()
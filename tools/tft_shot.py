@@ -0,0 +1,81 @@
+#!/usr/bin/env python3
+"""
+tft_shot.py - Save a screenshot of the grblHAL TFT plugin panel as PNG
+
+Part of grblHAL TFT Plugin
+
+Sends $TFT=SHOT, decodes the [TFTSHOT:...] lines (see tft_screenshot.h)
+and checks the result against the CRC reported by the controller.
+
+Usage:
+  tft_shot.py /dev/ttyUSB0 screen.png
+  tft_shot.py --log console.txt screen.png     decode lines captured by a terminal
+
+Needs pyserial unless --log is used. A telnet connection can be used instead
+of a serial port by passing socket://host:23 as the port.
+"""
+
+import argparse
+import struct
+import sys
+import zlib
+
+from tft_mirror import Framebuffer, open_port, write_png
+
+
+def lines_from_port(port):
+    ser = open_port(port)
+    ser.timeout = 10
+    ser.write(b'$TFT=SHOT\n')
+    while True:
+        line = ser.readline().decode(errors='replace').strip()
+        if not line:
+            sys.exit('timeout waiting for screenshot')
+        if line.startswith('error'):
+            sys.exit('$TFT=SHOT: ' + line)
+        yield line
+
+
+def lines_from_log(path):
+    with open(path, encoding='utf-8', errors='replace') as f:
+        for line in f:
+            yield line.strip()
+
+
+def main():
+    ap = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    ap.add_argument('port', nargs='?')
+    ap.add_argument('output')
+    ap.add_argument('--log', help='read lines from a captured log instead of a port')
+    args = ap.parse_args()
+
+    if not args.log and not args.port:
+        ap.error('port or --log is required')
+
+    fb = Framebuffer()
+    crc = 0
+
+    def on_area(area, pixels):
+        nonlocal crc
+        crc = zlib.crc32(struct.pack('<4h', *area), crc)
+        crc = zlib.crc32(struct.pack('<%dH' % len(pixels), *pixels), crc)
+
+    fb.on_area = on_area
+
+    started = False
+    for line in lines_from_log(args.log) if args.log else lines_from_port(args.port):
+        if not (line.startswith('[TFTSHOT:') and line.endswith(']')):
+            continue
+        started = started or line.startswith('[TFTSHOT:START')
+        if started and not fb.line(line):
+            if int(line[13:-1], 16) != crc:
+                sys.exit('CRC mismatch, screenshot is incomplete or corrupted')
+            write_png(args.output, fb.width, fb.height, fb.rgb)
+            print('%dx%d screenshot written to %s' % (fb.width, fb.height, args.output))
+            return
+
+    sys.exit('no complete screenshot found')
+
+
+if __name__ == '__main__':
+    main()
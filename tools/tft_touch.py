@@ -0,0 +1,160 @@
+#!/usr/bin/env python3
+"""
+tft_touch.py - Run touch scripts and screen benchmarks on the grblHAL TFT plugin
+
+Part of grblHAL TFT Plugin
+
+Needs a build with TFT_AUTOMATION_ENABLE 1. Script files hold one step per
+line, blank lines and lines starting with # are ignored:
+
+  tap X Y
+  long X Y [MS]
+  drag X1 Y1 X2 Y2 [MS]
+  wait MS
+  expect screen NAME
+  expect crc HEX
+
+Usage:
+  tft_touch.py run /dev/ttyUSB0 script.txt       run script, exit 1 on failure
+  tft_touch.py crc /dev/ttyUSB0                  print CRC of the active screen
+  tft_touch.py bench /dev/ttyUSB0 [-o out.json]  benchmark every screen
+
+Needs pyserial. A telnet connection can be used instead of a serial port by
+passing socket://host:23 as the port.
+"""
+
+import argparse
+import json
+import sys
+
+# Step keyword: (minimum, maximum) number of arguments
+STEPS = {
+    'tap': (2, 2),
+    'long': (2, 3),
+    'drag': (4, 5),
+    'wait': (1, 1),
+    'expect': (2, 2),
+}
+
+
+def parse_script(path):
+    commands = []
+    with open(path, encoding='utf-8') as f:
+        for lineno, line in enumerate(f, 1):
+            words = line.split('#', 1)[0].split()
+            if not words:
+                continue
+            step, args = words[0].lower(), words[1:]
+            if step not in STEPS or not STEPS[step][0] <= len(args) <= STEPS[step][1]:
+                sys.exit('%s:%d: bad step: %s' % (path, lineno, line.strip()))
+            if step == 'expect':
+                if args[0].lower() not in ('screen', 'crc'):
+                    sys.exit('%s:%d: expect screen NAME or expect crc HEX' % (path, lineno))
+            elif not all(a.isdigit() for a in args):
+                sys.exit('%s:%d: arguments must be unsigned integers' % (path, lineno))
+            commands.append('$TFT=TOUCH,' + ','.join([step.upper()] + args))
+    return commands
+
+
+def open_port(port):
+    try:
+        import serial
+    except ImportError:
+        sys.exit('pyserial is required: pip install pyserial')
+    return serial.serial_for_url(port, baudrate=115200, timeout=5)
+
+
+def command(ser, line):
+    """Send a $ command and wait for ok/error."""
+    ser.write((line + '\n').encode())
+    while True:
+        resp = ser.readline().decode(errors='replace').strip()
+        if not resp:
+            sys.exit('timeout waiting for response to %s' % line)
+        if resp == 'ok':
+            return
+        if resp.startswith('error'):
+            sys.exit('%s: %s' % (line, resp))
+
+
+def wait_for(ser, prefix):
+    """Return the body of the next line starting with prefix."""
+    while True:
+        resp = ser.readline().decode(errors='replace').strip()
+        if not resp:
+            sys.exit('timeout waiting for %s' % prefix)
+        if resp.startswith(prefix):
+            return resp[len(prefix):-1]
+
+
+def fields(body):
+    return dict(f.split('=', 1) for f in body.split(',') if '=' in f)
+
+
+def cmd_run(args):
+    commands = parse_script(args.file)
+    ser = open_port(args.port)
+    command(ser, '$TFT=TOUCH,CLEAR')
+    for line in commands:
+        command(ser, line)
+    command(ser, '$TFT=TOUCH,RUN')
+
+    ser.timeout = None
+    result = wait_for(ser, '[TFTTOUCH:')
+    while not result.startswith(('PASS', 'FAIL')):
+        result = wait_for(ser, '[TFTTOUCH:')
+    print(result)
+    sys.exit(0 if result.startswith('PASS') else 1)
+
+
+def cmd_crc(args):
+    ser = open_port(args.port)
+    command(ser, '$TFT=TOUCH,CRC')
+    print(wait_for(ser, '[TFTTOUCH:CRC,'))
+
+
+def cmd_bench(args):
+    ser = open_port(args.port)
+    command(ser, '$TFT=BENCH')
+    ser.timeout = 30
+    results = []
+    while True:
+        body = wait_for(ser, '[TFTBENCH:')
+        if body == 'END':
+            break
+        row = fields(body)
+        for key, value in row.items():
+            if key not in ('screen', 'crc'):
+                row[key] = int(value)
+        results.append(row)
+        print('%-12s render %6d us  flush %6d us  mem %6d B  frag %2d%%' %
+              (row['screen'], row['render_us'], row['flush_us'], row['mem_used'], row['frag_pct']))
+    if args.output:
+        with open(args.output, 'w') as f:
+            json.dump(results, f, indent=2)
+
+
+def main():
+    ap = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    sub = ap.add_subparsers(dest='cmd', required=True)
+
+    p = sub.add_parser('run')
+    p.add_argument('port')
+    p.add_argument('file')
+    p.set_defaults(func=cmd_run)
+
+    p = sub.add_parser('crc')
+    p.add_argument('port')
+    p.set_defaults(func=cmd_crc)
+
+    p = sub.add_parser('bench')
+    p.add_argument('port')
+    p.add_argument('-o', '--output', help='write results as JSON')
+    p.set_defaults(func=cmd_bench)
+
+    args = ap.parse_args()
+    args.func(args)
+
+
+if __name__ == '__main__':
+    main()
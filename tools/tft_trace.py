@@ -0,0 +1,191 @@
+#!/usr/bin/env python3
+"""
+tft_trace.py - Fetch, inspect and replay grblHAL TFT plugin event traces
+
+Part of grblHAL TFT Plugin
+
+Traces are recorded on the controller with $TFT=TRACE,REC / $TFT=TRACE,STOP
+(build with TFT_TRACE_ENABLE 1). The binary format is documented in
+tft_trace.h.
+
+Usage:
+  tft_trace.py pull /dev/ttyUSB0 job.tftr        fetch recorded trace
+  tft_trace.py info job.tftr [-v]                 summary (-v lists records)
+  tft_trace.py push /dev/ttyUSB0 job.tftr [--fast]
+                                                  upload, replay, print result
+
+pull and push need pyserial. A telnet connection can be used instead of a
+serial port by passing socket://host:23 as the port.
+"""
+
+import argparse
+import sys
+
+MAGIC = b'TFTR'
+VERSION = 1
+HDR_SIZE = 8
+LOAD_BYTES = 64         # Trace bytes per $TFT=TRACE,LOAD line, keeps lines short
+
+EVT_STATE, EVT_REPORT, EVT_PROGRAM, EVT_RESET = range(4)
+EVT_NAMES = ('state', 'report', 'program', 'reset')
+
+
+class Reader:
+    def __init__(self, data):
+        self.data = data
+        self.pos = HDR_SIZE
+
+    def varint(self):
+        result = shift = 0
+        while True:
+            b = self.data[self.pos]
+            self.pos += 1
+            result |= (b & 0x7F) << shift
+            shift += 7
+            if not b & 0x80:
+                return result
+
+    def zigzag(self):
+        v = self.varint()
+        return (v >> 1) ^ -(v & 1)
+
+    def byte(self):
+        b = self.data[self.pos]
+        self.pos += 1
+        return b
+
+
+def decode(data):
+    if len(data) < HDR_SIZE or data[:4] != MAGIC:
+        sys.exit('not a TFT trace')
+    version, n_axis = data[4], data[5]
+    if version != VERSION:
+        sys.exit('unsupported trace version %d' % version)
+
+    r = Reader(data)
+    t = 0
+    mpos = [0] * n_axis
+    wco = [0] * n_axis
+    feed = 0
+    while r.pos < len(data):
+        t += r.varint()
+        kind = r.byte()
+        if kind == EVT_STATE:
+            yield t, 'state', {'state': r.varint(), 'alarm': r.varint()}
+        elif kind == EVT_REPORT:
+            for i in range(n_axis):
+                mpos[i] += r.zigzag()
+            for i in range(n_axis):
+                wco[i] += r.zigzag()
+            feed += r.zigzag()
+            yield t, 'report', {'mpos': [v / 1000 for v in mpos],
+                                'wpos': [(m - w) / 1000 for m, w in zip(mpos, wco)],
+                                'feed': feed / 10}
+        elif kind == EVT_PROGRAM:
+            yield t, 'program', {'flow': r.byte(), 'check_mode': bool(r.byte())}
+        elif kind == EVT_RESET:
+            yield t, 'reset', {}
+        else:
+            sys.exit('corrupt trace at byte %d' % (r.pos - 1))
+
+
+def cmd_info(args):
+    data = open(args.file, 'rb').read()
+    counts = dict.fromkeys(EVT_NAMES, 0)
+    t_end = 0
+    for t, kind, payload in decode(data):
+        counts[kind] += 1
+        t_end = t
+        if args.verbose:
+            print('%9.3f %-8s %s' % (t / 1000, kind, payload))
+    total = sum(counts.values())
+    print('%d bytes, %d events over %.1f s (%.1f bytes/event)' %
+          (len(data), total, t_end / 1000, (len(data) - HDR_SIZE) / max(total, 1)))
+    for kind in EVT_NAMES:
+        print('  %-8s %d' % (kind, counts[kind]))
+
+
+def open_port(port):
+    try:
+        import serial
+    except ImportError:
+        sys.exit('pyserial is required: pip install pyserial')
+    return serial.serial_for_url(port, baudrate=115200, timeout=5)
+
+
+def command(ser, line, prefix):
+    """Send a $ command, collect lines starting with prefix until ok/error."""
+    ser.write((line + '\n').encode())
+    out = []
+    while True:
+        resp = ser.readline().decode(errors='replace').strip()
+        if not resp:
+            sys.exit('timeout waiting for response to %s' % line)
+        if resp.startswith(prefix):
+            out.append(resp[len(prefix):-1])
+        elif resp == 'ok':
+            return out
+        elif resp.startswith('error'):
+            sys.exit('%s: %s' % (line, resp))
+
+
+def cmd_pull(args):
+    ser = open_port(args.port)
+    lines = command(ser, '$TFT=TRACE,DUMP', '[TFTTRACE:')
+    data = bytearray()
+    for line in lines:
+        if line.startswith('END,'):
+            if int(line[4:]) != len(data):
+                sys.exit('length mismatch, expected %s got %d' % (line[4:], len(data)))
+            break
+        data += bytes.fromhex(line)
+    open(args.file, 'wb').write(data)
+    print('%d bytes written to %s' % (len(data), args.file))
+
+
+def cmd_push(args):
+    data = open(args.file, 'rb').read()
+    list(decode(data))  # validate before touching the controller
+    ser = open_port(args.port)
+    command(ser, '$TFT=TRACE,CLEAR', '[TFTTRACE:')
+    for i in range(0, len(data), LOAD_BYTES):
+        command(ser, '$TFT=TRACE,LOAD,' + data[i:i + LOAD_BYTES].hex().upper(), '[TFTTRACE:')
+    command(ser, '$TFT=TRACE,PLAY' + (',FAST' if args.fast else ''), '[TFTTRACE:')
+    print('replaying %d bytes...' % len(data))
+
+    ser.timeout = None
+    while True:
+        resp = ser.readline().decode(errors='replace').strip()
+        if resp.startswith('[TFTREPLAY:'):
+            for field in resp[11:-1].split(','):
+                key, value = field.split('=')
+                print('  %-14s %s' % (key, value))
+            break
+
+
+def main():
+    ap = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    sub = ap.add_subparsers(dest='cmd', required=True)
+
+    p = sub.add_parser('info')
+    p.add_argument('file')
+    p.add_argument('-v', '--verbose', action='store_true')
+    p.set_defaults(func=cmd_info)
+
+    p = sub.add_parser('pull')
+    p.add_argument('port')
+    p.add_argument('file')
+    p.set_defaults(func=cmd_pull)
+
+    p = sub.add_parser('push')
+    p.add_argument('port')
+    p.add_argument('file')
+    p.add_argument('--fast', action='store_true', help='replay as fast as the UI task drains the queue')
+    p.set_defaults(func=cmd_push)
+
+    args = ap.parse_args()
+    args.func(args)
+
+
+if __name__ == '__main__':
+    main()